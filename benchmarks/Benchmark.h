@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fmt/format.h"
+
+namespace OpenWifi::Benchmark {
+
+	//	Keeps the compiler from optimizing away a result that is otherwise unused.
+	template <typename T> inline void KeepAlive(T const &Value) {
+		asm volatile("" : : "r,m"(Value) : "memory");
+	}
+
+	//	Runs Body once to warm up, then Iterations times, and prints the mean time per call.
+	template <typename Func>
+	double Measure(const std::string &Name, std::uint64_t Iterations, Func &&Body) {
+		Body();
+		auto Start = std::chrono::steady_clock::now();
+		for (std::uint64_t i = 0; i < Iterations; ++i)
+			Body();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		auto PerCall = Elapsed.count() / (double)Iterations;
+		std::cout << fmt::format("{:<56} {:>12.1f} ns/op ({} iterations)", Name, PerCall,
+								 Iterations)
+				  << std::endl;
+		return PerCall;
+	}
+
+	//	Runs Body(Thread, i) Iterations times on each of Threads threads at once, and prints the
+	//	wall time per call over all the threads.
+	template <typename Func>
+	double MeasureThreads(const std::string &Name, unsigned Threads, std::uint64_t Iterations,
+						  Func &&Body) {
+		std::vector<std::thread> Workers;
+		auto Start = std::chrono::steady_clock::now();
+		for (unsigned t = 0; t < Threads; ++t) {
+			Workers.emplace_back([&Body, t, Iterations] {
+				for (std::uint64_t i = 0; i < Iterations; ++i)
+					Body(t, i);
+			});
+		}
+		for (auto &W : Workers)
+			W.join();
+		std::chrono::duration<double, std::nano> Elapsed = std::chrono::steady_clock::now() - Start;
+		auto PerCall = Elapsed.count() / (double)(Iterations * Threads);
+		std::cout << fmt::format("{:<56} {:>12.1f} ns/op ({} threads x {} iterations)", Name,
+								 PerCall, Threads, Iterations)
+				  << std::endl;
+		return PerCall;
+	}
+
+	//	Prints how many times faster Candidate is than Baseline.
+	inline void Compare(const std::string &Name, double Baseline, double Candidate) {
+		std::cout << fmt::format("{:<56} {:>12.2f}x", Name, Candidate > 0 ? Baseline / Candidate : 0.0)
+				  << std::endl;
+	}
+
+} // namespace OpenWifi::Benchmark
@@ -0,0 +1,131 @@
+//	Token validation under concurrent requests, the two things AuthClient does for them:
+//	- cache hits on one UniqueExpireLRUCache, as before, and on the default 8 shards,
+//	- a burst of requests carrying the same unknown token, with and without coalescing them
+//	  into one call to a security service that takes 5 ms to answer.
+//	AuthClient needs the service configuration and a security service to talk to, so the same
+//	cache and flight map are driven directly.
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+
+#include "Poco/UniqueExpireLRUCache.h"
+
+#include "Benchmark.h"
+
+#include "RESTObjects/RESTAPI_SecurityObjects.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+
+using namespace OpenWifi;
+
+struct Validation {
+	SecurityObjects::UserInfoAndPolicy UserInfo;
+	bool Valid = false;
+	Poco::Timestamp Expiration;
+	[[nodiscard]] inline const Poco::Timestamp &getExpiration() const { return Expiration; }
+};
+
+typedef Poco::UniqueExpireLRUCache<std::string, Validation> ValidationCache;
+
+class ShardedCache {
+  public:
+	ShardedCache(std::size_t Shards, long Size) {
+		for (std::size_t i = 0; i < Shards; ++i)
+			Shards_.push_back(std::make_unique<ValidationCache>(Size / (long)Shards));
+	}
+	ValidationCache &For(const std::string &Token) {
+		return *Shards_[std::hash<std::string>{}(Token) % Shards_.size()];
+	}
+
+  private:
+	std::vector<std::unique_ptr<ValidationCache>> Shards_;
+};
+
+//	Stands in for the security service: every call takes 5 ms.
+static std::atomic_uint64_t ServiceCalls{0};
+static Validation CallSecurityService(const std::string &Token) {
+	ServiceCalls++;
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	Validation V;
+	V.UserInfo.userinfo.email = Token + "@example.com";
+	V.Valid = true;
+	V.Expiration = Poco::Timestamp::fromEpochTime((std::time_t)(Utils::Now() + 1200));
+	return V;
+}
+
+int main() {
+	constexpr std::size_t Sessions = 2048;
+	std::vector<std::string> Tokens;
+	for (std::size_t i = 0; i < Sessions; ++i)
+		Tokens.push_back(MicroServiceCreateUUID() + MicroServiceCreateUUID());
+
+	auto Fill = [&](ShardedCache &C) {
+		for (const auto &Token : Tokens) {
+			Validation V;
+			V.UserInfo.userinfo.email = Token + "@example.com";
+			V.Valid = true;
+			V.Expiration = Poco::Timestamp::fromEpochTime((std::time_t)(Utils::Now() + 1200));
+			C.For(Token).update(Token, V);
+		}
+	};
+	ShardedCache Single(1, 4096), Sharded(8, 4096);
+	Fill(Single);
+	Fill(Sharded);
+
+	auto Threads = std::max(4u, std::thread::hardware_concurrency());
+	constexpr std::uint64_t Lookups = 100000;
+	auto Hit = [&](ShardedCache &C) {
+		return [&C, &Tokens](unsigned t, std::uint64_t i) {
+			const auto &Token = Tokens[(t * 131 + i) % Tokens.size()];
+			auto Entry = C.For(Token).get(Token);
+			Benchmark::KeepAlive(Entry->Valid);
+		};
+	};
+	auto Baseline =
+		Benchmark::MeasureThreads("Cache hits, 1 shard", Threads, Lookups, Hit(Single));
+	auto Candidate =
+		Benchmark::MeasureThreads("Cache hits, 8 shards", Threads, Lookups, Hit(Sharded));
+	Benchmark::Compare("speedup", Baseline, Candidate);
+
+	//	Every thread asks for the same token at once, a few times over.
+	constexpr unsigned Burst = 64;
+	constexpr std::uint64_t Rounds = 10;
+	ServiceCalls = 0;
+	Benchmark::MeasureThreads("Same new token, one call each", Burst, Rounds,
+							  [&](unsigned, std::uint64_t i) {
+								  Benchmark::KeepAlive(CallSecurityService(Tokens[i]).Valid);
+							  });
+	std::cout << fmt::format("  security service calls: {}", ServiceCalls.load()) << std::endl;
+
+	std::mutex FlightsMutex;
+	std::map<std::string, std::shared_future<Validation>> Flights;
+	auto Coalesced = [&](const std::string &Token) {
+		std::promise<Validation> Answer;
+		{
+			std::unique_lock G(FlightsMutex);
+			auto Hint = Flights.find(Token);
+			if (Hint != Flights.end()) {
+				auto Pending = Hint->second;
+				G.unlock();
+				return Pending.get();
+			}
+			Flights[Token] = Answer.get_future().share();
+		}
+		auto V = CallSecurityService(Token);
+		{
+			std::lock_guard G(FlightsMutex);
+			Flights.erase(Token);
+		}
+		Answer.set_value(V);
+		return V;
+	};
+	ServiceCalls = 0;
+	Benchmark::MeasureThreads("Same new token, coalesced", Burst, Rounds,
+							  [&](unsigned, std::uint64_t i) {
+								  Benchmark::KeepAlive(Coalesced(Tokens[i]).Valid);
+							  });
+	std::cout << fmt::format("  security service calls: {}", ServiceCalls.load()) << std::endl;
+	return 0;
+}
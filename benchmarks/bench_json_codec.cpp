@@ -0,0 +1,96 @@
+//	JSON encoding of an inventory list page, through Poco::JSON objects as before and through
+//	JSONWriter, and decoding of the string arrays stored in ORM columns, through
+//	Poco::JSON::Parser and through JSONFlatArrayReader.
+
+#include "Poco/JSON/Parser.h"
+#include "Poco/JSON/Stringifier.h"
+
+#include "Benchmark.h"
+
+#include "RESTObjects/RESTAPI_ProvObjects.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/RESTAPI_utils.h"
+#include "framework/utils.h"
+
+using namespace OpenWifi;
+
+static constexpr std::size_t PageSize = 500;
+
+int main() {
+	std::vector<ProvObjects::InventoryTag> Page;
+	for (std::size_t i = 0; i < PageSize; ++i) {
+		ProvObjects::InventoryTag D;
+		D.info.id = MicroServiceCreateUUID();
+		D.info.name = D.serialNumber = Utils::IntToSerialNumber(0x903cb3000000 + i);
+		D.info.description = "Lobby \"east\" access point";
+		D.info.notes.push_back({Utils::Now(), "bench", "imported for the benchmark"});
+		D.info.tags = {1, 2, 3};
+		D.deviceType = "edgecore_eap101";
+		D.venue = MicroServiceCreateUUID();
+		D.entity = MicroServiceCreateUUID();
+		D.state = R"({"method":"auto","date":1700000000})";
+		D.devClass = "any";
+		Page.push_back(std::move(D));
+	}
+
+	//	The same document both ways, or the timings compare different work.
+	auto PocoEncode = [&] {
+		Poco::JSON::Array Array;
+		for (const auto &D : Page) {
+			Poco::JSON::Object Obj;
+			D.to_json(Obj);
+			Array.add(Obj);
+		}
+		Poco::JSON::Object Answer;
+		Answer.set("inventoryTags", Array);
+		std::ostringstream OS;
+		Poco::JSON::Stringifier::condense(Answer, OS);
+		return OS.str();
+	};
+	auto WriterEncode = [&] {
+		std::string Out;
+		JSONWriter W(Out, 64 + Page.size() * 1024);
+		W.StartObject();
+		RESTAPI_utils::field_to_json(W, "inventoryTags", Page);
+		W.EndObject();
+		return Out;
+	};
+	Poco::JSON::Parser P;
+	auto Reference = P.parse(PocoEncode()).extract<Poco::JSON::Object::Ptr>();
+	auto Written = Poco::JSON::Parser().parse(WriterEncode()).extract<Poco::JSON::Object::Ptr>();
+	if (Reference->getArray("inventoryTags")->size() != Written->getArray("inventoryTags")->size()) {
+		std::cout << "The two encoders disagree." << std::endl;
+		return 1;
+	}
+
+	constexpr std::uint64_t EncodeRounds = 200;
+	auto PocoTime = Benchmark::Measure(fmt::format("Poco::JSON encode, {} devices", PageSize),
+									   EncodeRounds, [&] { Benchmark::KeepAlive(PocoEncode()); });
+	auto WriterTime = Benchmark::Measure(fmt::format("JSONWriter encode, {} devices", PageSize),
+										 EncodeRounds,
+										 [&] { Benchmark::KeepAlive(WriterEncode()); });
+	Benchmark::Compare("encode speedup", PocoTime, WriterTime);
+
+	//	A member list column as the ORM stores it.
+	Types::StringVec Ids;
+	for (int i = 0; i < 50; ++i)
+		Ids.push_back(MicroServiceCreateUUID());
+	const auto Column = RESTAPI_utils::to_string(Ids);
+
+	constexpr std::uint64_t DecodeRounds = 20000;
+	auto ParserTime = Benchmark::Measure("Poco::JSON::Parser, 50 id column", DecodeRounds, [&] {
+		Types::StringVec Result;
+		Poco::JSON::Parser Parser;
+		auto Array = Parser.parse(Column).extract<Poco::JSON::Array::Ptr>();
+		for (const auto &i : *Array)
+			Result.push_back(i.toString());
+		Benchmark::KeepAlive(Result.size());
+	});
+	auto ReaderTime = Benchmark::Measure("JSONFlatArrayReader, 50 id column", DecodeRounds, [&] {
+		Types::StringVec Result;
+		JSONFlatArrayReader::Strings(Column, Result);
+		Benchmark::KeepAlive(Result.size());
+	});
+	Benchmark::Compare("decode speedup", ParserTime, ReaderTime);
+	return 0;
+}
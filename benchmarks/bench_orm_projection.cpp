@@ -0,0 +1,58 @@
+//	Reading the inventory table on SQLite: full records through GetRecords, which decodes every
+//	column, against the four columns the serial number cache bootstrap reads with GetColumns.
+
+#include "Poco/Data/SQLite/Connector.h"
+#include "Poco/Data/SessionPool.h"
+#include "Poco/TemporaryFile.h"
+
+#include "Benchmark.h"
+
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+#include "storage/storage_inventory.h"
+
+using namespace OpenWifi;
+
+static constexpr std::size_t Devices = 20000;
+
+int main() {
+	Poco::Data::SQLite::Connector::registerConnector();
+	Poco::TemporaryFile File;
+	Poco::Data::SessionPool Pool(Poco::Data::SQLite::Connector::KEY, File.path(), 1, 4);
+	InventoryDB DB(DBType::sqlite, Pool, Poco::Logger::get("bench"));
+	DB.Create();
+
+	std::vector<ProvObjects::InventoryTag> Records;
+	for (std::size_t i = 0; i < Devices; ++i) {
+		ProvObjects::InventoryTag D;
+		D.info.id = MicroServiceCreateUUID();
+		D.info.name = D.serialNumber = Utils::IntToSerialNumber(0x903cb3000000 + i);
+		D.info.notes.push_back({Utils::Now(), "bench", "imported for the benchmark"});
+		D.deviceType = "edgecore_eap101";
+		D.venue = MicroServiceCreateUUID();
+		D.entity = MicroServiceCreateUUID();
+		D.deviceRules.rrm = "inherit";
+		D.state = R"({"method":"auto","date":1700000000})";
+		D.devClass = "any";
+		Records.push_back(std::move(D));
+	}
+	if (!DB.CreateRecords(Records)) {
+		std::cout << "Could not create the inventory records." << std::endl;
+		return 1;
+	}
+
+	constexpr std::uint64_t Rounds = 20;
+	auto Full = Benchmark::Measure(fmt::format("GetRecords, {} devices", Devices), Rounds, [&] {
+		std::vector<ProvObjects::InventoryTag> Rows;
+		DB.GetRecords(0, Devices, Rows);
+		Benchmark::KeepAlive(Rows.size());
+	});
+	auto Projected =
+		Benchmark::Measure(fmt::format("GetColumns of 4 columns, {} devices", Devices), Rounds, [&] {
+			std::vector<Poco::Tuple<std::string, std::string, std::string, std::string>> Rows;
+			DB.GetColumns({"serialNumber", "deviceType", "venue", "entity"}, Rows);
+			Benchmark::KeepAlive(Rows.size());
+		});
+	Benchmark::Compare("speedup", Full, Projected);
+	return 0;
+}
@@ -0,0 +1,107 @@
+//	Rate limit checks from 1024 clients on 1 to N threads: RESTAPI_RateLimiter against the
+//	single ExpireLRUCache it replaced, which parsed the URI and built a string key per call.
+
+#include <sstream>
+
+#include "Poco/ExpireLRUCache.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/URI.h"
+
+#include "Benchmark.h"
+
+#include "framework/RESTAPI_RateLimiter.h"
+
+using namespace OpenWifi;
+
+//	Just enough of a request for the limiter: a URI and a client address.
+class BenchRequest : public Poco::Net::HTTPServerRequest {
+  public:
+	BenchRequest(const std::string &URI, const Poco::Net::SocketAddress &Client)
+		: Client_(Client) {
+		setURI(URI);
+	}
+	std::istream &stream() { return Body_; }
+	bool expectContinue() const { return false; }
+	bool secure() const { return false; }
+	const Poco::Net::SocketAddress &clientAddress() const { return Client_; }
+	const Poco::Net::SocketAddress &serverAddress() const { return Client_; }
+	const Poco::Net::HTTPServerParams &serverParams() const {
+		throw Poco::NotImplementedException("serverParams");
+	}
+	Poco::Net::HTTPServerResponse &response() const {
+		throw Poco::NotImplementedException("response");
+	}
+
+  private:
+	Poco::Net::SocketAddress Client_;
+	std::istringstream Body_;
+};
+
+//	The limiter as it was before the sliding windows.
+class LRULimiter {
+  public:
+	bool IsRateLimited(const Poco::Net::HTTPServerRequest &R, int64_t Period, int64_t MaxCalls) {
+		Poco::URI uri(R.getURI());
+		auto H = str_hash(uri.getPath() + R.clientAddress().host().toString());
+		auto E = Cache_.get(H);
+		auto Now = std::chrono::duration_cast<std::chrono::milliseconds>(
+					   std::chrono::system_clock::now().time_since_epoch())
+					   .count();
+		if (E.isNull()) {
+			Cache_.add(H, Entry{Now, 1});
+			return false;
+		}
+		if ((Now - E->Start) < Period) {
+			E->Count++;
+			Cache_.update(H, E);
+			return E->Count > MaxCalls;
+		}
+		E->Start = Now;
+		E->Count = 1;
+		Cache_.update(H, E);
+		return false;
+	}
+
+  private:
+	struct Entry {
+		int64_t Start = 0;
+		int Count = 0;
+	};
+	Poco::ExpireLRUCache<uint64_t, Entry> Cache_{2048};
+	std::hash<std::string> str_hash;
+};
+
+int main() {
+	constexpr std::size_t Clients = 1024;
+	std::vector<std::unique_ptr<BenchRequest>> Requests;
+	for (std::size_t i = 0; i < Clients; ++i) {
+		auto Client = Poco::Net::SocketAddress(
+			fmt::format("10.{}.{}.{}", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff), 40000);
+		Requests.push_back(std::make_unique<BenchRequest>(
+			fmt::format("/api/v1/inventory/{:012x}?withExtendedInfo=true", i), Client));
+	}
+
+	//	Limits high enough that nothing is throttled: only the bookkeeping is timed.
+	constexpr int64_t Period = 1000, MaxCalls = 1000000000;
+	constexpr std::uint64_t Calls = 200000;
+	LRULimiter Before;
+	std::vector<unsigned> ThreadCounts{1, 4};
+	if (auto Cores = std::thread::hardware_concurrency(); Cores > 4)
+		ThreadCounts.push_back(Cores);
+	for (auto Threads : ThreadCounts) {
+		auto Baseline = Benchmark::MeasureThreads(
+			"ExpireLRUCache limiter", Threads, Calls, [&](unsigned t, std::uint64_t i) {
+				auto &R = *Requests[(t * 7919 + i) % Clients];
+				Benchmark::KeepAlive(Before.IsRateLimited(R, Period, MaxCalls));
+			});
+		auto Candidate = Benchmark::MeasureThreads(
+			"RESTAPI_RateLimiter", Threads, Calls, [&](unsigned t, std::uint64_t i) {
+				auto &R = *Requests[(t * 7919 + i) % Clients];
+				Benchmark::KeepAlive(RESTAPI_RateLimiter()->IsRateLimited(R, Period, MaxCalls));
+			});
+		Benchmark::Compare(fmt::format("speedup on {} threads", Threads), Baseline, Candidate);
+	}
+	return 0;
+}
@@ -0,0 +1,137 @@
+//	Routing a request path to its handler: the path trie used by RESTAPI_Dispatch against
+//	calling ParseBindings on each handler in turn, over every path the external router serves.
+
+#include "Benchmark.h"
+
+#include "RESTAPI/RESTAPI_asset_server.h"
+#include "RESTAPI/RESTAPI_configurations_handler.h"
+#include "RESTAPI/RESTAPI_configurations_list_handler.h"
+#include "RESTAPI/RESTAPI_contact_handler.h"
+#include "RESTAPI/RESTAPI_contact_list_handler.h"
+#include "RESTAPI/RESTAPI_dashboard_handler.h"
+#include "RESTAPI/RESTAPI_entity_handler.h"
+#include "RESTAPI/RESTAPI_entity_list_handler.h"
+#include "RESTAPI/RESTAPI_inventory_handler.h"
+#include "RESTAPI/RESTAPI_inventory_list_handler.h"
+#include "RESTAPI/RESTAPI_iptocountry_handler.h"
+#include "RESTAPI/RESTAPI_location_handler.h"
+#include "RESTAPI/RESTAPI_location_list_handler.h"
+#include "RESTAPI/RESTAPI_managementPolicy_handler.h"
+#include "RESTAPI/RESTAPI_managementPolicy_list_handler.h"
+#include "RESTAPI/RESTAPI_managementRole_list_handler.h"
+#include "RESTAPI/RESTAPI_map_handler.h"
+#include "RESTAPI/RESTAPI_map_list_handler.h"
+#include "RESTAPI/RESTAPI_op_contact_handler.h"
+#include "RESTAPI/RESTAPI_op_contact_list_handler.h"
+#include "RESTAPI/RESTAPI_op_location_handler.h"
+#include "RESTAPI/RESTAPI_op_location_list_handler.h"
+#include "RESTAPI/RESTAPI_openroaming_gr_acct_handler.h"
+#include "RESTAPI/RESTAPI_openroaming_gr_cert_handler.h"
+#include "RESTAPI/RESTAPI_openroaming_gr_list_acct_handler.h"
+#include "RESTAPI/RESTAPI_openroaming_gr_list_certificates.h"
+#include "RESTAPI/RESTAPI_openroaming_orion_acct_handler.h"
+#include "RESTAPI/RESTAPI_openroaming_orion_list_acct_handler.h"
+#include "RESTAPI/RESTAPI_operators_handler.h"
+#include "RESTAPI/RESTAPI_operators_list_handler.h"
+#include "RESTAPI/RESTAPI_overrides_handler.h"
+#include "RESTAPI/RESTAPI_radius_endpoint_handler.h"
+#include "RESTAPI/RESTAPI_radiusendpoint_list_handler.h"
+#include "RESTAPI/RESTAPI_scheduled_job_handler.h"
+#include "RESTAPI/RESTAPI_scheduled_job_list_handler.h"
+#include "RESTAPI/RESTAPI_service_class_handler.h"
+#include "RESTAPI/RESTAPI_service_class_list_handler.h"
+#include "RESTAPI/RESTAPI_signup_handler.h"
+#include "RESTAPI/RESTAPI_sub_devices_handler.h"
+#include "RESTAPI/RESTAPI_sub_devices_list_handler.h"
+#include "RESTAPI/RESTAPI_tags_handler.h"
+#include "RESTAPI/RESTAPI_variables_handler.h"
+#include "RESTAPI/RESTAPI_variables_list_handler.h"
+#include "RESTAPI/RESTAPI_venue_handler.h"
+#include "RESTAPI/RESTAPI_venue_list_handler.h"
+
+#include "framework/RESTAPI_SystemCommand.h"
+#include "framework/RESTAPI_SystemConfiguration.h"
+#include "framework/RESTAPI_WebSocketServer.h"
+
+using namespace OpenWifi;
+
+template <typename... Handlers> static std::vector<std::list<std::string>> PathsOf() {
+	return {Handlers::PathName()...};
+}
+
+//	A request path for a template: every {parameter} gets a value.
+static std::string RequestFor(const std::string &Template) {
+	std::string Path;
+	bool First = true;
+	for (const auto &Segment : Poco::StringTokenizer(Template, "/")) {
+		if (!First)
+			Path += "/";
+		First = false;
+		Path += (!Segment.empty() && Segment.front() == '{') ? "9a5b2e1c-4d3f-4e6a-8b7c-0d1e2f3a4b5c"
+															 : Segment;
+	}
+	return Path;
+}
+
+int main() {
+	const auto Handlers = PathsOf<
+		RESTAPI_system_command, RESTAPI_system_configuration, RESTAPI_entity_handler,
+		RESTAPI_entity_list_handler, RESTAPI_contact_handler, RESTAPI_contact_list_handler,
+		RESTAPI_location_handler, RESTAPI_location_list_handler, RESTAPI_venue_handler,
+		RESTAPI_venue_list_handler, RESTAPI_inventory_handler, RESTAPI_inventory_list_handler,
+		RESTAPI_managementPolicy_handler, RESTAPI_managementPolicy_list_handler,
+		RESTAPI_managementRole_list_handler, RESTAPI_configurations_handler,
+		RESTAPI_configurations_list_handler, RESTAPI_map_handler, RESTAPI_map_list_handler,
+		RESTAPI_webSocketServer, RESTAPI_iptocountry_handler, RESTAPI_signup_handler,
+		RESTAPI_variables_handler, RESTAPI_variables_list_handler, RESTAPI_sub_devices_handler,
+		RESTAPI_sub_devices_list_handler, RESTAPI_operators_handler,
+		RESTAPI_operators_list_handler, RESTAPI_service_class_handler,
+		RESTAPI_service_class_list_handler, RESTAPI_op_contact_handler,
+		RESTAPI_op_contact_list_handler, RESTAPI_op_location_handler,
+		RESTAPI_op_location_list_handler, RESTAPI_asset_server, RESTAPI_overrides_handler,
+		RESTAPI_openroaming_gr_acct_handler, RESTAPI_openroaming_gr_list_acct_handler,
+		RESTAPI_openroaming_gr_cert_handler, RESTAPI_openroaming_gr_list_certificates,
+		RESTAPI_openroaming_orion_acct_handler, RESTAPI_openroaming_orion_list_acct_handler,
+		RESTAPI_radiusendpoint_list_handler, RESTAPI_radius_endpoint_handler,
+		RESTAPI_dashboard_handler, RESTAPI_tags_handler, RESTAPI_scheduled_job_handler,
+		RESTAPI_scheduled_job_list_handler>();
+
+	RESTAPI_RouteTrie Trie;
+	std::vector<std::string> Requests;
+	for (std::size_t i = 0; i < Handlers.size(); ++i) {
+		Trie.Add(i, Handlers[i]);
+		for (const auto &Template : Handlers[i])
+			Requests.push_back(RequestFor(Template));
+	}
+	Requests.emplace_back("/api/v1/nosuchresource/9a5b2e1c");
+
+	//	Both must route every request to the same handler before timing means anything.
+	RESTAPIHandler::BindingMap Bindings;
+	auto Sequential = [&](const std::string &Path) {
+		for (std::size_t i = 0; i < Handlers.size(); ++i) {
+			if (RESTAPIHandler::ParseBindings(Path, Handlers[i], Bindings))
+				return i;
+		}
+		return RESTAPI_RouteTrie::NoRoute;
+	};
+	for (const auto &Path : Requests) {
+		if (Sequential(Path) != Trie.Resolve(Path, Bindings)) {
+			std::cout << "Routing mismatch for " << Path << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << fmt::format("{} handlers, {} request paths", Handlers.size(), Requests.size())
+			  << std::endl;
+	constexpr std::uint64_t Rounds = 2000;
+	auto Baseline = Benchmark::Measure("ParseBindings on each handler, all paths", Rounds, [&] {
+		for (const auto &Path : Requests)
+			Benchmark::KeepAlive(Sequential(Path));
+	});
+	auto Candidate = Benchmark::Measure("RESTAPI_RouteTrie::Resolve, all paths", Rounds, [&] {
+		for (const auto &Path : Requests)
+			Benchmark::KeepAlive(Trie.Resolve(Path, Bindings));
+	});
+	Benchmark::Compare("speedup", Baseline, Candidate);
+	return 0;
+}
@@ -0,0 +1,82 @@
+//	Serial number search over a million serials: prefix, suffix and contains queries through the
+//	indexes of SerialNumberCache, against a scan of every serial number. Also prints how much the
+//	resident size grew while loading, to check the memory cost of the trigram index.
+
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+#include "Benchmark.h"
+
+#include "SerialNumberCache.h"
+#include "framework/utils.h"
+
+using namespace OpenWifi;
+
+static constexpr std::size_t Serials = 1000000;
+static constexpr uint PageSize = 100;
+
+static std::uint64_t ResidentBytes() {
+	std::ifstream Statm("/proc/self/statm");
+	std::uint64_t Size = 0, Resident = 0;
+	Statm >> Size >> Resident;
+	return Resident * (std::uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+//	What a contains query costs without the trigram index.
+static void Scan(const std::vector<uint64_t> &SNs, const std::string &Digits, uint HowMany,
+				 std::vector<uint64_t> &A) {
+	for (const auto SN : SNs) {
+		if (Utils::IntToSerialNumber(SN).find(Digits) != std::string::npos) {
+			A.push_back(SN);
+			if (A.size() == HowMany)
+				return;
+		}
+	}
+}
+
+int main() {
+	std::mt19937_64 Random(42);
+	std::vector<SerialNumberCache::SerialEntry> Entries;
+	Entries.reserve(Serials);
+	for (std::size_t i = 0; i < Serials; ++i)
+		Entries.push_back({Utils::IntToSerialNumber(Random() & 0xffffffffffff),
+						   i % 2 ? "edgecore_eap101" : "cig_wf188n", "", ""});
+
+	auto Before = ResidentBytes();
+	auto Start = std::chrono::steady_clock::now();
+	SerialNumberCache()->AddSerialNumbers(Entries);
+	std::chrono::duration<double, std::milli> Load = std::chrono::steady_clock::now() - Start;
+	auto After = ResidentBytes();
+	std::cout << fmt::format("Loaded {} serials in {:.0f} ms, resident size +{} MB", Serials,
+							 Load.count(), (After - Before) >> 20)
+			  << std::endl;
+
+	auto SNs = SerialNumberCache()->GetCacheCopy();
+	//	Digits taken from a serial that exists, so every query has results.
+	const auto Sample = Utils::IntToSerialNumber(SNs[SNs.size() / 2]);
+	const auto Prefix = Sample.substr(0, 5), Suffix = Sample.substr(7), Middle = Sample.substr(4, 5);
+
+	std::vector<uint64_t> A;
+	std::string Continuation;
+	auto Query = [&](const std::string &Q, const SerialNumberCache::SearchFilter &Filter) {
+		A.clear();
+		SerialNumberCache()->Search(Q, Filter, PageSize, "", A, Continuation);
+		Benchmark::KeepAlive(A.size());
+	};
+
+	constexpr std::uint64_t Rounds = 20000;
+	Benchmark::Measure("Search prefix " + Prefix, Rounds, [&] { Query(Prefix, {}); });
+	Benchmark::Measure("Search suffix *" + Suffix, Rounds, [&] { Query("*" + Suffix, {}); });
+	auto Indexed = Benchmark::Measure("Search contains *" + Middle + "*", Rounds,
+									  [&] { Query("*" + Middle + "*", {}); });
+	Benchmark::Measure("Search contains *" + Middle + "*, deviceType filter", Rounds,
+					   [&] { Query("*" + Middle + "*", {"edgecore_eap101", "", ""}); });
+	auto Scanned = Benchmark::Measure("Scan of every serial for " + Middle, 20, [&] {
+		A.clear();
+		Scan(SNs, Middle, PageSize, A);
+		Benchmark::KeepAlive(A.size());
+	});
+	Benchmark::Compare("contains speedup", Scanned, Indexed);
+	return 0;
+}
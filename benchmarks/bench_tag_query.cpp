@@ -0,0 +1,77 @@
+//	Tag queries over 200000 tagged objects: the inverted index TagServer keeps, against checking
+//	the tags of every object, for a common tag, a rare one, and combinations of both.
+
+#include <random>
+
+#include "Benchmark.h"
+
+#include "TagServer.h"
+#include "framework/MicroServiceFuncs.h"
+
+using namespace OpenWifi;
+
+static constexpr std::size_t Objects = 200000;
+
+//	What a query costs without the index.
+static uint64_t Scan(const std::vector<TagsObject> &All, const Types::StringVec &Tags,
+					 Types::StringVec &Arns) {
+	uint64_t Total = 0;
+	for (const auto &T : All) {
+		auto Terms = TagIndex::Terms(T.entries);
+		if (std::all_of(Tags.begin(), Tags.end(), [&Terms](const std::string &Tag) {
+				return std::binary_search(Terms.begin(), Terms.end(), Tag);
+			})) {
+			if (Arns.size() < 100)
+				Arns.push_back(T.arn);
+			++Total;
+		}
+	}
+	return Total;
+}
+
+int main() {
+	std::mt19937 Random(42);
+	const char *Prefixes[] = {"inv", "ven", "ent", "cfg"};
+	std::vector<TagsObject> All;
+	TagIndex Index;
+	Index.Reserve(Objects);
+	for (std::size_t i = 0; i < Objects; ++i) {
+		TagsObject T;
+		T.entity = "bench";
+		T.arn = std::string{Prefixes[i % 4]} + ":" + MicroServiceCreateUUID();
+		T.entries = {fmt::format("building={}", Random() % 50),
+					 fmt::format("floor={}", Random() % 20),
+					 fmt::format("owner={}", Random() % 2000), "managed"};
+		if (Random() % 100 == 0)
+			T.entries.emplace_back("critical");
+		All.push_back(T);
+		Index.Insert(std::move(T));
+	}
+	std::cout << fmt::format("{} objects, {} distinct tags", Index.ObjectCount(), Index.TagCount())
+			  << std::endl;
+
+	const std::vector<std::pair<std::string, Types::StringVec>> Queries{
+		{"common tag", {"building=7"}},
+		{"rare tag", {"critical"}},
+		{"two common tags", {"building=7", "floor=3"}},
+		{"rare and common tags", {"critical", "managed"}},
+		{"three tags", {"building", "floor=3", "owner=42"}},
+	};
+	for (const auto &[Name, Tags] : Queries) {
+		Types::StringVec Indexed, Scanned;
+		if (Index.Find(Tags, "", 0, 100, Indexed) != Scan(All, Tags, Scanned)) {
+			std::cout << "The index and the scan disagree for " << Name << std::endl;
+			return 1;
+		}
+		auto Baseline = Benchmark::Measure("Scan, " + Name, 5, [&] {
+			Types::StringVec Arns;
+			Benchmark::KeepAlive(Scan(All, Tags, Arns));
+		});
+		auto Candidate = Benchmark::Measure("TagIndex::Find, " + Name, 2000, [&] {
+			Types::StringVec Arns;
+			Benchmark::KeepAlive(Index.Find(Tags, "", 0, 100, Arns));
+		});
+		Benchmark::Compare("speedup", Baseline, Candidate);
+	}
+	return 0;
+}
@@ -9,10 +9,7 @@
 #include "Poco/StringTokenizer.h"
 #include "fmt/format.h"
 
-#include <RadiusEndpointTypes/OrionWifi.h>
-#include <RadiusEndpointTypes/GlobalReach.h>
-#include <RadiusEndpointTypes/Radsec.h>
-#include <RadiusEndpointTypes/GenericRadius.h>
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 
@@ -60,25 +57,6 @@ namespace OpenWifi {
 		 */
 	}
 
-    bool APConfig::InsertRadiusEndPoint(const ProvObjects::RADIUSEndPoint &RE, Poco::JSON::Object &Result) {
-        if(RE.UseGWProxy) {
-            Poco::JSON::Object  ServerSettings;
-            if (RE.Type == "orion") {
-                return OpenRoaming_Orion()->Render(RE, SerialNumber_, Result);
-            } else if (RE.Type == "globalreach") {
-                return OpenRoaming_GlobalReach()->Render(RE, SerialNumber_, Result);
-            } else if (RE.Type == "radsec") {
-                return OpenRoaming_Radsec()->Render(RE, SerialNumber_, Result);
-            } else if (RE.Type == "generic") {
-                return OpenRoaming_GenericRadius()->Render(RE, SerialNumber_, Result);
-            }
-            Result.set( "radius" , ServerSettings);
-        } else {
-            std::cout << "Radius proxy off" << RE.info.name << std::endl;
-        }
-        return false;
-    }
-
 	void APConfig::ReplaceNestedVariables(const std::string uuid, Poco::JSON::Object &Result) {
 		/*
 		Helper method contains code previously in ReplaceVariablesinObject.
@@ -149,12 +127,8 @@ namespace OpenWifi {
 				}
             } else if (i == "__radiusEndpoint") {
                 auto EndPointId = Original.get(i).toString();
-                ProvObjects::RADIUSEndPoint RE;
-//                std::cout << "ID->" << EndPointId << std::endl;
-                if(StorageService()->RadiusEndpointDB().GetRecord("id",EndPointId,RE)) {
-                    InsertRadiusEndPoint(RE, Result);
-                } else {
-                    poco_error(Logger_, fmt::format("RADIUS Endpoint {} could not be found. Please delete this configuration and recreate it."));
+                if(!RadiusEndpointRenderCache()->Render(EndPointId, SerialNumber_, Result)) {
+                    poco_error(Logger_, fmt::format("RADIUS Endpoint {} could not be found. Please delete this configuration and recreate it.", EndPointId));
                     return false;
                 }
 			} else if (Original.isArray(i)) {
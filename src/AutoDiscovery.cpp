@@ -3,7 +3,10 @@
 //
 
 #include "AutoDiscovery.h"
+#include "Dashboard.h"
+#include "OwnershipRing.h"
 #include "Poco/JSON/Parser.h"
+#include "Signup.h"
 #include "StorageService.h"
 #include "Tasks/VenueConfigUpdater.h"
 #include "framework/KafkaManager.h"
@@ -105,7 +108,8 @@ namespace OpenWifi {
                             poco_debug(Logger(),fmt::format("Unknown message on 'connection' topic: {}",Msg->Payload()));
                         }
 
-                        if (!SerialNumber.empty() && Connected) {
+                        //  Another replica owns this device: only the dashboard counts it here.
+                        if (!SerialNumber.empty() && Connected && OwnershipRing()->Owns(SerialNumber)) {
                             StorageService()->InventoryDB().CreateFromConnection(
                                     SerialNumber, ConnectedIP, Compatible, Locale, isConnection);
                             // Now that the entry has been created, we can try to push a config if
@@ -114,6 +118,12 @@ namespace OpenWifi {
                                 ComputeAndPushConfig(SerialNumber, Compatible, Logger());
                             }
                         }
+                        if (!SerialNumber.empty()) {
+                            ProvisioningDashboard()->DeviceConnected(SerialNumber, Connected);
+                            //  Every replica looks: the signup may be waiting on any of them.
+                            if (Connected)
+                                Signup()->DeviceConnected(SerialNumber);
+                        }
                     }
 				} catch (const Poco::Exception &E) {
                     std::cout << "EX:" << Msg->Payload() << std::endl;
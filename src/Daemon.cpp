@@ -15,11 +15,16 @@
 #include "Daemon.h"
 #include "DeviceTypeCache.h"
 #include "FileDownloader.h"
+#include "FirmwareCatalog.h"
 #include "FindCountry.h"
+#include "InvalidationBus.h"
 #include "JobController.h"
+#include "JobScheduler.h"
+#include "OwnershipRing.h"
 #include "SerialNumberCache.h"
 #include "Signup.h"
 #include "StorageService.h"
+#include "TagServer.h"
 #include "UI_Prov_WebSocketNotifications.h"
 #include "framework/ConfigurationValidator.h"
 #include "framework/UI_WebSocketClientServer.h"
@@ -27,6 +32,7 @@
 #include <RadiusEndpointTypes/OrionWifi.h>
 #include <RadiusEndpointTypes/Radsec.h>
 #include <RadiusEndpointTypes/GenericRadius.h>
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 	class Daemon *Daemon::instance_ = nullptr;
@@ -35,14 +41,16 @@ namespace OpenWifi {
 		if (instance_ == nullptr) {
 			instance_ = new Daemon(vDAEMON_PROPERTIES_FILENAME, vDAEMON_ROOT_ENV_VAR,
 								   vDAEMON_CONFIG_ENV_VAR, vDAEMON_APP_NAME, vDAEMON_BUS_TIMER,
-								   SubSystemVec{OpenWifi::StorageService(), DeviceTypeCache(),
-												ConfigurationValidator(), SerialNumberCache(),
-												AutoDiscovery(), JobController(),
+								   SubSystemVec{OpenWifi::StorageService(), DeviceTypeCache(), FirmwareCatalog(),
+												ConfigurationValidator(), SerialNumberCache(), TagServer(),
+												ProvisioningDashboard(), OwnershipRing(), AutoDiscovery(), JobController(),
+												JobScheduler(),
 												UI_WebSocketClientServer(), FindCountryFromIP(),
 												Signup(), FileDownloader(),
                                                 OpenRoaming_GlobalReach(),
                                                 OpenRoaming_Orion(), OpenRoaming_Radsec(),
-                                                OpenRoaming_GenericRadius()
+                                                OpenRoaming_GenericRadius(), RadiusEndpointRenderCache(),
+                                                InvalidationBus()
             });
 		}
 		return instance_;
@@ -79,6 +87,8 @@ namespace OpenWifi {
 
 } // namespace OpenWifi
 
+//	The benchmarks link the whole service and bring their own main().
+#ifndef OWPROV_NO_MAIN
 int main(int argc, char **argv) {
 	int ExitCode;
 	try {
@@ -100,5 +110,6 @@ int main(int argc, char **argv) {
 	std::cout << "Exitcode: " << ExitCode << std::endl;
 	return ExitCode;
 }
+#endif
 
 // end of namespace
\ No newline at end of file
@@ -37,7 +37,7 @@ namespace OpenWifi {
 			: MicroService(PropFile, RootEnv, ConfigEnv, AppName, BusTimer, SubSystems){};
 
 		static Daemon *instance();
-		inline OpenWifi::ProvisioningDashboard &GetDashboard() { return DB_; }
+		inline class ProvisioningDashboard &GetDashboard() { return *ProvisioningDashboard(); }
 		Poco::Logger &Log() { return Poco::Logger::get(AppName()); }
 		ProvObjects::FIRMWARE_UPGRADE_RULES FirmwareRules() const { return FWRules_; }
 		inline const std::string &AssetDir() { return AssetDir_; }
@@ -45,7 +45,6 @@ namespace OpenWifi {
 
 	  private:
 		static Daemon *instance_;
-		OpenWifi::ProvisioningDashboard DB_{};
 		ProvObjects::FIRMWARE_UPGRADE_RULES FWRules_{ProvObjects::dont_upgrade};
 		std::string AssetDir_;
 		std::unique_ptr<ProvWebSocketClient> WebSocketProcessor_;
@@ -6,15 +6,214 @@
 //	Arilia Wireless Inc.
 //
 #include "Dashboard.h"
+#include "StorageService.h"
+#include "framework/RESTAPI_utils.h"
 #include "framework/utils.h"
+#include "nlohmann/json.hpp"
 
 namespace OpenWifi {
+
+	static void Decrement(Types::CountedMap &M, const std::string &S) {
+		auto It = M.find(S);
+		if (It == M.end())
+			return;
+		if (--It->second == 0)
+			M.erase(It);
+	}
+
+	int ProvisioningDashboard::Start() {
+		poco_information(Logger(), "Starting...");
+		Create();
+		//	Writes done here and on the other replicas: every inventory write path ends up in
+		//	the feed, so the counts cannot drift.
+		auto OnChange = [this](const std::string &, const std::vector<std::string> &Ids) {
+			DevicesChanged(Ids);
+		};
+		const auto &Table = StorageService()->InventoryDB().TableName();
+		ORM::ChangeFeed()->SubscribeWrites(Table, OnChange);
+		ORM::ChangeFeed()->Subscribe(Table, OnChange);
+		return 0;
+	}
+
+	void ProvisioningDashboard::Stop() {
+		poco_information(Logger(), "Stopping...");
+		poco_information(Logger(), "Stopped...");
+	}
+
+	//	Only the columns the counts need: the rest of the record is never decoded.
+	bool ProvisioningDashboard::ReadCounters(const std::string &Where,
+											 std::vector<CounterColumns> &Rows) {
+		return StorageService()->InventoryDB().GetColumns(
+			{"id", "serialNumber", "entity", "venue", "deviceType", "devClass", "deviceRules",
+			 "state"},
+			Rows, Where);
+	}
+
+	ProvisioningDashboard::DeviceCounters
+	ProvisioningDashboard::Counters(const CounterColumns &Row) {
+		DeviceCounters D;
+		D.SerialNumber = Row.get<1>();
+		D.Entity = Row.get<2>();
+		D.Venue = Row.get<3>();
+		D.DeviceType = Row.get<4>();
+		D.DevClass = Row.get<5>().empty() ? "any" : Row.get<5>();
+		auto Rules = RESTAPI_utils::to_object<ProvObjects::DeviceRules>(Row.get<6>());
+		D.FirmwareUpgrade = Rules.firmwareUpgrade.empty() ? "inherit" : Rules.firmwareUpgrade;
+		D.ClaimState = "none";
+		if (!Row.get<7>().empty()) {
+			try {
+				auto State = nlohmann::json::parse(Row.get<7>());
+				if (State.contains("method") && State["method"].is_string())
+					D.ClaimState = State["method"];
+			} catch (...) {
+			}
+		}
+		return D;
+	}
+
+	void ProvisioningDashboard::Add(const DeviceCounters &D) {
+		Counts_.totalDevices++;
+		UpdateCountedMap(Counts_.tenants, D.Entity);
+		UpdateCountedMap(Counts_.venues, D.Venue);
+		UpdateCountedMap(Counts_.deviceTypes, D.DeviceType);
+		UpdateCountedMap(Counts_.deviceClasses, D.DevClass);
+		UpdateCountedMap(Counts_.firmwareUpgrade, D.FirmwareUpgrade);
+		UpdateCountedMap(Counts_.claimState, D.ClaimState);
+		UpdateCountedMap(Counts_.connection, D.Connection);
+		Dirty_ = true;
+	}
+
+	void ProvisioningDashboard::Remove(const DeviceCounters &D) {
+		Counts_.totalDevices--;
+		Decrement(Counts_.tenants, D.Entity);
+		Decrement(Counts_.venues, D.Venue);
+		Decrement(Counts_.deviceTypes, D.DeviceType);
+		Decrement(Counts_.deviceClasses, D.DevClass);
+		Decrement(Counts_.firmwareUpgrade, D.FirmwareUpgrade);
+		Decrement(Counts_.claimState, D.ClaimState);
+		Decrement(Counts_.connection, D.Connection);
+		Dirty_ = true;
+	}
+
+	//	Both expect Mutex_ to be held. The connection state comes from the connection events,
+	//	so it survives updates of the record.
+	void ProvisioningDashboard::Set(const std::string &Id, DeviceCounters &&D) {
+		auto Hint = Devices_.find(Id);
+		if (Hint != Devices_.end()) {
+			D.Connection = Hint->second.Connection;
+			Remove(Hint->second);
+			if (Hint->second.SerialNumber != D.SerialNumber)
+				Serials_.erase(Hint->second.SerialNumber);
+			Hint->second = std::move(D);
+		} else {
+			Hint = Devices_.emplace(Id, std::move(D)).first;
+		}
+		Serials_[Hint->second.SerialNumber] = Id;
+		Add(Hint->second);
+	}
+
+	void ProvisioningDashboard::Erase(const std::string &Id) {
+		auto Hint = Devices_.find(Id);
+		if (Hint == Devices_.end())
+			return;
+		Remove(Hint->second);
+		Serials_.erase(Hint->second.SerialNumber);
+		Devices_.erase(Hint);
+	}
+
 	void ProvisioningDashboard::Create() {
-		uint64_t Now = Utils::Now();
-		if (LastRun_ == 0 || (Now - LastRun_) > 120) {
-			DB_.reset();
-			//  Todo: call dashboard creation code.
-			LastRun_ = Now;
+		std::vector<CounterColumns> Rows;
+		if (!ReadCounters("", Rows))
+			return;
+		std::lock_guard G(Mutex_);
+		auto Devices = std::move(Devices_);
+		Devices_.clear();
+		Serials_.clear();
+		Counts_.reset();
+		Pending_.clear();
+		Reload_ = false;
+		for (const auto &Row : Rows) {
+			auto D = Counters(Row);
+			//	Keep what the connection events told us since the last load.
+			if (auto Hint = Devices.find(Row.get<0>()); Hint != Devices.end())
+				D.Connection = Hint->second.Connection;
+			Set(Row.get<0>(), std::move(D));
+		}
+		poco_information(Logger(), fmt::format("Loaded {} devices.", Devices_.size()));
+	}
+
+	void ProvisioningDashboard::DevicesChanged(const std::vector<std::string> &Ids) {
+		std::lock_guard G(Mutex_);
+		if (Ids.empty())
+			Reload_ = true;
+		else
+			Pending_.insert(Ids.begin(), Ids.end());
+	}
+
+	//	Re-reads the devices written since the last report: rows that are gone were deleted.
+	void ProvisioningDashboard::ApplyChanges() {
+		std::vector<std::string> Ids;
+		{
+			std::lock_guard G(Mutex_);
+			if (!Reload_) {
+				if (Pending_.empty())
+					return;
+				Ids.assign(Pending_.begin(), Pending_.end());
+				Pending_.clear();
+			}
+		}
+		if (Ids.empty())
+			return Create();
+
+		for (std::size_t From = 0; From < Ids.size(); From += RefreshBatch) {
+			auto To = std::min(Ids.size(), From + RefreshBatch);
+			std::vector<CounterColumns> Rows;
+			if (!ReadCounters("id in (" + ORM::InList(Ids.begin() + From, Ids.begin() + To) + ")",
+							  Rows)) {
+				std::lock_guard G(Mutex_);
+				Pending_.insert(Ids.begin() + From, Ids.end());
+				return;
+			}
+			std::lock_guard G(Mutex_);
+			std::set<std::string> Found;
+			for (const auto &Row : Rows) {
+				Found.insert(Row.get<0>());
+				Set(Row.get<0>(), Counters(Row));
+			}
+			for (auto i = From; i < To; ++i) {
+				if (Found.count(Ids[i]) == 0)
+					Erase(Ids[i]);
+			}
+		}
+	}
+
+	std::shared_ptr<const ProvObjects::Report> ProvisioningDashboard::Report() {
+		ApplyChanges();
+		std::lock_guard G(Mutex_);
+		auto Now = Utils::Now();
+		if (Snapshot_ == nullptr || (Dirty_ && (Now - Snapshot_->snapShot) >= MinSnapshotAge)) {
+			auto Snapshot = std::make_shared<ProvObjects::Report>(Counts_);
+			Snapshot->snapShot = Now;
+			Snapshot_ = std::move(Snapshot);
+			Dirty_ = false;
 		}
+		return Snapshot_;
+	}
+
+	void ProvisioningDashboard::DeviceConnected(const std::string &SerialNumber, bool Connected) {
+		std::lock_guard G(Mutex_);
+		auto Id = Serials_.find(SerialNumber);
+		if (Id == Serials_.end())
+			return;
+		auto Hint = Devices_.find(Id->second);
+		if (Hint == Devices_.end())
+			return;
+		const char *Connection = Connected ? "connected" : "disconnected";
+		if (Hint->second.Connection == Connection)
+			return;
+		Decrement(Counts_.connection, Hint->second.Connection);
+		Hint->second.Connection = Connection;
+		UpdateCountedMap(Counts_.connection, Hint->second.Connection);
+		Dirty_ = true;
 	}
 } // namespace OpenWifi
@@ -8,21 +8,80 @@
 
 #pragma once
 
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+#include "Poco/Tuple.h"
+
 #include "RESTObjects/RESTAPI_ProvObjects.h"
 #include "framework/OpenWifiTypes.h"
+#include "framework/SubSystemServer.h"
 
 namespace OpenWifi {
-	class ProvisioningDashboard {
+
+	//	Device counts kept up to date from the inventory writes and the connection events, so
+	//	the dashboard never needs to scan the inventory after the initial load. Writes come from
+	//	the ORM change feed, local and remote, whatever the write path: the devices written are
+	//	re-read when the next report is built.
+	class ProvisioningDashboard : public SubSystemServer {
 	  public:
-		void Create();
-		[[nodiscard]] const ProvObjects::Report &Report() const { return DB_; }
-		inline void Reset() {
-			LastRun_ = 0;
-			DB_.reset();
+		static auto instance() {
+			static auto instance_ = new ProvisioningDashboard;
+			return instance_;
 		}
 
+		int Start() override;
+		void Stop() override;
+
+		//	Rebuilds all the counts from the inventory table.
+		void Create();
+		//	A consistent copy of the counts, at most MinSnapshotAge seconds old.
+		[[nodiscard]] std::shared_ptr<const ProvObjects::Report> Report();
+
+		//	Inventory rows written, by id. An empty list means the whole table.
+		void DevicesChanged(const std::vector<std::string> &Ids);
+		void DeviceConnected(const std::string &SerialNumber, bool Connected);
+
 	  private:
-		ProvObjects::Report DB_{};
-		uint64_t LastRun_ = 0;
+		static constexpr uint64_t MinSnapshotAge = 1;
+		static constexpr std::size_t RefreshBatch = 200;
+
+		struct DeviceCounters {
+			std::string SerialNumber;
+			std::string Entity;
+			std::string Venue;
+			std::string DeviceType;
+			std::string DevClass;
+			std::string FirmwareUpgrade;
+			std::string ClaimState;
+			std::string Connection{"unknown"};
+		};
+
+		//	By device id, and the id of each serial number for the connection events.
+		std::unordered_map<std::string, DeviceCounters> Devices_;
+		std::unordered_map<std::string, std::string> Serials_;
+		ProvObjects::Report Counts_;
+		std::shared_ptr<const ProvObjects::Report> Snapshot_;
+		bool Dirty_ = true;
+		std::set<std::string> Pending_;
+		bool Reload_ = false;
+
+		typedef Poco::Tuple<std::string, std::string, std::string, std::string, std::string,
+							std::string, std::string, std::string>
+			CounterColumns;
+
+		void Add(const DeviceCounters &D);
+		void Remove(const DeviceCounters &D);
+		void Set(const std::string &Id, DeviceCounters &&D);
+		void Erase(const std::string &Id);
+		void ApplyChanges();
+		static bool ReadCounters(const std::string &Where, std::vector<CounterColumns> &Rows);
+		static DeviceCounters Counters(const CounterColumns &Row);
+
+		ProvisioningDashboard() noexcept
+			: SubSystemServer("ProvisioningDashboard", "DASHBOARD", "dashboard") {}
 	};
+
+	inline auto ProvisioningDashboard() { return ProvisioningDashboard::instance(); }
 } // namespace OpenWifi
@@ -4,19 +4,36 @@
 
 #pragma once
 
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_set>
 
 #include "framework/AppServiceRegistry.h"
 #include "framework/MicroServiceNames.h"
 #include "framework/OpenAPIRequests.h"
 #include "framework/SubSystemServer.h"
+#include "framework/utils.h"
 
 #include "Poco/Timer.h"
 
+#include "fmt/format.h"
+
 namespace OpenWifi {
 
+	//	The device types known to the firmware service. Readers get an immutable snapshot that
+	//	is replaced as a whole when the list changes, so lookups never take a lock. Failed
+	//	fetches are retried sooner, backing off up to the normal refresh period.
 	class DeviceTypeCache : public SubSystemServer {
 	  public:
+		typedef std::unordered_set<std::string> DeviceTypeSet;
+		typedef std::shared_ptr<const DeviceTypeSet> DeviceTypeSetPtr;
+		//	Called with the new set each time the list of device types changes.
+		typedef std::function<void(const DeviceTypeSetPtr &)> Listener;
+
+		static constexpr uint64_t RefreshPeriod = 60 * 60;
+		static constexpr uint64_t FirstRetry = 60;
+
 		inline static auto instance() {
 			static auto instance_ = new DeviceTypeCache;
 			return instance_;
@@ -24,48 +41,71 @@ namespace OpenWifi {
 
 		inline int Start() final {
 			InitializeCache();
+			NextUpdate_ = 0;
+			Retry_ = FirstRetry;
 			TimerCallback_ = std::make_unique<Poco::TimerCallback<DeviceTypeCache>>(
 				*this, &DeviceTypeCache::onTimer);
-			Timer_.setStartInterval(60 * 1000);				// first run in 60 seconds
-			Timer_.setPeriodicInterval(1 * 60 * 60 * 1000); // 1 hours
+			Timer_.setStartInterval(60 * 1000); // first run in 60 seconds
+			Timer_.setPeriodicInterval(FirstRetry * 1000);
 			Timer_.start(*TimerCallback_);
 			return 0;
 		}
 
 		inline void Stop() final { Timer_.stop(); }
 
-		inline void onTimer([[maybe_unused]] Poco::Timer &timer) { UpdateDeviceTypes(); }
+		inline void onTimer([[maybe_unused]] Poco::Timer &timer) {
+			auto Now = Utils::Now();
+			if (Now < NextUpdate_)
+				return;
+			if (UpdateDeviceTypes()) {
+				Retry_ = FirstRetry;
+				NextUpdate_ = Now + RefreshPeriod;
+			} else {
+				NextUpdate_ = Now + Retry_;
+				Retry_ = std::min(Retry_ * 2, RefreshPeriod);
+			}
+		}
 
 		inline bool IsAcceptableDeviceType(const std::string &D) const {
-			return (DeviceTypes_.find(D) != DeviceTypes_.end());
+			return DeviceTypes()->count(D) > 0;
 		};
 		inline bool AreAcceptableDeviceTypes(const Types::StringVec &S,
 											 bool WildCardAllowed = true) const {
+			auto Known = DeviceTypes();
 			for (const auto &i : S) {
 				if (WildCardAllowed && i == "*") {
 					//   We allow wildcards
-				} else if (DeviceTypes_.find(i) == DeviceTypes_.end())
+				} else if (Known->find(i) == Known->end())
 					return false;
 			}
 			return true;
 		}
 
+		[[nodiscard]] inline DeviceTypeSetPtr DeviceTypes() const {
+			return std::atomic_load(&DeviceTypes_);
+		}
+
+		inline void AddListener(Listener L) {
+			std::lock_guard G(Mutex_);
+			Listeners_.push_back(std::move(L));
+		}
+
 	  private:
-		std::atomic_bool Initialized_ = false;
 		Poco::Timer Timer_;
-		std::set<std::string> DeviceTypes_;
+		DeviceTypeSetPtr DeviceTypes_ = std::make_shared<const DeviceTypeSet>();
+		std::vector<Listener> Listeners_;
+		uint64_t NextUpdate_ = 0;
+		uint64_t Retry_ = FirstRetry;
 		std::unique_ptr<Poco::TimerCallback<DeviceTypeCache>> TimerCallback_;
 
 		inline DeviceTypeCache() noexcept
 			: SubSystemServer("DeviceTypes", "DEV-TYPES", "devicetypes") {}
 
 		inline void InitializeCache() {
-			std::lock_guard G(Mutex_);
-
-			Initialized_ = true;
 			std::vector<std::string> DeviceTypes;
 			AppServiceRegistry().Get("deviceTypes", DeviceTypes);
-            std::for_each(DeviceTypes.begin(),DeviceTypes.end(),[&](const std::string &s){ DeviceTypes_.insert(s);});
+			Publish(std::make_shared<const DeviceTypeSet>(DeviceTypes.begin(), DeviceTypes.end()),
+					false);
 		}
 
 		inline bool UpdateDeviceTypes() {
@@ -79,17 +119,18 @@ namespace OpenWifi {
 				auto StatusCode = Req.Do(Response);
 				if (StatusCode == Poco::Net::HTTPResponse::HTTP_OK) {
 					if (Response->isArray("deviceTypes")) {
-						std::lock_guard G(Mutex_);
-						DeviceTypes_.clear();
+						auto Known = std::make_shared<DeviceTypeSet>();
 						auto Array = Response->getArray("deviceTypes");
 						for (const auto &i : *Array) {
-							// std::cout << "Adding deviceType:" << i.toString() << std::endl;
-							DeviceTypes_.insert(i.toString());
+							Known->insert(i.toString());
 						}
-						SaveCache();
+						Publish(Known, true);
 						return true;
 					}
 				} else {
+					poco_warning(Logger(),
+								 fmt::format("Could not get the device types: {}. Retrying in {}s.",
+											 (int)StatusCode, Retry_));
 				}
 			} catch (const Poco::Exception &E) {
 				Logger().log(E);
@@ -97,14 +138,28 @@ namespace OpenWifi {
 			return false;
 		}
 
-		inline void SaveCache() {
-			std::lock_guard G(Mutex_);
-            std::vector<std::string>    DeviceTypes;
-            std::for_each(DeviceTypes_.begin(),DeviceTypes_.end(),[&](const std::string &s){DeviceTypes.emplace_back(s);});
+		inline void Publish(DeviceTypeSetPtr Known, bool Save) {
+			std::vector<Listener> Listeners;
+			{
+				std::lock_guard G(Mutex_);
+				if (*Known == *DeviceTypes())
+					return;
+				std::atomic_store(&DeviceTypes_, Known);
+				Listeners = Listeners_;
+			}
+			if (Save)
+				SaveCache(*Known);
+			for (const auto &L : Listeners)
+				L(Known);
+		}
+
+		inline void SaveCache(const DeviceTypeSet &Known) {
+			std::vector<std::string> DeviceTypes(Known.begin(), Known.end());
+			std::sort(DeviceTypes.begin(), DeviceTypes.end());
 			AppServiceRegistry().Set("deviceTypes", DeviceTypes);
 		}
 	};
 
 	inline auto DeviceTypeCache() { return DeviceTypeCache::instance(); }
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
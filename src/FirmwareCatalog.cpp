@@ -0,0 +1,234 @@
+#include "FirmwareCatalog.h"
+
+#include <functional>
+
+#include "DeviceTypeCache.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+#include "sdks/SDK_fms.h"
+
+#include "fmt/format.h"
+
+namespace OpenWifi {
+
+	//	A catalog fetched less than this many seconds ago is not fetched again for a missing
+	//	revision, so asking for one that does not exist does not flood the firmware service.
+	static constexpr uint64_t RefetchInterval = 10;
+
+	int FirmwareCatalog::Start() {
+		poco_information(Logger(), "Starting...");
+		Refresh_ = MicroServiceConfigGetInt("provisioning.firmware.refresh", 300);
+		Idle_ = MicroServiceConfigGetInt("provisioning.firmware.idle", 60 * 60);
+
+		TimerCallback_ = std::make_unique<Poco::TimerCallback<FirmwareCatalog>>(
+			*this, &FirmwareCatalog::onTimer);
+		Timer_.setStartInterval(30 * 1000);
+		Timer_.setPeriodicInterval(30 * 1000);
+		Timer_.start(*TimerCallback_);
+
+		//	Catalogs of device types the firmware service no longer knows are dropped.
+		DeviceTypeCache()->AddListener([this](const DeviceTypeCache::DeviceTypeSetPtr &Known) {
+			std::lock_guard G(Mutex_);
+			for (auto i = Entries_.begin(); i != Entries_.end();) {
+				if (i->second.Current && Known->count(i->first) == 0)
+					i = Entries_.erase(i);
+				else
+					++i;
+			}
+		});
+		return 0;
+	}
+
+	void FirmwareCatalog::Stop() {
+		poco_information(Logger(), "Stopping...");
+		Timer_.stop();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	FirmwareCatalog::CatalogPtr FirmwareCatalog::Fetch(const std::string &DeviceType) {
+		auto C = std::make_shared<Catalog>();
+		if (!SDK::FMS::Firmware::GetDeviceTypeFirmwares(DeviceType, C->Firmwares))
+			return nullptr;
+
+		FMSObjects::Firmware F;
+		if (SDK::FMS::Firmware::GetLatest(DeviceType, false, F))
+			C->Latest = F;
+		if (SDK::FMS::Firmware::GetLatest(DeviceType, true, F))
+			C->LatestRC = F;
+
+		std::hash<std::string> Hash;
+		auto Mix = [&C](std::size_t V) {
+			C->Fingerprint ^= V + 0x9e3779b9 + (C->Fingerprint << 6) + (C->Fingerprint >> 2);
+		};
+		for (std::size_t i = 0; i < C->Firmwares.size(); ++i) {
+			const auto &Firmware = C->Firmwares[i];
+			C->Revisions.emplace(Firmware.revision, i);
+			Mix(Hash(Firmware.revision));
+			Mix(Hash(Firmware.uri));
+			Mix(Firmware.imageDate);
+		}
+		Mix(C->Latest ? Hash(C->Latest->revision) : 0);
+		Mix(C->LatestRC ? Hash(C->LatestRC->revision) : 0);
+		return C;
+	}
+
+	FirmwareCatalog::CatalogPtr FirmwareCatalog::Lookup(const std::string &DeviceType) {
+		std::promise<CatalogPtr> Answer;
+		{
+			std::unique_lock G(Mutex_);
+			auto &E = Entries_[DeviceType];
+			E.Used = Utils::Now();
+			if (E.Current)
+				return E.Current;
+			if (E.Pending.valid()) {
+				auto Pending = E.Pending;
+				G.unlock();
+				return Pending.get();
+			}
+			E.Pending = Answer.get_future().share();
+		}
+
+		auto C = Fetch(DeviceType);
+		{
+			std::lock_guard G(Mutex_);
+			auto &E = Entries_[DeviceType];
+			E.Pending = {};
+			if (C) {
+				E.Current = C;
+				E.Fetched = Utils::Now();
+			} else {
+				poco_warning(Logger(), fmt::format("Could not get the firmwares of {}.", DeviceType));
+				Entries_.erase(DeviceType);
+			}
+		}
+		Answer.set_value(C);
+		return C;
+	}
+
+	//	Fetches DeviceType again when Stale is still its catalog. Returns the catalog to use:
+	//	the new one, one another caller fetched meanwhile, or Stale when the fetch failed.
+	FirmwareCatalog::CatalogPtr FirmwareCatalog::Refetch(const std::string &DeviceType,
+														 const CatalogPtr &Stale) {
+		std::promise<CatalogPtr> Answer;
+		{
+			std::unique_lock G(Mutex_);
+			auto Hint = Entries_.find(DeviceType);
+			if (Hint == Entries_.end())
+				return Stale;
+			auto &E = Hint->second;
+			if (E.Pending.valid()) {
+				auto Pending = E.Pending;
+				G.unlock();
+				auto C = Pending.get();
+				return C ? C : Stale;
+			}
+			if (E.Current != Stale || Utils::Now() - E.Fetched < RefetchInterval)
+				return E.Current ? E.Current : Stale;
+			E.Pending = Answer.get_future().share();
+		}
+
+		auto C = Fetch(DeviceType);
+		{
+			std::lock_guard G(Mutex_);
+			auto Hint = Entries_.find(DeviceType);
+			if (Hint != Entries_.end()) {
+				auto &E = Hint->second;
+				E.Pending = {};
+				if (C) {
+					E.Fetched = Utils::Now();
+					//	Unchanged catalogs are kept, as in onTimer.
+					if (E.Current && E.Current->Fingerprint == C->Fingerprint)
+						C = E.Current;
+					else
+						E.Current = C;
+				}
+			}
+		}
+		if (!C)
+			poco_warning(Logger(), fmt::format("Could not refetch the firmwares of {}.", DeviceType));
+		Answer.set_value(C);
+		return C ? C : Stale;
+	}
+
+	void FirmwareCatalog::onTimer([[maybe_unused]] Poco::Timer &timer) {
+		Utils::SetThreadName("fw-catalog");
+		std::vector<std::string> Due;
+		{
+			std::lock_guard G(Mutex_);
+			auto Now = Utils::Now();
+			for (auto i = Entries_.begin(); i != Entries_.end();) {
+				auto &E = i->second;
+				if (E.Current && Now - E.Used > Idle_) {
+					i = Entries_.erase(i);
+					continue;
+				}
+				if (E.Current && Now - E.Fetched >= Refresh_)
+					Due.push_back(i->first);
+				++i;
+			}
+		}
+
+		for (const auto &DeviceType : Due) {
+			auto C = Fetch(DeviceType);
+			std::lock_guard G(Mutex_);
+			auto Hint = Entries_.find(DeviceType);
+			//	Dropped meanwhile, maybe recreated by Lookup with only its first fetch pending.
+			if (Hint == Entries_.end() || !Hint->second.Current)
+				continue;
+			if (!C) {
+				poco_warning(Logger(),
+							 fmt::format("Could not refresh the firmwares of {}. Keeping the last "
+										 "catalog.",
+										 DeviceType));
+				continue;
+			}
+			Hint->second.Fetched = Utils::Now();
+			//	Unchanged catalogs are kept, so readers holding the old one share it.
+			if (Hint->second.Current->Fingerprint != C->Fingerprint) {
+				poco_debug(Logger(), fmt::format("Firmwares of {} changed.", DeviceType));
+				Hint->second.Current = C;
+			}
+		}
+	}
+
+	bool FirmwareCatalog::GetFirmwares(const std::string &DeviceType,
+									   FMSObjects::FirmwareVec &Firmwares) {
+		auto C = Lookup(DeviceType);
+		if (!C)
+			return false;
+		Firmwares = C->Firmwares;
+		return true;
+	}
+
+	bool FirmwareCatalog::GetFirmware(const std::string &DeviceType, const std::string &Revision,
+									  FMSObjects::Firmware &Firmware) {
+		auto C = Lookup(DeviceType);
+		if (!C)
+			return false;
+		auto Hint = C->Revisions.find(Revision);
+		if (Hint == C->Revisions.end()) {
+			auto Fresh = Refetch(DeviceType, C);
+			if (Fresh == C)
+				return false;
+			C = Fresh;
+			Hint = C->Revisions.find(Revision);
+			if (Hint == C->Revisions.end())
+				return false;
+		}
+		Firmware = C->Firmwares[Hint->second];
+		return true;
+	}
+
+	bool FirmwareCatalog::GetLatest(const std::string &DeviceType, bool RCOnly,
+									FMSObjects::Firmware &Firmware) {
+		auto C = Lookup(DeviceType);
+		if (!C)
+			return false;
+		const auto &Latest = RCOnly ? C->LatestRC : C->Latest;
+		if (!Latest)
+			return false;
+		Firmware = *Latest;
+		return true;
+	}
+
+} // namespace OpenWifi
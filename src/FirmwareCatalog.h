@@ -0,0 +1,72 @@
+#pragma once
+
+#include <future>
+#include <map>
+#include <memory>
+#include <optional>
+
+#include "Poco/Timer.h"
+
+#include "RESTObjects/RESTAPI_FMSObjects.h"
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//	The firmware service catalog, per device type, indexed by revision and with the latest
+	//	release and release candidate. A device type is fetched from the firmware service the
+	//	first time it is asked for, then refreshed in the background every "refresh" seconds
+	//	while it is in use. Callers never wait for a refresh: when the firmware service is slow
+	//	or down, they keep getting the last catalog fetched. The exception is a revision missing
+	//	from the catalog, i.e. one released since the last refresh: the device type is fetched
+	//	again once, shared by all the callers missing it at the same time.
+	class FirmwareCatalog : public SubSystemServer {
+	  public:
+		static auto instance() {
+			static auto instance_ = new FirmwareCatalog;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+		void onTimer(Poco::Timer &timer);
+
+		bool GetFirmwares(const std::string &DeviceType, FMSObjects::FirmwareVec &Firmwares);
+		bool GetFirmware(const std::string &DeviceType, const std::string &Revision,
+						 FMSObjects::Firmware &Firmware);
+		bool GetLatest(const std::string &DeviceType, bool RCOnly, FMSObjects::Firmware &Firmware);
+
+	  private:
+		//	Never changed once built: a refresh builds a new one.
+		struct Catalog {
+			FMSObjects::FirmwareVec Firmwares;
+			std::map<std::string, std::size_t> Revisions;
+			std::optional<FMSObjects::Firmware> Latest, LatestRC;
+			std::size_t Fingerprint = 0;
+		};
+		typedef std::shared_ptr<const Catalog> CatalogPtr;
+
+		struct Entry {
+			CatalogPtr Current;
+			//	Set while the first fetch or a refetch is in progress, so other callers wait for it.
+			std::shared_future<CatalogPtr> Pending;
+			uint64_t Fetched = 0;
+			uint64_t Used = 0;
+		};
+
+		std::map<std::string, Entry> Entries_;
+		uint64_t Refresh_ = 300;
+		uint64_t Idle_ = 60 * 60;
+		Poco::Timer Timer_;
+		std::unique_ptr<Poco::TimerCallback<FirmwareCatalog>> TimerCallback_;
+
+		CatalogPtr Lookup(const std::string &DeviceType);
+		CatalogPtr Refetch(const std::string &DeviceType, const CatalogPtr &Stale);
+		static CatalogPtr Fetch(const std::string &DeviceType);
+
+		FirmwareCatalog() noexcept
+			: SubSystemServer("FirmwareCatalog", "FW-CATALOG", "provisioning.firmware") {}
+	};
+
+	inline auto FirmwareCatalog() { return FirmwareCatalog::instance(); }
+
+} // namespace OpenWifi
@@ -0,0 +1,237 @@
+#include "InvalidationBus.h"
+
+#include <algorithm>
+
+#include "Poco/JSON/Parser.h"
+
+#include "SerialNumberCache.h"
+#include "StorageService.h"
+#include "RadiusEndpointTypes/GlobalReach.h"
+#include "RadiusEndpointTypes/RenderCache.h"
+#include "framework/KafkaManager.h"
+#include "framework/KafkaTopics.h"
+#include "framework/MicroServiceFuncs.h"
+
+#include "fmt/format.h"
+
+namespace OpenWifi {
+
+	int InvalidationBus::Start() {
+		poco_information(Logger(), "Starting...");
+		Enabled_ = MicroServiceConfigGetBool("provisioning.invalidation.enable", false);
+		if (!Enabled_)
+			return 0;
+
+		//	A restarted replica starts a new epoch: its receivers cannot tell which of the changes
+		//	made just before the restart were sent.
+		Epoch_ = Utils::Now();
+		SubscribeCaches();
+
+		Types::TopicNotifyFunction F = [this](const std::string &Key, const std::string &Payload) {
+			this->MessageReceived(Key, Payload);
+		};
+		WatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::PROVISIONING_INVALIDATION, F);
+		ORM::ChangeFeed()->SetSink([this](const ORM::Change &C) { this->Queue(C); });
+
+		TimerCallback_ = std::make_unique<Poco::TimerCallback<InvalidationBus>>(
+			*this, &InvalidationBus::onTimer);
+		auto Period = MicroServiceConfigGetInt("provisioning.invalidation.delay", 100);
+		Timer_.setStartInterval(Period);
+		Timer_.setPeriodicInterval(Period);
+		Timer_.start(*TimerCallback_);
+		return 0;
+	}
+
+	void InvalidationBus::Stop() {
+		poco_information(Logger(), "Stopping...");
+		if (Enabled_) {
+			Timer_.stop();
+			ORM::ChangeFeed()->SetSink(nullptr);
+			Flush(false);
+			KafkaManager()->UnregisterTopicWatcher(KafkaTopics::PROVISIONING_INVALIDATION,
+												   WatcherId_);
+		}
+		poco_information(Logger(), "Stopped...");
+	}
+
+	void InvalidationBus::onTimer([[maybe_unused]] Poco::Timer &timer) {
+		Utils::SetThreadName("invalidation");
+		Flush(true);
+	}
+
+	void InvalidationBus::Queue(const ORM::Change &C) {
+		std::lock_guard G(Mutex_);
+		Pending_.push_back(C);
+	}
+
+	//	One change per table and key, keeping the latest version. Tables with too many keys, or
+	//	with a change that covers the whole table, become a single whole table change.
+	void InvalidationBus::Compact(std::vector<ORM::Change> &Changes) {
+		std::map<std::string, std::map<std::string, ORM::Change>> Tables;
+		for (auto &C : Changes) {
+			auto &Keys = Tables[C.Table];
+			auto &Last = Keys[C.Key];
+			if (Last.Table.empty() || C.Version >= Last.Version)
+				Last = std::move(C);
+		}
+		Changes.clear();
+		for (auto &[Table, Keys] : Tables) {
+			if (Keys.count("") || Keys.size() > MaxKeysPerTable) {
+				Changes.push_back(ORM::Change{Table, "", 0, ORM::Operation::Other});
+				continue;
+			}
+			for (auto &[_, C] : Keys)
+				Changes.push_back(std::move(C));
+		}
+	}
+
+	void InvalidationBus::Flush(bool Heartbeat) {
+		std::vector<ORM::Change> Changes;
+		{
+			std::lock_guard G(Mutex_);
+			Changes.swap(Pending_);
+		}
+		auto Now = Utils::Now();
+		//	Even when idle, a sequence number goes out now and then so a lost batch is noticed.
+		if (Changes.empty() && (!Heartbeat || Now - LastSent_ < HeartbeatPeriod))
+			return;
+		Compact(Changes);
+
+		Poco::JSON::Object Message;
+		Message.set("epoch", Epoch_);
+		Message.set("sequence", ++Sequence_);
+		Poco::JSON::Array Entries;
+		for (const auto &C : Changes) {
+			Poco::JSON::Object E;
+			E.set("table", C.Table);
+			E.set("key", C.Key);
+			E.set("version", C.Version);
+			E.set("op", ORM::OperationName(C.Op));
+			Entries.add(E);
+		}
+		Message.set("changes", Entries);
+		//	Keyed by sender, so the batches of one replica stay in order on the topic.
+		KafkaManager()->PostMessage(KafkaTopics::PROVISIONING_INVALIDATION,
+									std::to_string(MicroServiceID()), Message);
+		LastSent_ = Now;
+	}
+
+	void InvalidationBus::MessageReceived([[maybe_unused]] const std::string &Key,
+										  const std::string &Payload) {
+		try {
+			Poco::JSON::Parser P;
+			auto Wrapper = P.parse(Payload).extract<Poco::JSON::Object::Ptr>();
+			if (!Wrapper->has("system") || !Wrapper->has("payload"))
+				return;
+			auto System = Wrapper->getObject("system");
+			if (!System->has("id"))
+				return;
+			auto Sender = (std::uint64_t)System->get("id");
+			if (Sender == MicroServiceID())
+				return;
+
+			auto Message = Wrapper->getObject("payload");
+			auto Epoch = (std::uint64_t)Message->get("epoch");
+			auto Sequence = (std::uint64_t)Message->get("sequence");
+
+			bool Missed = false;
+			{
+				std::lock_guard G(Mutex_);
+				auto Hint = Origins_.find(Sender);
+				if (Hint == Origins_.end()) {
+					//	Nothing could have been missed from a replica never heard of before, unless
+					//	this replica was already running when it started.
+					Missed = Sequence != 1 && Utils::Now() > Epoch_ + HeartbeatPeriod;
+					Origins_[Sender] = Origin{Epoch, Sequence};
+				} else if (Hint->second.Epoch != Epoch) {
+					Missed = true;
+					Hint->second = Origin{Epoch, Sequence};
+				} else if (Sequence <= Hint->second.Sequence) {
+					//	Already seen: a redelivery.
+					return;
+				} else {
+					Missed = Sequence != Hint->second.Sequence + 1;
+					Hint->second.Sequence = Sequence;
+				}
+			}
+
+			if (Missed) {
+				poco_warning(Logger(),
+							 fmt::format("Missed changes from {} before batch {}. Reloading all caches.",
+										 System->get("host").toString(), Sequence));
+				ORM::ChangeFeed()->Resync();
+				return;
+			}
+
+			std::vector<ORM::Change> Changes;
+			for (const auto &Entry : *Message->getArray("changes")) {
+				auto E = Entry.extract<Poco::JSON::Object::Ptr>();
+				Changes.push_back(ORM::Change{E->get("table").toString(), E->get("key").toString(),
+											  (std::uint64_t)E->get("version"),
+											  ORM::Operation::Other});
+			}
+			ORM::ChangeFeed()->Deliver(Changes);
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+	}
+
+	void InvalidationBus::SubscribeCaches() {
+		auto Feed = ORM::ChangeFeed();
+		auto &Storage = *StorageService();
+
+		Feed->Subscribe(Storage.RadiusEndpointDB().TableName(),
+						[](const std::string &, const std::vector<std::string> &Keys) {
+							if (Keys.empty())
+								return RadiusEndpointRenderCache()->Invalidate();
+							for (const auto &Id : Keys)
+								RadiusEndpointRenderCache()->Invalidate(Id);
+						});
+
+		//	Rendered endpoints do not say which account they use: these are rare, drop them all.
+		auto DropRendered = [](const std::string &, const std::vector<std::string> &) {
+			RadiusEndpointRenderCache()->Invalidate();
+		};
+		Feed->Subscribe(Storage.OrionAccountsDB().TableName(), DropRendered);
+		Feed->Subscribe(Storage.GLBLRCertsDB().TableName(), DropRendered);
+		//	The signing keys are cached by GlobalReach account id, not by row id, and a deleted
+		//	row cannot be read back to find it. There are few accounts: drop all the keys.
+		Feed->Subscribe(Storage.GLBLRAccountInfoDB().TableName(),
+						[](const std::string &, const std::vector<std::string> &) {
+							RadiusEndpointRenderCache()->Invalidate();
+							OpenRoaming_GlobalReach()->InitCache();
+						});
+
+		Feed->Subscribe(
+			Storage.InventoryDB().TableName(),
+			[](const std::string &, const std::vector<std::string> &Keys) {
+				if (Keys.empty())
+					return ResyncInventory();
+				for (const auto &Id : Keys) {
+					ProvObjects::InventoryTag Device;
+					//	A deleted device only leaves its id behind: its serial number is unknown.
+					if (!StorageService()->InventoryDB().GetRecord("id", Id, Device))
+						return ResyncInventory();
+					SerialNumberCache()->AddSerialNumber(Device.serialNumber, Device.deviceType,
+														 Device.venue, Device.entity);
+				}
+			});
+	}
+
+	void InvalidationBus::ResyncInventory() {
+		std::vector<Poco::Tuple<std::string>> Rows;
+		if (!StorageService()->InventoryDB().GetColumns({"serialNumber"}, Rows))
+			return;
+		std::vector<std::uint64_t> Known;
+		Known.reserve(Rows.size());
+		for (const auto &Row : Rows)
+			Known.push_back(Utils::SerialNumberToInt(Row.get<0>()));
+		std::sort(Known.begin(), Known.end());
+		for (const auto SN : SerialNumberCache()->GetCacheCopy()) {
+			if (!std::binary_search(Known.begin(), Known.end(), SN))
+				SerialNumberCache()->DeleteSerialNumber(Utils::IntToSerialNumber(SN));
+		}
+		StorageService()->InventoryDB().InitializeSerialCache();
+	}
+
+} // namespace OpenWifi
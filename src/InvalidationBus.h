@@ -0,0 +1,69 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Poco/Timer.h"
+
+#include "framework/SubSystemServer.h"
+#include "framework/orm_events.h"
+
+namespace OpenWifi {
+
+	//	Keeps the in memory copies of provisioning objects coherent between replicas. Every write
+	//	done through the ORM becomes a (table, key, version) change, sent in small batches on the
+	//	provisioning_invalidation topic. The other replicas drop or reload the matching entries
+	//	of their caches.
+	//
+	//	Each batch carries the sequence number of its sender. A replica that sees a gap, or a
+	//	sender that restarted, cannot know what it missed and reloads every cache instead.
+	class InvalidationBus : public SubSystemServer {
+	  public:
+		static constexpr std::size_t MaxKeysPerTable = 500;
+		static constexpr std::uint64_t HeartbeatPeriod = 30;
+
+		static auto instance() {
+			static auto instance_ = new InvalidationBus;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+
+		[[nodiscard]] inline bool Enabled() const { return Enabled_; }
+
+		void onTimer(Poco::Timer &timer);
+
+	  private:
+		struct Origin {
+			std::uint64_t Epoch = 0;
+			std::uint64_t Sequence = 0;
+		};
+
+		bool Enabled_ = false;
+		std::uint64_t Epoch_ = 0;
+		std::uint64_t Sequence_ = 0;
+		std::uint64_t LastSent_ = 0;
+		std::vector<ORM::Change> Pending_;
+		std::map<std::uint64_t, Origin> Origins_;
+		Poco::Timer Timer_;
+		std::unique_ptr<Poco::TimerCallback<InvalidationBus>> TimerCallback_;
+		std::uint64_t WatcherId_ = 0;
+
+		void Queue(const ORM::Change &C);
+		void Flush(bool Heartbeat);
+		void MessageReceived(const std::string &Key, const std::string &Payload);
+		static void Compact(std::vector<ORM::Change> &Changes);
+		static void SubscribeCaches();
+		static void ResyncInventory();
+
+		InvalidationBus() noexcept
+			: SubSystemServer("InvalidationBus", "INVALIDATION", "provisioning.invalidation") {}
+	};
+
+	inline auto InvalidationBus() { return InvalidationBus::instance(); }
+
+} // namespace OpenWifi
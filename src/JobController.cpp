@@ -28,29 +28,52 @@ namespace OpenWifi {
 		}
 	}
 
+	void Job::Runner::run() {
+		Job_.run();
+		auto Waiting = Job_.Waiting();
+		Job_.running_ = false;
+		if (Waiting)
+			JobController()->wakeup();
+	}
+
 	void JobController::run() {
 		Running_ = true;
 		Utils::SetThreadName("job-controller");
+		long Wait = 2000;
 		while (Running_) {
-			Poco::Thread::trySleep(2000);
+			Poco::Thread::trySleep(Wait);
+			Wait = 2000;
 
 			std::lock_guard G(Mutex_);
 
+			auto Now = std::chrono::steady_clock::now();
 			for (auto &current_job : jobs_) {
-				if (current_job != nullptr) {
-					if (current_job->Started() == 0 && Pool_.used() < Pool_.available()) {
-						poco_information(current_job->Logger(),
-										 fmt::format("Starting {}: {}", current_job->JobId(),
-													 current_job->Name()));
-						current_job->Start();
-						Pool_.start(*current_job);
+				if (current_job == nullptr || current_job->Running())
+					continue;
+				if (current_job->Started() == 0 && current_job->When() <= Utils::Now() &&
+					Pool_.used() < Pool_.available()) {
+					poco_information(current_job->Logger(),
+									 fmt::format("Starting {}: {}", current_job->JobId(),
+												 current_job->Name()));
+					current_job->Start();
+					current_job->Launch(Pool_);
+				} else if (current_job->Completed() == 0 && current_job->Waiting()) {
+					//	A paced job waiting for the turn of its next device.
+					if (current_job->ResumeAt() <= Now && Pool_.used() < Pool_.available()) {
+						current_job->Launch(Pool_);
+					} else {
+						auto Left = std::chrono::duration_cast<std::chrono::milliseconds>(
+										current_job->ResumeAt() - Now)
+										.count();
+						Wait = std::clamp((long)Left, 10L, Wait);
 					}
 				}
 			}
 
 			for (auto it = jobs_.begin(); it != jobs_.end();) {
 				auto current_job = *it;
-				if (current_job != nullptr && current_job->Completed() != 0) {
+				if (current_job != nullptr && current_job->Completed() != 0 &&
+					!current_job->Running()) {
 					poco_information(
 						current_job->Logger(),
 						fmt::format("Completed {}: {}", current_job->JobId(), current_job->Name()));
@@ -7,8 +7,12 @@
 #include "RESTObjects/RESTAPI_SecurityObjects.h"
 #include "framework/SubSystemServer.h"
 #include "framework/utils.h"
+#include <algorithm>
+#include <chrono>
 #include <functional>
+#include <limits>
 #include <list>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -28,13 +32,94 @@ namespace OpenWifi {
 		Poco::Logger &Logger() { return Logger_; }
 		const std::string &JobId() const { return jobId_; }
 		const std::string &Parameter(int x) const { return parameters_[x]; }
+		std::size_t ParameterCount() const { return parameters_.size(); }
 		uint64_t When() const { return when_; }
-		void Start() { started_ = Utils::Now(); }
+		void Start() {
+			started_ = Utils::Now();
+			paceStart_ = std::chrono::steady_clock::now();
+		}
 		uint64_t Started() const { return started_; }
 		uint64_t Completed() const { return completed_; }
 		void Complete() { completed_ = Utils::Now(); }
 
+		//	Spreads the devices of the job over Window seconds, and at most MaxRate devices per
+		//	second (the window grows to fit). Jobs are not paced unless this is called.
+		void SetPacing(uint64_t Window, uint64_t MaxRate) {
+			window_ = Window;
+			maxRate_ = MaxRate;
+		}
+		uint64_t Window() const { return window_; }
+
+		//	Whether the Index-th of Count devices may start now: each device gets an equal slot
+		//	of the window, and starts at a random point within it. When it may not, run() should
+		//	return and pick up at the same device when the controller runs the job again, at
+		//	its turn. No pool thread sleeps through the window.
+		bool Pace(std::size_t Index, std::size_t Count) {
+			if (Count == 0 || (window_ == 0 && maxRate_ == 0))
+				return true;
+			if (Index != pacedIndex_) {
+				static thread_local std::mt19937 Gen{std::random_device{}()};
+				std::uniform_real_distribution<double> Jitter(0.0, 1.0);
+				auto Offset = Spread(Count) * ((double)Index + Jitter(Gen)) / (double)Count;
+				pacedIndex_ = Index;
+				pacedDue_ = paceStart_ + std::chrono::milliseconds((int64_t)(Offset * 1000.0));
+			}
+			if (pacedDue_ <= std::chrono::steady_clock::now())
+				return true;
+			resumeAt_ = pacedDue_;
+			waiting_ = true;
+			return false;
+		}
+
+		//	For a job waiting on something else than its pacing: run() should return, and the
+		//	controller runs the job again after Delay.
+		void ResumeIn(std::chrono::milliseconds Delay) {
+			resumeAt_ = std::chrono::steady_clock::now() + Delay;
+			waiting_ = true;
+		}
+
+		//	Starts the slot of the Index-th of Count devices now, and the following ones after
+		//	it. For a job that paused on its own, so the devices held back meanwhile are not
+		//	started in a burst to catch up.
+		void RestartPacing(std::size_t Index, std::size_t Count) {
+			if (Count == 0)
+				return;
+			auto Offset = Spread(Count) * (double)Index / (double)Count;
+			paceStart_ = std::chrono::steady_clock::now() -
+						 std::chrono::milliseconds((int64_t)(Offset * 1000.0));
+			pacedIndex_ = std::numeric_limits<std::size_t>::max();
+		}
+
+		//	Set when run() returned early to wait, until ResumeAt().
+		bool Waiting() const { return waiting_; }
+		std::chrono::steady_clock::time_point ResumeAt() const { return resumeAt_; }
+		bool Running() const { return running_; }
+
+		//	Runs the job in Pool. The controller does not touch the job again until it returns.
+		void Launch(Poco::ThreadPool &Pool) {
+			waiting_ = false;
+			running_ = true;
+			Pool.start(runner_);
+		}
+
 	  private:
+		//	The seconds Count devices are spread over.
+		double Spread(std::size_t Count) const {
+			auto Seconds = (double)window_;
+			if (maxRate_ > 0)
+				Seconds = std::max(Seconds, (double)Count / (double)maxRate_);
+			return Seconds;
+		}
+
+		class Runner : public Poco::Runnable {
+		  public:
+			explicit Runner(Job &J) : Job_(J) {}
+			void run() final;
+
+		  private:
+			Job &Job_;
+		};
+
 		std::string jobId_;
 		std::string name_;
 		std::vector<std::string> parameters_;
@@ -43,6 +128,15 @@ namespace OpenWifi {
 		Poco::Logger &Logger_;
 		uint64_t started_ = 0;
 		uint64_t completed_ = 0;
+		uint64_t window_ = 0;
+		uint64_t maxRate_ = 0;
+		std::chrono::steady_clock::time_point paceStart_ = std::chrono::steady_clock::now();
+		std::size_t pacedIndex_ = std::numeric_limits<std::size_t>::max();
+		std::chrono::steady_clock::time_point pacedDue_;
+		std::chrono::steady_clock::time_point resumeAt_;
+		bool waiting_ = false;
+		std::atomic_bool running_ = false;
+		Runner runner_{*this};
 	};
 
 	class JobController : public SubSystemServer, Poco::Runnable {
@@ -62,6 +156,13 @@ namespace OpenWifi {
 			jobs_.push_back(newJob);
 		}
 
+		//	The venue jobs that can be shared with other replicas or scheduled, by name. Returns
+		//	nullptr for an unknown name or the wrong number of parameters.
+		static Job *CreateJob(const std::string &Name, const std::string &JobId,
+							  const std::vector<std::string> &Parameters,
+							  const SecurityObjects::UserInfo &UI, Poco::Logger &L);
+		static bool KnownJob(const std::string &Name, std::size_t ParameterCount);
+
 	  private:
 		Poco::Thread Thr_;
 		std::atomic_bool Running_ = false;
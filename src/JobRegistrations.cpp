@@ -2,8 +2,40 @@
 // Created by stephane bourque on 2021-10-28.
 //
 
+#include <map>
+
+#include "JobController.h"
+#include "Tasks/VenueConfigUpdater.h"
+#include "Tasks/VenueRebooter.h"
+#include "Tasks/VenueUpgrade.h"
+
 namespace OpenWifi {
 
 	void RegisterJobTypes() {}
 
+	//	Job name -> lowest and highest number of parameters. The first parameter is always the
+	//	venue.
+	static const std::map<std::string, std::pair<std::size_t, std::size_t>> VenueJobs{
+		{"VenueConfigurationUpdater", {1, 1}},
+		{"VenueFirmwareUpgrade", {2, 3}},
+		{"VenueRebooter", {1, 1}}};
+
+	bool JobController::KnownJob(const std::string &Name, std::size_t ParameterCount) {
+		auto Hint = VenueJobs.find(Name);
+		return Hint != VenueJobs.end() && ParameterCount >= Hint->second.first &&
+			   ParameterCount <= Hint->second.second;
+	}
+
+	Job *JobController::CreateJob(const std::string &Name, const std::string &JobId,
+								  const std::vector<std::string> &Parameters,
+								  const SecurityObjects::UserInfo &UI, Poco::Logger &L) {
+		if (!KnownJob(Name, Parameters.size()))
+			return nullptr;
+		if (Name == "VenueConfigurationUpdater")
+			return new VenueConfigUpdater(JobId, Name, Parameters, 0, UI, L);
+		if (Name == "VenueFirmwareUpgrade")
+			return new VenueUpgrade(JobId, Name, Parameters, 0, UI, L);
+		return new VenueRebooter(JobId, Name, Parameters, 0, UI, L);
+	}
+
 } // namespace OpenWifi
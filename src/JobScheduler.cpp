@@ -0,0 +1,211 @@
+#include "JobScheduler.h"
+
+#include <algorithm>
+
+#include "JobController.h"
+#include "OwnershipRing.h"
+#include "StorageService.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/orm_events.h"
+#include "framework/utils.h"
+#include "libs/croncpp.h"
+
+#include "fmt/format.h"
+
+namespace OpenWifi {
+
+	//	The longest the worker sleeps, even with nothing due.
+	static constexpr uint64_t RecheckInterval = 60;
+
+	int JobScheduler::Start() {
+		poco_information(Logger(), "Starting...");
+		MaxRate_ = MicroServiceConfigGetInt("provisioning.scheduler.maxrate", 20);
+		Late_ = MicroServiceConfigGetInt("provisioning.scheduler.late", 60 * 60);
+		Load();
+
+		ORM::ChangeFeed()->Subscribe(
+			StorageService()->ScheduledJobsDB().TableName(),
+			[this](const std::string &, const std::vector<std::string> &Ids) {
+				if (Ids.empty())
+					return Load();
+				Reload(Ids);
+			});
+
+		Running_ = true;
+		Worker_.start(*this);
+		return 0;
+	}
+
+	void JobScheduler::Stop() {
+		poco_information(Logger(), "Stopping...");
+		Running_ = false;
+		Worker_.wakeUp();
+		Worker_.join();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	bool JobScheduler::NextRun(const std::string &Schedule, uint64_t After, uint64_t &Next) {
+		try {
+			auto Cron = cron::make_cron(Schedule);
+			auto When = cron::cron_next(Cron, (std::time_t)After);
+			if (When == cron::INVALID_TIME)
+				return false;
+			Next = (uint64_t)When;
+			return true;
+		} catch (const cron::bad_cronexpr &) {
+		}
+		return false;
+	}
+
+	void JobScheduler::Load() {
+		std::vector<std::pair<std::string, uint64_t>> Entries;
+		StorageService()->ScheduledJobsDB().Iterate(
+			[&](const ProvObjects::ScheduledVenueJob &J) -> bool {
+				Entries.emplace_back(J.id, J.nextRun);
+				return true;
+			});
+
+		{
+			std::lock_guard G(Mutex_);
+			Due_ = decltype(Due_){};
+			NextRun_.clear();
+		}
+		for (const auto &[Id, When] : Entries)
+			Schedule(Id, When);
+		poco_information(Logger(), fmt::format("{} scheduled jobs loaded.", Entries.size()));
+	}
+
+	void JobScheduler::Reload(const std::vector<std::string> &Ids) {
+		for (const auto &Id : Ids) {
+			ProvObjects::ScheduledVenueJob J;
+			if (StorageService()->ScheduledJobsDB().GetRecord("id", Id, J)) {
+				Schedule(J.id, J.nextRun);
+			} else {
+				std::lock_guard G(Mutex_);
+				NextRun_.erase(Id);
+			}
+		}
+	}
+
+	void JobScheduler::Schedule(const std::string &Id, uint64_t When) {
+		{
+			std::lock_guard G(Mutex_);
+			NextRun_[Id] = When;
+			Due_.emplace(When, Id);
+		}
+		Worker_.wakeUp();
+	}
+
+	bool JobScheduler::Add(ProvObjects::ScheduledVenueJob &J) {
+		if (!J.schedule.empty() && !NextRun(J.schedule, Utils::Now(), J.nextRun))
+			return false;
+
+		auto &DB = StorageService()->ScheduledJobsDB();
+		auto Done = DB.Exists("id", J.id) ? DB.UpdateRecord("id", J.id, J) : DB.CreateRecord(J);
+		if (!Done)
+			return false;
+		Schedule(J.id, J.nextRun);
+		return true;
+	}
+
+	bool JobScheduler::Remove(const std::string &Id) {
+		if (!StorageService()->ScheduledJobsDB().DeleteRecord("id", Id))
+			return false;
+		std::lock_guard G(Mutex_);
+		NextRun_.erase(Id);
+		return true;
+	}
+
+	void JobScheduler::run() {
+		Utils::SetThreadName("job-scheduler");
+		while (Running_) {
+			std::vector<std::string> Ready;
+			uint64_t Wait = RecheckInterval;
+			{
+				std::lock_guard G(Mutex_);
+				auto Now = Utils::Now();
+				while (!Due_.empty()) {
+					auto [When, Id] = Due_.top();
+					auto Hint = NextRun_.find(Id);
+					if (Hint == NextRun_.end() || Hint->second != When) {
+						Due_.pop();
+						continue;
+					}
+					if (When > Now) {
+						Wait = std::min(Wait, When - Now);
+						break;
+					}
+					Due_.pop();
+					NextRun_.erase(Hint);
+					Ready.push_back(Id);
+				}
+			}
+
+			for (const auto &Id : Ready) {
+				if (!Running_)
+					break;
+				Run(Id);
+			}
+			if (Ready.empty())
+				Poco::Thread::trySleep((long)Wait * 1000);
+		}
+	}
+
+	void JobScheduler::Run(const std::string &Id) {
+		//	The database is the reference: another replica may have run or changed it already.
+		ProvObjects::ScheduledVenueJob J;
+		auto &DB = StorageService()->ScheduledJobsDB();
+		if (!DB.GetRecord("id", Id, J))
+			return;
+
+		auto Now = Utils::Now();
+		if (J.nextRun > Now)
+			return Schedule(J.id, J.nextRun);
+
+		//	Any replica that knows the schedule may run it: a replica only learns of schedules
+		//	created elsewhere through the invalidation messages. Moving nextRun forward in the
+		//	database decides which one does.
+		auto Due = J.nextRun;
+		if (J.schedule.empty() || !NextRun(J.schedule, Now, J.nextRun))
+			J.nextRun = 0;
+		if (!DB.ClaimRun(J.id, Due, J.nextRun))
+			return;
+
+		if (Now - Due > Late_) {
+			poco_warning(Logger(), fmt::format("Scheduled job {} ({} for venue {}) is {}s late. "
+											   "Skipping this run.",
+											   J.id, J.name, J.venue, Now - Due));
+		} else {
+			Fire(J, Now);
+		}
+
+		if (J.nextRun == 0)
+			return;
+		DB.UpdateRecord("id", J.id, J);
+		Schedule(J.id, J.nextRun);
+	}
+
+	void JobScheduler::Fire(ProvObjects::ScheduledVenueJob &J, uint64_t Now) {
+		Types::StringVec Parameters{J.venue};
+		Parameters.insert(Parameters.end(), J.parameters.begin(), J.parameters.end());
+		SecurityObjects::UserInfo UI;
+		UI.id = J.userId;
+		UI.email = J.email;
+
+		auto JobId = MicroServiceCreateUUID();
+		auto NewJob = JobController::CreateJob(J.name, JobId, Parameters, UI, Logger());
+		if (NewJob == nullptr) {
+			poco_error(Logger(), fmt::format("Scheduled job {}: cannot create {} with {} parameters.",
+											 J.id, J.name, Parameters.size()));
+			return;
+		}
+		NewJob->SetPacing(J.window, MaxRate_);
+		JobController()->AddJob(NewJob);
+		OwnershipRing()->ShareJob(J.name, JobId, Parameters, UI, J.window, MaxRate_);
+		poco_information(Logger(), fmt::format("Scheduled job {}: started {} {} for venue {}.",
+											   J.id, J.name, JobId, J.venue));
+		J.lastRun = Now;
+		J.lastJobId = JobId;
+	}
+
+} // namespace OpenWifi
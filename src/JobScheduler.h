@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "RESTObjects/RESTAPI_ProvObjects.h"
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//	Runs venue jobs (config pushes, reboots, upgrades) at a later time, once or on a cron
+	//	schedule. Schedules live in ScheduledJobsDB, so they survive restarts; a run missed while
+	//	the service was down still happens when it is less than "late" seconds overdue.
+	//
+	//	Pending runs sit in a min-heap keyed on their next run time, and the worker sleeps until
+	//	the earliest one. Changing or removing a schedule does not touch the heap: the entry is
+	//	ignored when it no longer matches NextRun_.
+	//
+	//	Every replica keeps the heap, and the first one to claim a due run in the database starts
+	//	the job and shares it with the others. The devices of the job are spread over the
+	//	schedule's window, and at most maxrate devices per second per replica.
+	class JobScheduler : public SubSystemServer, Poco::Runnable {
+	  public:
+		static auto instance() {
+			static auto instance_ = new JobScheduler;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+		void run() final;
+
+		//	The first time after After matching the cron Schedule.
+		static bool NextRun(const std::string &Schedule, uint64_t After, uint64_t &Next);
+
+		//	Creates or replaces a schedule. J.nextRun is computed for cron schedules.
+		bool Add(ProvObjects::ScheduledVenueJob &J);
+		bool Remove(const std::string &Id);
+
+	  private:
+		typedef std::pair<uint64_t, std::string> DueEntry;
+
+		std::atomic_bool Running_ = false;
+		Poco::Thread Worker_;
+		std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<>> Due_;
+		std::map<std::string, uint64_t> NextRun_;
+		uint64_t MaxRate_ = 20;
+		uint64_t Late_ = 60 * 60;
+
+		void Load();
+		void Reload(const std::vector<std::string> &Ids);
+		void Schedule(const std::string &Id, uint64_t When);
+		void Run(const std::string &Id);
+		void Fire(ProvObjects::ScheduledVenueJob &J, uint64_t Now);
+
+		JobScheduler() noexcept
+			: SubSystemServer("JobScheduler", "JOB-SCHED", "provisioning.scheduler") {}
+	};
+
+	inline auto JobScheduler() { return JobScheduler::instance(); }
+
+} // namespace OpenWifi
@@ -0,0 +1,196 @@
+#include "OwnershipRing.h"
+
+#include <algorithm>
+
+#include "Poco/JSON/Parser.h"
+#include "Poco/String.h"
+
+#include "JobController.h"
+#include "StorageService.h"
+#include "framework/KafkaManager.h"
+#include "framework/KafkaTopics.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/MicroServiceNames.h"
+
+#include "fmt/format.h"
+
+namespace OpenWifi {
+
+	int OwnershipRing::Start() {
+		poco_information(Logger(), "Starting...");
+		Enabled_ = MicroServiceConfigGetBool("provisioning.partitioning.enable", false);
+		//	Without invalidation, replicas never learn of each other's writes: tags, caches and
+		//	schedules would only be right on the replica that made them.
+		if (Enabled_ && !MicroServiceConfigGetBool("provisioning.invalidation.enable", false)) {
+			poco_error(Logger(), "provisioning.partitioning.enable needs "
+								 "provisioning.invalidation.enable. Partitioning is off.");
+			Enabled_ = false;
+		}
+		VirtualNodes_ =
+			std::max((std::uint64_t)1, MicroServiceConfigGetInt("provisioning.partitioning.vnodes", 64));
+		Me_ = MicroServicePrivateEndPoint();
+		Refresh();
+		if (!Enabled_)
+			return 0;
+
+		Types::TopicNotifyFunction F = [this](const std::string &Key, const std::string &Payload) {
+			this->JobReceived(Key, Payload);
+		};
+		JobsWatcherId_ = KafkaManager()->RegisterTopicWatcher(KafkaTopics::PROVISIONING_JOBS, F);
+
+		TimerCallback_ =
+			std::make_unique<Poco::TimerCallback<OwnershipRing>>(*this, &OwnershipRing::onTimer);
+		auto Period = MicroServiceConfigGetInt("provisioning.partitioning.refresh", 5) * 1000;
+		Timer_.setStartInterval(Period);
+		Timer_.setPeriodicInterval(Period);
+		Timer_.start(*TimerCallback_);
+		return 0;
+	}
+
+	void OwnershipRing::Stop() {
+		poco_information(Logger(), "Stopping...");
+		if (Enabled_) {
+			Timer_.stop();
+			KafkaManager()->UnregisterTopicWatcher(KafkaTopics::PROVISIONING_JOBS, JobsWatcherId_);
+		}
+		poco_information(Logger(), "Stopped...");
+	}
+
+	void OwnershipRing::onTimer([[maybe_unused]] Poco::Timer &timer) {
+		Utils::SetThreadName("ownership");
+		Refresh();
+	}
+
+	//	FNV-1a followed by a 64 bit finalizer: the same on every replica and build, and serial
+	//	numbers that only differ by their last digits still spread over the whole ring.
+	std::uint64_t OwnershipRing::Hash(const std::string &S) {
+		std::uint64_t H = 0xcbf29ce484222325ULL;
+		for (auto C : S) {
+			H ^= (unsigned char)C;
+			H *= 0x100000001b3ULL;
+		}
+		H ^= H >> 33;
+		H *= 0xff51afd7ed558ccdULL;
+		H ^= H >> 33;
+		H *= 0xc4ceb9fe1a85ec53ULL;
+		H ^= H >> 33;
+		return H;
+	}
+
+	void OwnershipRing::Refresh() {
+		std::vector<std::string> Members{Me_};
+		if (Enabled_) {
+			for (const auto &Service : *MicroServiceGetServiceList(uSERVICE_PROVISIONING))
+				Members.push_back(Service.PrivateEndPoint);
+		}
+		std::sort(Members.begin(), Members.end());
+		Members.erase(std::unique(Members.begin(), Members.end()), Members.end());
+
+		std::lock_guard G(Mutex_);
+		if (Members == Members_)
+			return;
+
+		std::vector<Point> Ring;
+		Ring.reserve(Members.size() * VirtualNodes_);
+		for (std::uint32_t M = 0; M < Members.size(); ++M) {
+			for (std::uint64_t V = 0; V < VirtualNodes_; ++V)
+				Ring.push_back(Point{Hash(fmt::format("{}#{}", Members[M], V)), M});
+		}
+		std::sort(Ring.begin(), Ring.end());
+
+		poco_information(Logger(), fmt::format("Ownership ring rebalanced: {} -> {} replicas.",
+											   Members_.size(), Members.size()));
+		Members_.swap(Members);
+		Ring_.swap(Ring);
+	}
+
+	const std::string &OwnershipRing::OwnerOf(const std::string &SerialNumber) {
+		auto H = Hash(Poco::toLower(SerialNumber));
+		auto It = std::lower_bound(Ring_.begin(), Ring_.end(), Point{H, 0});
+		if (It == Ring_.end())
+			It = Ring_.begin();
+		return Members_[It->Member];
+	}
+
+	bool OwnershipRing::Owns(const std::string &SerialNumber) {
+		if (!Enabled_)
+			return true;
+		std::lock_guard G(Mutex_);
+		return Ring_.empty() || OwnerOf(SerialNumber) == Me_;
+	}
+
+	void OwnershipRing::OwnedVenueDevices(const std::string &Venue,
+										  std::vector<std::string> &DeviceIds) {
+		if (!Enabled_) {
+			StorageService()->InventoryDB().GetDevicesUUIDForVenue(Venue, DeviceIds);
+			return;
+		}
+		std::vector<std::pair<std::string, std::string>> Devices;
+		StorageService()->InventoryDB().GetDeviceIdsAndSerialsForVenue(Venue, Devices);
+		std::lock_guard G(Mutex_);
+		for (const auto &[Id, SerialNumber] : Devices) {
+			if (Ring_.empty() || OwnerOf(SerialNumber) == Me_)
+				DeviceIds.push_back(Id);
+		}
+	}
+
+	void OwnershipRing::ShareJob(const std::string &Name, const std::string &JobId,
+								 const std::vector<std::string> &Parameters,
+								 const SecurityObjects::UserInfo &UI, uint64_t Window,
+								 uint64_t MaxRate) {
+		if (!Enabled_)
+			return;
+		Poco::JSON::Object Message;
+		Message.set("name", Name);
+		Message.set("jobId", JobId);
+		Poco::JSON::Array Params;
+		for (const auto &P : Parameters)
+			Params.add(P);
+		Message.set("parameters", Params);
+		//	Only what the jobs use to notify the requester.
+		Message.set("userId", UI.id);
+		Message.set("email", UI.email);
+		if (Window > 0 || MaxRate > 0) {
+			Message.set("window", Window);
+			Message.set("maxRate", MaxRate);
+		}
+		KafkaManager()->PostMessage(KafkaTopics::PROVISIONING_JOBS, JobId, Message);
+	}
+
+	void OwnershipRing::JobReceived([[maybe_unused]] const std::string &Key,
+									const std::string &Payload) {
+		try {
+			Poco::JSON::Parser P;
+			auto Wrapper = P.parse(Payload).extract<Poco::JSON::Object::Ptr>();
+			if (!Wrapper->has("system") || !Wrapper->has("payload"))
+				return;
+			//	The replica that accepted the request already runs its own slice.
+			auto System = Wrapper->getObject("system");
+			if (System->has("id") && (std::uint64_t)System->get("id") == MicroServiceID())
+				return;
+
+			auto Message = Wrapper->getObject("payload");
+			auto Name = Message->get("name").toString();
+			auto JobId = Message->get("jobId").toString();
+			std::vector<std::string> Parameters;
+			for (const auto &Param : *Message->getArray("parameters"))
+				Parameters.push_back(Param.toString());
+			SecurityObjects::UserInfo UI;
+			UI.id = Message->get("userId").toString();
+			UI.email = Message->get("email").toString();
+
+			auto NewJob = JobController::CreateJob(Name, JobId, Parameters, UI, Logger());
+			if (NewJob == nullptr) {
+				poco_warning(Logger(), fmt::format("Ignoring unknown shared job {}.", Name));
+				return;
+			}
+			if (Message->has("window"))
+				NewJob->SetPacing((uint64_t)Message->get("window"), (uint64_t)Message->get("maxRate"));
+			poco_information(Logger(), fmt::format("Running job {} ({}) on local devices.", JobId, Name));
+			JobController()->AddJob(NewJob);
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+	}
+
+} // namespace OpenWifi
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Poco/Timer.h"
+
+#include "RESTObjects/RESTAPI_SecurityObjects.h"
+#include "framework/SubSystemServer.h"
+
+namespace OpenWifi {
+
+	//	Splits devices between the provisioning replicas. Every replica builds the same consistent
+	//	hash ring from the owprov instances known on the service bus, and only handles the devices
+	//	whose serial number lands on its own points. When a replica joins or leaves, only the
+	//	devices next to its points move.
+	//
+	//	Venue jobs are shared on the provisioning_jobs topic so every replica runs the job on its
+	//	own slice. Discovery filtering needs each replica to see every connection message, i.e.
+	//	each replica must use its own openwifi.kafka.group.id.
+	class OwnershipRing : public SubSystemServer {
+	  public:
+		static auto instance() {
+			static auto instance_ = new OwnershipRing;
+			return instance_;
+		}
+
+		int Start() override;
+		void Stop() override;
+
+		[[nodiscard]] inline bool Enabled() const { return Enabled_; }
+		bool Owns(const std::string &SerialNumber);
+		//	Ids of the venue devices this replica owns (all of them when partitioning is off).
+		void OwnedVenueDevices(const std::string &Venue, std::vector<std::string> &DeviceIds);
+		//	Asks the other replicas to run the same venue job on their own devices, paced the
+		//	same way when Window or MaxRate are set.
+		void ShareJob(const std::string &Name, const std::string &JobId,
+					  const std::vector<std::string> &Parameters,
+					  const SecurityObjects::UserInfo &UI, uint64_t Window = 0,
+					  uint64_t MaxRate = 0);
+
+		void onTimer(Poco::Timer &timer);
+
+	  private:
+		struct Point {
+			std::uint64_t Hash;
+			std::uint32_t Member;
+			bool operator<(const Point &P) const {
+				return Hash < P.Hash || (Hash == P.Hash && Member < P.Member);
+			}
+		};
+
+		bool Enabled_ = false;
+		std::uint64_t VirtualNodes_ = 64;
+		std::string Me_;
+		std::vector<std::string> Members_;
+		std::vector<Point> Ring_;
+		Poco::Timer Timer_;
+		std::unique_ptr<Poco::TimerCallback<OwnershipRing>> TimerCallback_;
+		std::uint64_t JobsWatcherId_ = 0;
+
+		static std::uint64_t Hash(const std::string &S);
+		void Refresh();
+		const std::string &OwnerOf(const std::string &SerialNumber);
+		void JobReceived(const std::string &Key, const std::string &Payload);
+
+		OwnershipRing() noexcept
+			: SubSystemServer("OwnershipRing", "OWNERSHIP", "provisioning.partitioning") {}
+	};
+
+	inline auto OwnershipRing() { return OwnershipRing::instance(); }
+
+} // namespace OpenWifi
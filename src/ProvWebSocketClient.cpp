@@ -25,14 +25,34 @@ namespace OpenWifi {
 		auto Prefix = ORM::Escape(O->get("serial_prefix").toString());
 		Poco::toLowerInPlace(Prefix);
 		Logger().information(Poco::format("serial_number_search: %s", Prefix));
-		if (!Prefix.empty() && Prefix.length() < 13) {
+		if (!Prefix.empty() && Prefix.length() < 15) {
+			SerialNumberCache::SearchFilter Filter;
+			OpenWifi::RESTAPIHandler::AssignIfPresent(O, "deviceType", Filter.DeviceType);
+			OpenWifi::RESTAPIHandler::AssignIfPresent(O, "venue", Filter.Venue);
+			OpenWifi::RESTAPIHandler::AssignIfPresent(O, "entity", Filter.Entity);
+			std::string After, Continuation;
+			OpenWifi::RESTAPIHandler::AssignIfPresent(O, "continuation", After);
+			uint64_t Limit = 50;
+			if (O->has("limit")) {
+				auto L = O->get("limit");
+				Poco::Int64 Value = 0;
+				if (!L.isInteger() || (Value = L.convert<Poco::Int64>()) < 1) {
+					Answer = R"lit({ "error" : "limit must be a positive integer" })lit";
+					return;
+				}
+				Limit = std::min<uint64_t>((uint64_t)Value, 500);
+			}
+
 			std::vector<uint64_t> Numbers;
-			SerialNumberCache()->FindNumbers(Prefix, 50, Numbers);
+			SerialNumberCache()->Search(Prefix, Filter, Limit, Poco::toLower(After), Numbers,
+										Continuation);
 			Poco::JSON::Array Arr;
 			for (const auto &i : Numbers)
 				Arr.add(Utils::int_to_hex(i));
 			Poco::JSON::Object RetObj;
 			RetObj.set("serialNumbers", Arr);
+			if (!Continuation.empty())
+				RetObj.set("continuation", Continuation);
 			std::ostringstream SS;
 			Poco::JSON::Stringifier::stringify(RetObj, SS);
 			Answer = SS.str();
@@ -0,0 +1,13 @@
+#include "RESTAPI_dashboard_handler.h"
+#include "Dashboard.h"
+
+namespace OpenWifi {
+
+	void RESTAPI_dashboard_handler::DoGet() {
+		auto Report = ProvisioningDashboard()->Report();
+		Poco::JSON::Object Answer;
+		Report->to_json(Answer);
+		return ReturnObject(Answer);
+	}
+
+} // namespace OpenWifi
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "DeviceTypeCache.h"
 #include "Poco/StringTokenizer.h"
 #include "RESTObjects/RESTAPI_ProvObjects.h"
 #include "StorageService.h"
@@ -149,6 +150,17 @@ namespace OpenWifi {
 
 	template <typename T>
 	void MakeJSONObjectArray(const char *ArrayName, const std::vector<T> &V, RESTAPIHandler &R) {
+		if constexpr (RESTAPI_utils::has_json_writer<T>::value) {
+			//	Extended info still needs the Poco objects, everything else is written directly.
+			if (!R.NeedAdditionalInfo()) {
+				std::string Out;
+				JSONWriter W(Out, 64 + V.size() * 1024);
+				W.StartObject();
+				RESTAPI_utils::field_to_json(W, ArrayName, V);
+				W.EndObject();
+				return R.ReturnRawJSON(Out);
+			}
+		}
 		Poco::JSON::Array ObjArray;
 		for (const auto &i : V) {
 			Poco::JSON::Object Obj;
@@ -736,4 +748,62 @@ namespace OpenWifi {
 		RESTAPI_utils::field_to_json(Answer, "list", Fields);
 		return H.ReturnObject(Answer);
 	}
+
+	//	The checks a new inventory device goes through, shared by single and bulk creation. Also
+	//	fills in the object info from RawObject. Exists(DB, Id) tells whether a parent object
+	//	exists, so bulk callers can look each parent up once. Returns false with the reason in
+	//	Error.
+	template <typename ExistsFunc>
+	bool ValidateNewInventoryTag(const Poco::JSON::Object::Ptr &RawObject,
+								 const SecurityObjects::UserInfo &UI,
+								 ProvObjects::InventoryTag &NewObject, ExistsFunc &&Exists,
+								 RESTAPI::Errors::msg &Error) {
+		auto Fail = [&Error](const RESTAPI::Errors::msg &E) {
+			Error = E;
+			return false;
+		};
+
+		if (RawObject->has("deviceRules") && !ValidDeviceRules(NewObject.deviceRules))
+			return Fail(RESTAPI::Errors::InvalidRRM);
+
+		if (!Provisioning::DeviceClass::Validate(NewObject.devClass.c_str()))
+			return Fail(RESTAPI::Errors::InvalidDeviceClass);
+
+		if (NewObject.devClass.empty())
+			NewObject.devClass = Provisioning::DeviceClass::ANY;
+
+		if (!ProvObjects::CreateObjectInfo(RawObject, UI, NewObject.info))
+			return Fail(RESTAPI::Errors::NameMustBeSet);
+
+		if (NewObject.deviceType.empty() ||
+			!DeviceTypeCache()->IsAcceptableDeviceType(NewObject.deviceType))
+			return Fail(RESTAPI::Errors::InvalidDeviceTypes);
+
+		if (OpenWifi::EntityDB::IsRoot(NewObject.entity) ||
+			(!NewObject.entity.empty() && !Exists(StorageService()->EntityDB(), NewObject.entity)))
+			return Fail(RESTAPI::Errors::ValidNonRootUUID);
+
+		if (!NewObject.venue.empty() && !Exists(StorageService()->VenueDB(), NewObject.venue))
+			return Fail(RESTAPI::Errors::VenueMustExist);
+
+		if (!NewObject.venue.empty() && !NewObject.entity.empty())
+			return Fail(RESTAPI::Errors::NotBoth);
+
+		if (!NewObject.location.empty() &&
+			!Exists(StorageService()->LocationDB(), NewObject.location))
+			return Fail(RESTAPI::Errors::LocationMustExist);
+
+		if (!NewObject.contact.empty() && !Exists(StorageService()->ContactDB(), NewObject.contact))
+			return Fail(RESTAPI::Errors::ContactMustExist);
+
+		if (!NewObject.deviceConfiguration.empty() &&
+			!Exists(StorageService()->ConfigurationDB(), NewObject.deviceConfiguration))
+			return Fail(RESTAPI::Errors::ConfigurationMustExist);
+
+		if (!NewObject.managementPolicy.empty() &&
+			!Exists(StorageService()->PolicyDB(), NewObject.managementPolicy))
+			return Fail(RESTAPI::Errors::UnknownManagementPolicyUUID);
+
+		return true;
+	}
 } // namespace OpenWifi
@@ -199,60 +199,11 @@ namespace OpenWifi {
 			return BadRequest(RESTAPI::Errors::SerialNumberMismatch);
 		}
 
-		if ((RawObject->has("deviceRules") && !ValidDeviceRules(NewObject.deviceRules, *this))) {
-			return;
-		}
-
-		if (!Provisioning::DeviceClass::Validate(NewObject.devClass.c_str())) {
-			return BadRequest(RESTAPI::Errors::InvalidDeviceClass);
-		}
-
-		if (NewObject.devClass.empty()) {
-			NewObject.devClass = Provisioning::DeviceClass::ANY;
-		}
-
-		if (!ProvObjects::CreateObjectInfo(RawObject, UserInfo_.userinfo, NewObject.info)) {
-			return BadRequest(RESTAPI::Errors::NameMustBeSet);
-		}
-
-		if (NewObject.deviceType.empty() ||
-			!DeviceTypeCache()->IsAcceptableDeviceType(NewObject.deviceType)) {
-			return BadRequest(RESTAPI::Errors::InvalidDeviceTypes);
-		}
-
-		if (OpenWifi::EntityDB::IsRoot(NewObject.entity) ||
-			(!NewObject.entity.empty() &&
-			 !StorageService()->EntityDB().Exists("id", NewObject.entity))) {
-			return BadRequest(RESTAPI::Errors::ValidNonRootUUID);
-		}
-
-		if (!NewObject.venue.empty() &&
-			!StorageService()->VenueDB().Exists("id", NewObject.venue)) {
-			return BadRequest(RESTAPI::Errors::VenueMustExist);
-		}
-
-		if (!NewObject.venue.empty() && !NewObject.entity.empty()) {
-			return BadRequest(RESTAPI::Errors::NotBoth);
-		}
-
-		if (!NewObject.location.empty() &&
-			!StorageService()->LocationDB().Exists("id", NewObject.location)) {
-			return BadRequest(RESTAPI::Errors::LocationMustExist);
-		}
-
-		if (!NewObject.contact.empty() &&
-			!StorageService()->ContactDB().Exists("id", NewObject.contact)) {
-			return BadRequest(RESTAPI::Errors::ContactMustExist);
-		}
-
-		if (!NewObject.deviceConfiguration.empty() &&
-			!StorageService()->ConfigurationDB().Exists("id", NewObject.deviceConfiguration)) {
-			return BadRequest(RESTAPI::Errors::ConfigurationMustExist);
-		}
-
-		if (!NewObject.managementPolicy.empty() &&
-			!StorageService()->PolicyDB().Exists("id", NewObject.managementPolicy)) {
-			return BadRequest(RESTAPI::Errors::UnknownManagementPolicyUUID);
+		auto Error = RESTAPI::Errors::SUCCESS;
+		if (!ValidateNewInventoryTag(
+				RawObject, UserInfo_.userinfo, NewObject,
+				[](auto &DB, const std::string &Id) { return DB.Exists("id", Id); }, Error)) {
+			return BadRequest(Error);
 		}
 
 		std::vector<std::string> Errors;
@@ -264,7 +215,8 @@ namespace OpenWifi {
 		if (DB_.CreateRecord(NewObject)) {
 			SDK::GW::Device::SetOwnerShip(this, SerialNumber, NewObject.entity, NewObject.venue,
 										  NewObject.subscriber);
-			SerialNumberCache()->AddSerialNumber(SerialNumber, NewObject.deviceType);
+			SerialNumberCache()->AddSerialNumber(SerialNumber, NewObject.deviceType,
+												 NewObject.venue, NewObject.entity);
 			MoveUsage(StorageService()->PolicyDB(), DB_, "", NewObject.managementPolicy,
 					  NewObject.info.id);
 			MoveUsage(StorageService()->LocationDB(), DB_, "", NewObject.location,
@@ -457,6 +409,8 @@ namespace OpenWifi {
 
 			SDK::GW::Device::SetOwnerShip(this, SerialNumber, Existing.entity, Existing.venue,
 										  Existing.subscriber);
+			SerialNumberCache()->AddSerialNumber(Existing.serialNumber, Existing.deviceType,
+												 Existing.venue, Existing.entity);
 
 			// Attempt an automatic config push when the venue is set and different than what is
 			// in DB.
@@ -7,8 +7,12 @@
 //
 
 #include "RESTAPI_inventory_list_handler.h"
+#include "DeviceTypeCache.h"
 #include "RESTAPI/RESTAPI_db_helpers.h"
+#include "SerialNumberCache.h"
 #include "StorageService.h"
+#include "Tasks/InventoryImport.h"
+#include "framework/MicroServiceFuncs.h"
 
 namespace OpenWifi {
 	void RESTAPI_inventory_list_handler::SendList(const ProvObjects::InventoryTagVec &Tags,
@@ -33,6 +37,19 @@ namespace OpenWifi {
 		ReturnObject(Answer);
 	}
 
+	//	serialOnly lists only need one column: skip reading and decoding the whole record.
+	void RESTAPI_inventory_list_handler::SendSerialNumbers(const std::string &Where,
+														   const std::string &OrderBy) {
+		std::vector<Poco::Tuple<std::string>> Rows;
+		DB_.GetColumns({"serialNumber"}, Rows, Where, OrderBy, QB_.Offset, QB_.Limit);
+		Poco::JSON::Array Array;
+		for (const auto &Row : Rows)
+			Array.add(Row.get<0>());
+		Poco::JSON::Object Answer;
+		Answer.set("serialNumbers", Array);
+		ReturnObject(Answer);
+	}
+
 	void RESTAPI_inventory_list_handler::DoGet() {
 
 		if (GetBoolParameter("orderSpec")) {
@@ -58,6 +75,8 @@ namespace OpenWifi {
 				auto C = DB_.Count(StorageService()->InventoryDB().OP("entity", ORM::EQ, UUID));
 				return ReturnCountOnly(C);
 			}
+			if (SerialOnly)
+				return SendSerialNumbers(DB_.OP("entity", ORM::EQ, UUID), OrderBy);
 			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags, DB_.OP("entity", ORM::EQ, UUID), OrderBy);
 			return SendList(Tags, SerialOnly);
@@ -66,6 +85,8 @@ namespace OpenWifi {
 				auto C = DB_.Count(DB_.OP("venue", ORM::EQ, UUID));
 				return ReturnCountOnly(C);
 			}
+			if (SerialOnly)
+				return SendSerialNumbers(DB_.OP("venue", ORM::EQ, UUID), OrderBy);
 			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags, DB_.OP("venue", ORM::EQ, UUID), OrderBy);
 			return SendList(Tags, SerialOnly);
@@ -74,6 +95,8 @@ namespace OpenWifi {
 				auto C = DB_.Count(" devClass='subscriber' and subscriber='' ");
 				return ReturnCountOnly(C);
 			}
+			if (SerialOnly)
+				return SendSerialNumbers(" devClass='subscriber' and subscriber='' ", OrderBy);
 			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags, " devClass='subscriber' and subscriber='' ",
 						   OrderBy);
@@ -87,6 +110,8 @@ namespace OpenWifi {
 				auto C = DB_.Count(" devClass='subscriber' and subscriber!='' ");
 				return ReturnCountOnly(C);
 			}
+			if (SerialOnly)
+				return SendSerialNumbers(" devClass='subscriber' and subscriber!='' ", OrderBy);
 			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags,
 						   " devClass='subscriber' and subscriber!='' ", OrderBy);
@@ -98,8 +123,12 @@ namespace OpenWifi {
 												   DB_.OP("entity", ORM::EQ, Empty)));
 				return ReturnCountOnly(C);
 			}
-			ProvObjects::InventoryTagVec Tags;
 			std::string Empty;
+			if (SerialOnly)
+				return SendSerialNumbers(InventoryDB::OP(DB_.OP("venue", ORM::EQ, Empty), ORM::AND,
+														 DB_.OP("entity", ORM::EQ, Empty)),
+										 OrderBy);
+			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags,
 						   InventoryDB::OP(DB_.OP("venue", ORM::EQ, Empty), ORM::AND,
 										   DB_.OP("entity", ORM::EQ, Empty)),
@@ -129,6 +158,8 @@ namespace OpenWifi {
 				return ReturnObject("serialNumbers", DeviceList);
 			}
 		} else {
+			if (SerialOnly)
+				return SendSerialNumbers("", OrderBy);
 			ProvObjects::InventoryTagVec Tags;
 			DB_.GetRecords(QB_.Offset, QB_.Limit, Tags, "", OrderBy);
             return SendList(Tags, SerialOnly);
@@ -136,4 +167,178 @@ namespace OpenWifi {
 //			return MakeJSONObjectArray("taglist", Tags, *this);
 		}
 	}
-} // namespace OpenWifi
\ No newline at end of file
+
+	static constexpr std::size_t MaxImportDevices = 50000;
+
+	//	Splits one CSV line, honouring double quoted fields.
+	static std::vector<std::string> SplitCSVLine(const std::string &Line) {
+		std::vector<std::string> Fields(1);
+		bool Quoted = false;
+		for (std::size_t i = 0; i < Line.size(); ++i) {
+			auto c = Line[i];
+			if (Quoted) {
+				if (c == '"' && i + 1 < Line.size() && Line[i + 1] == '"') {
+					Fields.back() += '"';
+					++i;
+				} else if (c == '"') {
+					Quoted = false;
+				} else {
+					Fields.back() += c;
+				}
+			} else if (c == '"') {
+				Quoted = true;
+			} else if (c == ',') {
+				Fields.emplace_back();
+			} else if (c != '\r') {
+				Fields.back() += c;
+			}
+		}
+		for (auto &Field : Fields)
+			Poco::trimInPlace(Field);
+		return Fields;
+	}
+
+	//	Each CSV row becomes the JSON document the same device would have in a JSON import.
+	bool RESTAPI_inventory_list_handler::ReadImportCSV(std::vector<Poco::JSON::Object::Ptr> &Rows) {
+		static const std::map<std::string, std::string> Columns{
+			{"serialnumber", "serialNumber"},
+			{"name", "name"},
+			{"description", "description"},
+			{"devicetype", "deviceType"},
+			{"venue", "venue"},
+			{"entity", "entity"},
+			{"subscriber", "subscriber"},
+			{"devclass", "devClass"},
+			{"location", "location"},
+			{"contact", "contact"},
+			{"managementpolicy", "managementPolicy"},
+			{"deviceconfiguration", "deviceConfiguration"},
+			{"qrcode", "qrCode"},
+			{"geocode", "geoCode"},
+			{"locale", "locale"},
+			{"realmacaddress", "realMacAddress"}};
+
+		std::string Line;
+		if (!std::getline(Request->stream(), Line))
+			return false;
+		//	Unknown columns are kept as empty names and ignored.
+		std::vector<std::string> Header;
+		bool HasSerialNumber = false;
+		for (auto &Name : SplitCSVLine(Line)) {
+			Poco::toLowerInPlace(Name);
+			auto Hint = Columns.find(Name);
+			Header.emplace_back(Hint == Columns.end() ? "" : Hint->second);
+			HasSerialNumber |= Name == "serialnumber";
+		}
+		if (!HasSerialNumber)
+			return false;
+
+		while (std::getline(Request->stream(), Line) && Rows.size() <= MaxImportDevices) {
+			if (Line.empty() || Line == "\r")
+				continue;
+			auto Fields = SplitCSVLine(Line);
+			Poco::JSON::Object::Ptr Row = new Poco::JSON::Object;
+			for (std::size_t i = 0; i < Fields.size() && i < Header.size(); ++i) {
+				if (!Header[i].empty())
+					Row->set(Header[i], Fields[i]);
+			}
+			Rows.emplace_back(std::move(Row));
+		}
+		return true;
+	}
+
+	void RESTAPI_inventory_list_handler::DoPost() {
+		std::vector<Poco::JSON::Object::Ptr> Rows;
+		if (Request->getContentType().find("text/csv") != std::string::npos) {
+			if (!ReadImportCSV(Rows))
+				return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters);
+		} else {
+			if (ParsedBody_.isNull() || !ParsedBody_->isArray("devices"))
+				return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+			auto DeviceArray = ParsedBody_->getArray("devices");
+			Rows.reserve(DeviceArray->size());
+			for (const auto &i : *DeviceArray) {
+				if (!i.isStruct())
+					return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+				Rows.emplace_back(i.extract<Poco::JSON::Object::Ptr>());
+			}
+		}
+
+		if (Rows.empty() || Rows.size() > MaxImportDevices)
+			return BadRequest(RESTAPI::Errors::MissingOrInvalidParameters);
+
+		//	Every row goes through the same checks as a single device creation. Validation only
+		//	touches the in-memory caches, except for parent objects, which are looked up once per
+		//	distinct UUID no matter how many devices refer to them.
+		std::map<std::string, bool> Known;
+		auto Exists = [&Known](auto &DB, const std::string &Id) {
+			auto Key = DB.Prefix() + ":" + Id;
+			auto Hint = Known.find(Key);
+			if (Hint != Known.end())
+				return Hint->second;
+			return Known[Key] = DB.Exists("id", Id);
+		};
+
+		Poco::JSON::Array Rejected;
+		auto Reject = [&Rejected](const std::string &SerialNumber, const RESTAPI::Errors::msg &E) {
+			Poco::JSON::Object O;
+			O.set("serialNumber", SerialNumber);
+			O.set("ErrorCode", E.err_num);
+			O.set("ErrorDescription", E.err_txt);
+			Rejected.add(O);
+		};
+
+		std::set<std::string> SeenSerialNumbers;
+		ProvObjects::InventoryTagVec Accepted;
+		Accepted.reserve(Rows.size());
+		for (auto &RawObject : Rows) {
+			ProvObjects::InventoryTag Device;
+			if (!Device.from_json(RawObject)) {
+				Reject(RawObject->optValue<std::string>("serialNumber", ""),
+					   RESTAPI::Errors::InvalidJSONDocument);
+				continue;
+			}
+			auto SerialNumber = Device.serialNumber;
+			Poco::toLowerInPlace(Device.serialNumber);
+			if (Device.serialNumber.empty() || !NormalizeMac(Device.serialNumber)) {
+				Reject(SerialNumber, RESTAPI::Errors::InvalidSerialNumber);
+				continue;
+			}
+			if (!SeenSerialNumbers.insert(Device.serialNumber).second ||
+				SerialNumberCache()->NumberExists(Utils::SerialNumberToInt(Device.serialNumber))) {
+				Reject(SerialNumber, RESTAPI::Errors::SerialNumberExists);
+				continue;
+			}
+			//	Imported devices without a name are named after their serial number.
+			if (RawObject->optValue<std::string>("name", "").empty())
+				RawObject->set("name", Device.serialNumber);
+
+			auto Error = RESTAPI::Errors::SUCCESS;
+			if (!ValidateNewInventoryTag(RawObject, UserInfo_.userinfo, Device, Exists, Error)) {
+				Reject(SerialNumber, Error);
+				continue;
+			}
+
+			std::vector<std::string> Errors;
+			CreateObjects(Device, *this, Errors);
+			if (!Errors.empty()) {
+				Reject(SerialNumber, RESTAPI::Errors::ConfigBlockInvalid);
+				continue;
+			}
+			Accepted.emplace_back(std::move(Device));
+		}
+
+		Poco::JSON::Object Answer;
+		Answer.set("accepted", Accepted.size());
+		Answer.set("rejected", Rejected);
+		if (!Accepted.empty()) {
+			auto JobId = MicroServiceCreateUUID();
+			Types::StringVec Parameters{std::to_string(Accepted.size())};
+			auto NewJob = new InventoryImport(JobId, "InventoryImport", Parameters, 0,
+											  UserInfo_.userinfo, Logger(), std::move(Accepted));
+			JobController()->AddJob(dynamic_cast<Job *>(NewJob));
+			Answer.set("jobId", JobId);
+		}
+		ReturnObject(Answer);
+	}
+} // namespace OpenWifi
@@ -19,6 +19,7 @@ namespace OpenWifi {
 									   uint64_t TransactionId, bool Internal)
 			: RESTAPIHandler(bindings, L,
 							 std::vector<std::string>{Poco::Net::HTTPRequest::HTTP_GET,
+													  Poco::Net::HTTPRequest::HTTP_POST,
 													  Poco::Net::HTTPRequest::HTTP_OPTIONS},
 							 Server, TransactionId, Internal) {}
 		static auto PathName() { return std::list<std::string>{"/api/v1/inventory"}; };
@@ -26,10 +27,12 @@ namespace OpenWifi {
 	  private:
 		InventoryDB &DB_ = StorageService()->InventoryDB();
 		void DoGet() final;
-		void DoPost() final{};
+		void DoPost() final;
 		void DoPut() final{};
 		void DoDelete() final{};
 
 		void SendList(const ProvObjects::InventoryTagVec &Tags, bool SerialOnly);
+		void SendSerialNumbers(const std::string &Where, const std::string &OrderBy);
+		bool ReadImportCSV(std::vector<Poco::JSON::Object::Ptr> &Rows);
 	};
 } // namespace OpenWifi
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "RESTAPI_openroaming_gr_acct_handler.h"
 #include <RadiusEndpointTypes/GlobalReach.h>
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 
@@ -33,6 +34,8 @@ namespace OpenWifi {
 
         StorageService()->GLBLRCertsDB().DeleteRecords(fmt::format(" accountId='{}' ", Account));
         DB_.DeleteRecord("id", Account);
+        OpenRoaming_GlobalReach()->RemoveAccount(Record.GlobalReachAcctId);
+        RadiusEndpointRenderCache()->Invalidate();
 
         return OK();
     }
@@ -115,6 +118,7 @@ namespace OpenWifi {
         }
 
         if(DB_.UpdateRecord("id",Existing.info.id,Existing)) {
+            RadiusEndpointRenderCache()->Invalidate();
             RecordType StoredObject;
             DB_.GetRecord("id",Existing.info.id,StoredObject);
             return ReturnObject(StoredObject);
@@ -4,6 +4,7 @@
 
 #include "RESTAPI_openroaming_gr_cert_handler.h"
 #include <RadiusEndpointTypes/GlobalReach.h>
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 
@@ -39,6 +40,7 @@ namespace OpenWifi {
         }
 
         DB_.DeleteRecords(fmt::format(" accountId='{}' and id='{}' ", Account, Id));
+        RadiusEndpointRenderCache()->Invalidate();
         return OK();
     }
 
@@ -101,6 +103,7 @@ namespace OpenWifi {
         if(OpenRoaming_GlobalReach()->CreateRADSECCertificate(AccountInfo.GlobalReachAcctId,Existing.name,AccountInfo.CSR, Existing)) {
             Existing.created = Utils::Now();
             DB_.UpdateRecord("id",Existing.id,Existing);
+            RadiusEndpointRenderCache()->Invalidate();
             RecordType   CreatedObject;
             DB_.GetRecord("id",Existing.id,CreatedObject);
             ProvObjects::RADIUSEndpointUpdateStatus Status;
@@ -3,6 +3,7 @@
 //
 
 #include "RESTAPI_openroaming_orion_acct_handler.h"
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 
@@ -30,6 +31,7 @@ namespace OpenWifi {
             return NotFound();
         }
         DB_.DeleteRecord("id", Account);
+        RadiusEndpointRenderCache()->Invalidate();
         return OK();
     }
 
@@ -89,6 +91,7 @@ namespace OpenWifi {
         }
 
         if(DB_.UpdateRecord("id",Existing.info.id,Existing)) {
+            RadiusEndpointRenderCache()->Invalidate();
             RecordType StoredObject;
             DB_.GetRecord("id",Existing.info.id,StoredObject);
             return ReturnObject(StoredObject);
@@ -5,6 +5,7 @@
 #include "RESTAPI_radius_endpoint_handler.h"
 #include <storage/storage_orion_accounts.h>
 #include <RESTObjects/RESTAPI_GWobjects.h>
+#include <RadiusEndpointTypes/RenderCache.h>
 
 namespace OpenWifi {
 
@@ -30,6 +31,7 @@ namespace OpenWifi {
         RecordType Record;
         if(DB_.GetRecord("id",id,Record)) {
             DB_.DeleteRecord("id",id);
+            RadiusEndpointRenderCache()->Invalidate(id);
             ProvObjects::RADIUSEndpointUpdateStatus Status;
             Status.ChangeConfiguration();
             return OK();
@@ -189,6 +191,7 @@ namespace OpenWifi {
 
         ProvObjects::UpdateObjectInfo(RawObject, UserInfo_.userinfo, Existing.info);
         if(DB_.UpdateRecord("id", Existing.info.id, Existing)) {
+            RadiusEndpointRenderCache()->Invalidate(Existing.info.id);
             RecordType  AddedRecord;
             DB_.GetRecord("id", Existing.info.id, AddedRecord);
             ProvObjects::RADIUSEndpointUpdateStatus Status;
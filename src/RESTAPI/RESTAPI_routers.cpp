@@ -7,6 +7,7 @@
 #include "RESTAPI/RESTAPI_configurations_list_handler.h"
 #include "RESTAPI/RESTAPI_contact_handler.h"
 #include "RESTAPI/RESTAPI_contact_list_handler.h"
+#include "RESTAPI/RESTAPI_dashboard_handler.h"
 #include "RESTAPI/RESTAPI_entity_handler.h"
 #include "RESTAPI/RESTAPI_entity_list_handler.h"
 #include "RESTAPI/RESTAPI_inventory_handler.h"
@@ -26,11 +27,14 @@
 #include "RESTAPI/RESTAPI_operators_handler.h"
 #include "RESTAPI/RESTAPI_operators_list_handler.h"
 #include "RESTAPI/RESTAPI_overrides_handler.h"
+#include "RESTAPI/RESTAPI_scheduled_job_handler.h"
+#include "RESTAPI/RESTAPI_scheduled_job_list_handler.h"
 #include "RESTAPI/RESTAPI_service_class_handler.h"
 #include "RESTAPI/RESTAPI_service_class_list_handler.h"
 #include "RESTAPI/RESTAPI_signup_handler.h"
 #include "RESTAPI/RESTAPI_sub_devices_handler.h"
 #include "RESTAPI/RESTAPI_sub_devices_list_handler.h"
+#include "RESTAPI/RESTAPI_tags_handler.h"
 #include "RESTAPI/RESTAPI_variables_handler.h"
 #include "RESTAPI/RESTAPI_variables_list_handler.h"
 #include "RESTAPI/RESTAPI_venue_handler.h"
@@ -72,7 +76,9 @@ namespace OpenWifi {
             RESTAPI_openroaming_gr_acct_handler, RESTAPI_openroaming_gr_list_acct_handler,
             RESTAPI_openroaming_gr_cert_handler, RESTAPI_openroaming_gr_list_certificates,
             RESTAPI_openroaming_orion_acct_handler, RESTAPI_openroaming_orion_list_acct_handler,
-            RESTAPI_radiusendpoint_list_handler, RESTAPI_radius_endpoint_handler>(
+            RESTAPI_radiusendpoint_list_handler, RESTAPI_radius_endpoint_handler,
+            RESTAPI_dashboard_handler, RESTAPI_tags_handler,
+            RESTAPI_scheduled_job_handler, RESTAPI_scheduled_job_list_handler>(
 			Path, Bindings, L, S, TransactionId);
 	}
 
@@ -98,7 +104,9 @@ namespace OpenWifi {
             RESTAPI_openroaming_gr_acct_handler, RESTAPI_openroaming_gr_list_acct_handler,
             RESTAPI_openroaming_gr_cert_handler, RESTAPI_openroaming_gr_list_certificates,
             RESTAPI_openroaming_orion_acct_handler, RESTAPI_openroaming_orion_list_acct_handler,
-            RESTAPI_radiusendpoint_list_handler, RESTAPI_radius_endpoint_handler>(
+            RESTAPI_radiusendpoint_list_handler, RESTAPI_radius_endpoint_handler,
+            RESTAPI_dashboard_handler, RESTAPI_tags_handler,
+            RESTAPI_scheduled_job_handler, RESTAPI_scheduled_job_list_handler>(
                     Path, Bindings, L, S,TransactionId);
 	}
 } // namespace OpenWifi
\ No newline at end of file
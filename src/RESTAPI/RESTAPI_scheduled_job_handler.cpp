@@ -0,0 +1,96 @@
+#include "RESTAPI_scheduled_job_handler.h"
+
+#include "JobController.h"
+#include "JobScheduler.h"
+#include "framework/MicroServiceFuncs.h"
+#include "framework/utils.h"
+
+namespace OpenWifi {
+
+	void RESTAPI_scheduled_job_handler::DoGet() {
+		ProvObjects::ScheduledVenueJob Existing;
+		auto UUID = GetBinding(RESTAPI::Protocol::UUID, "");
+		if (UUID.empty() || !DB_.GetRecord("id", UUID, Existing)) {
+			return NotFound();
+		}
+		Poco::JSON::Object Answer;
+		Existing.to_json(Answer);
+		return ReturnObject(Answer);
+	}
+
+	void RESTAPI_scheduled_job_handler::DoDelete() {
+		auto UUID = GetBinding(RESTAPI::Protocol::UUID, "");
+		if (UUID.empty() || !DB_.Exists("id", UUID)) {
+			return NotFound();
+		}
+		if (!JobScheduler()->Remove(UUID)) {
+			return InternalError(RESTAPI::Errors::CouldNotBeDeleted);
+		}
+		return OK();
+	}
+
+	//	The job runs with the venue as its first parameter, followed by "parameters" (i.e. the
+	//	revision for VenueFirmwareUpgrade). "schedule" is a cron expression; without one, the job
+	//	runs once at "nextRun".
+	void RESTAPI_scheduled_job_handler::DoPost() {
+		auto UUID = GetBinding(RESTAPI::Protocol::UUID, "");
+		if (UUID.empty()) {
+			return BadRequest(RESTAPI::Errors::MissingUUID);
+		}
+
+		ProvObjects::ScheduledVenueJob NewObject;
+		if (!NewObject.from_json(ParsedBody_)) {
+			return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+		}
+		NewObject.id = MicroServiceCreateUUID();
+		NewObject.created = Utils::Now();
+		NewObject.lastRun = 0;
+		NewObject.lastJobId.clear();
+		NewObject.userId = UserInfo_.userinfo.id;
+		NewObject.email = UserInfo_.userinfo.email;
+		Save(NewObject);
+	}
+
+	void RESTAPI_scheduled_job_handler::DoPut() {
+		ProvObjects::ScheduledVenueJob Existing;
+		auto UUID = GetBinding(RESTAPI::Protocol::UUID, "");
+		if (UUID.empty() || !DB_.GetRecord("id", UUID, Existing)) {
+			return NotFound();
+		}
+
+		const auto &RawObject = ParsedBody_;
+		ProvObjects::ScheduledVenueJob NewObject;
+		if (!NewObject.from_json(RawObject)) {
+			return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+		}
+		AssignIfPresent(RawObject, "venue", Existing.venue);
+		AssignIfPresent(RawObject, "name", Existing.name);
+		AssignIfPresent(RawObject, "schedule", Existing.schedule);
+		AssignIfPresent(RawObject, "nextRun", Existing.nextRun);
+		AssignIfPresent(RawObject, "window", Existing.window);
+		if (RawObject->has("parameters"))
+			Existing.parameters = NewObject.parameters;
+		Save(Existing);
+	}
+
+	void RESTAPI_scheduled_job_handler::Save(ProvObjects::ScheduledVenueJob &J) {
+		if (J.venue.empty() || !StorageService()->VenueDB().Exists("id", J.venue)) {
+			return BadRequest(RESTAPI::Errors::VenueMustExist);
+		}
+		if (!JobController::KnownJob(J.name, J.parameters.size() + 1)) {
+			return BadRequest(RESTAPI::Errors::InvalidCommand);
+		}
+		if (J.schedule.empty() ? J.nextRun <= Utils::Now()
+							   : !JobScheduler::NextRun(J.schedule, Utils::Now(), J.nextRun)) {
+			return BadRequest(RESTAPI::Errors::InvalidSchedule);
+		}
+
+		if (!JobScheduler()->Add(J)) {
+			return InternalError(RESTAPI::Errors::RecordNotCreated);
+		}
+		Poco::JSON::Object Answer;
+		J.to_json(Answer);
+		return ReturnObject(Answer);
+	}
+
+} // namespace OpenWifi
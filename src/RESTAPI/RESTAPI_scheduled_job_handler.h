@@ -0,0 +1,28 @@
+#pragma once
+#include "StorageService.h"
+#include "framework/RESTAPI_Handler.h"
+
+namespace OpenWifi {
+	class RESTAPI_scheduled_job_handler : public RESTAPIHandler {
+	  public:
+		RESTAPI_scheduled_job_handler(const RESTAPIHandler::BindingMap &bindings, Poco::Logger &L,
+									  RESTAPI_GenericServerAccounting &Server,
+									  uint64_t TransactionId, bool Internal)
+			: RESTAPIHandler(bindings, L,
+							 std::vector<std::string>{Poco::Net::HTTPRequest::HTTP_GET,
+													  Poco::Net::HTTPRequest::HTTP_POST,
+													  Poco::Net::HTTPRequest::HTTP_PUT,
+													  Poco::Net::HTTPRequest::HTTP_DELETE,
+													  Poco::Net::HTTPRequest::HTTP_OPTIONS},
+							 Server, TransactionId, Internal) {}
+		static auto PathName() { return std::list<std::string>{"/api/v1/scheduledJob/{uuid}"}; };
+
+	  private:
+		ScheduledJobsDB &DB_ = StorageService()->ScheduledJobsDB();
+		void DoGet() final;
+		void DoPost() final;
+		void DoPut() final;
+		void DoDelete() final;
+		void Save(ProvObjects::ScheduledVenueJob &J);
+	};
+} // namespace OpenWifi
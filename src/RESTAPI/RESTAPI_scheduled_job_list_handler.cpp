@@ -0,0 +1,18 @@
+#include "RESTAPI_scheduled_job_list_handler.h"
+#include "RESTAPI/RESTAPI_db_helpers.h"
+
+namespace OpenWifi {
+	void RESTAPI_scheduled_job_list_handler::DoGet() {
+		auto Venue = GetParameter("venue", "");
+		if (QB_.CountOnly) {
+			return ReturnCountOnly(
+				Venue.empty() ? DB_.Count() : DB_.Count(DB_.OP("venue", ORM::EQ, Venue)));
+		}
+		ScheduledJobsDB::RecordVec Jobs;
+		if (Venue.empty())
+			DB_.GetRecords(QB_.Offset, QB_.Limit, Jobs);
+		else
+			DB_.GetRecords(QB_.Offset, QB_.Limit, Jobs, DB_.OP("venue", ORM::EQ, Venue));
+		return MakeJSONObjectArray("jobs", Jobs, *this);
+	}
+} // namespace OpenWifi
@@ -0,0 +1,25 @@
+#pragma once
+#include "StorageService.h"
+#include "framework/RESTAPI_Handler.h"
+
+namespace OpenWifi {
+	class RESTAPI_scheduled_job_list_handler : public RESTAPIHandler {
+	  public:
+		RESTAPI_scheduled_job_list_handler(const RESTAPIHandler::BindingMap &bindings,
+										   Poco::Logger &L,
+										   RESTAPI_GenericServerAccounting &Server,
+										   uint64_t TransactionId, bool Internal)
+			: RESTAPIHandler(bindings, L,
+							 std::vector<std::string>{Poco::Net::HTTPRequest::HTTP_GET,
+													  Poco::Net::HTTPRequest::HTTP_OPTIONS},
+							 Server, TransactionId, Internal) {}
+		static auto PathName() { return std::list<std::string>{"/api/v1/scheduledJob"}; };
+
+	  private:
+		ScheduledJobsDB &DB_ = StorageService()->ScheduledJobsDB();
+		void DoGet() final;
+		void DoPost() final{};
+		void DoPut() final{};
+		void DoDelete() final{};
+	};
+} // namespace OpenWifi
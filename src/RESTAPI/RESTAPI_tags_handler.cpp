@@ -0,0 +1,181 @@
+#include "RESTAPI_tags_handler.h"
+
+#include <algorithm>
+
+#include "Poco/StringTokenizer.h"
+
+#include "StorageService.h"
+#include "TagServer.h"
+#include "framework/RESTAPI_utils.h"
+
+namespace OpenWifi {
+
+	template <typename DBType, typename Func>
+	static bool FindRecord(DBType &DB, const std::string &Id, Func &&Describe) {
+		typename DBType::RecordName R;
+		if (!DB.GetRecord("id", Id, R))
+			return false;
+		Describe(R);
+		return true;
+	}
+
+	//	Tags may only be set on objects that exist. Known is false when the ARN prefix is not one
+	//	of a taggable object.
+	bool RESTAPI_tags_handler::FindObject(const std::string &Arn, TaggedObject &Object,
+										  bool &Known) {
+		Known = true;
+		auto Colon = Arn.find(':');
+		if (Colon != std::string::npos) {
+			auto Prefix = Arn.substr(0, Colon), Id = Arn.substr(Colon + 1);
+			auto &S = *StorageService();
+			auto WithEntity = [&Object](const auto &R) { Object.Entity = R.entity; };
+			if (Prefix == S.InventoryDB().Prefix())
+				return FindRecord(S.InventoryDB(), Id, WithEntity);
+			if (Prefix == S.VenueDB().Prefix())
+				return FindRecord(S.VenueDB(), Id, WithEntity);
+			if (Prefix == S.EntityDB().Prefix())
+				return FindRecord(S.EntityDB(), Id, [&Object](const ProvObjects::Entity &R) {
+					Object.Entity = R.info.id;
+				});
+			if (Prefix == S.ContactDB().Prefix())
+				return FindRecord(S.ContactDB(), Id, WithEntity);
+			if (Prefix == S.LocationDB().Prefix())
+				return FindRecord(S.LocationDB(), Id, WithEntity);
+			if (Prefix == S.ConfigurationDB().Prefix())
+				return FindRecord(S.ConfigurationDB(), Id, WithEntity);
+			if (Prefix == S.PolicyDB().Prefix())
+				return FindRecord(S.PolicyDB(), Id, WithEntity);
+			if (Prefix == S.VariablesDB().Prefix())
+				return FindRecord(S.VariablesDB(), Id, WithEntity);
+			//	Same rules as RESTAPI_map_handler: only the creator or an administrator may change
+			//	a map, and its visibility says who else may see it.
+			if (Prefix == S.MapDB().Prefix())
+				return FindRecord(S.MapDB(), Id, [&Object](const ProvObjects::Map &R) {
+					Object.Entity = R.entity;
+					Object.Creator = R.creator;
+					Object.Visibility = R.visibility;
+					for (const auto &Access : R.access.list)
+						Object.Readers.insert(Object.Readers.end(), Access.users.list.begin(),
+											  Access.users.list.end());
+				});
+		}
+		Known = false;
+		return false;
+	}
+
+	bool RESTAPI_tags_handler::IsAdministrator() const {
+		return UserInfo_.userinfo.userRole == SecurityObjects::ROOT ||
+			   UserInfo_.userinfo.userRole == SecurityObjects::ADMIN;
+	}
+
+	bool RESTAPI_tags_handler::MayChange(const TaggedObject &Object) const {
+		return Object.Creator.empty() || IsAdministrator() ||
+			   Object.Creator == UserInfo_.userinfo.id;
+	}
+
+	bool RESTAPI_tags_handler::MayView(const TaggedObject &Object) const {
+		if (MayChange(Object) || Object.Visibility == "public")
+			return true;
+		if (Object.Visibility == "select")
+			return std::find(Object.Readers.begin(), Object.Readers.end(),
+							 UserInfo_.userinfo.id) != Object.Readers.end();
+		return false;
+	}
+
+	//	Tags left behind by a deleted object are only shown to administrators.
+	bool RESTAPI_tags_handler::MayView(const std::string &Arn) {
+		TaggedObject Object;
+		bool Known;
+		return FindObject(Arn, Object, Known) ? MayView(Object) : IsAdministrator();
+	}
+
+	//	GET /tags?tags=k1=v1,k2&prefix=inv lists the objects carrying all the tags. Without tags,
+	//	the tag dictionary is returned.
+	void RESTAPI_tags_handler::DoGet() {
+		auto Arn = GetBinding("arn", "");
+		if (!Arn.empty()) {
+			TagsObject T;
+			if (!TagServer()->GetTags(Arn, T))
+				return NotFound();
+			if (!MayView(Arn))
+				return UnAuthorized(RESTAPI::Errors::ACCESS_DENIED);
+			Poco::JSON::Object Answer;
+			Answer.set("entity", T.entity);
+			Answer.set("arn", T.arn);
+			RESTAPI_utils::field_to_json(Answer, "entries", T.entries);
+			return ReturnObject(Answer);
+		}
+
+		auto Tags = GetParameter("tags", "");
+		Poco::JSON::Object Answer;
+		if (Tags.empty()) {
+			TagServer()->DictionaryToJson(Answer);
+			return ReturnObject(Answer);
+		}
+
+		Poco::StringTokenizer Query(Tags, ",", Poco::StringTokenizer::TOK_TRIM |
+												  Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+		Types::StringVec Wanted(Query.begin(), Query.end()), Arns;
+		auto Prefix = GetParameter("prefix", "");
+		uint64_t Total = 0;
+		if (IsAdministrator()) {
+			Total = TagServer()->Find(Wanted, Prefix, QB_.Offset, QB_.Limit, Arns);
+		} else {
+			//	Others only get the objects they may see, so the page is cut after filtering.
+			Types::StringVec Matches;
+			TagServer()->Find(Wanted, Prefix, 0, 0, Matches);
+			for (const auto &Arn : Matches) {
+				if (!MayView(Arn))
+					continue;
+				if (Total >= QB_.Offset && (QB_.Limit == 0 || Arns.size() < QB_.Limit))
+					Arns.push_back(Arn);
+				++Total;
+			}
+		}
+		Answer.set("total", Total);
+		RESTAPI_utils::field_to_json(Answer, "objects", Arns);
+		return ReturnObject(Answer);
+	}
+
+	void RESTAPI_tags_handler::DoPut() {
+		auto Arn = GetBinding("arn", "");
+		TaggedObject Object;
+		bool Known;
+		if (!FindObject(Arn, Object, Known)) {
+			return Known ? NotFound() : BadRequest(RESTAPI::Errors::MissingOrInvalidParameters);
+		}
+		if (!MayChange(Object)) {
+			return UnAuthorized(RESTAPI::Errors::ACCESS_DENIED);
+		}
+
+		Types::StringVec Entries;
+		const auto &RawObj = ParsedBody_;
+		if (!RawObj->has("entries") || !RawObj->isArray("entries")) {
+			return BadRequest(RESTAPI::Errors::InvalidJSONDocument);
+		}
+		RESTAPI_utils::field_from_json(RawObj, "entries", Entries);
+
+		//	The entity is the object's own, whatever the request says.
+		if (!TagServer()->SetTags(Arn, Object.Entity, Entries)) {
+			return InternalError(RESTAPI::Errors::RecordNotUpdated);
+		}
+		return OK();
+	}
+
+	void RESTAPI_tags_handler::DoDelete() {
+		auto Arn = GetBinding("arn", "");
+		TagsObject T;
+		if (!TagServer()->GetTags(Arn, T)) {
+			return NotFound();
+		}
+		//	Tags left behind by a deleted object can still be cleared by an administrator.
+		TaggedObject Object;
+		bool Known;
+		if (FindObject(Arn, Object, Known) ? !MayChange(Object) : !IsAdministrator()) {
+			return UnAuthorized(RESTAPI::Errors::ACCESS_DENIED);
+		}
+		TagServer()->RemoveTags(Arn);
+		return OK();
+	}
+
+} // namespace OpenWifi
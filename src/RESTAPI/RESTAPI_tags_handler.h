@@ -0,0 +1,42 @@
+#pragma once
+#include "framework/RESTAPI_Handler.h"
+
+namespace OpenWifi {
+	class RESTAPI_tags_handler : public RESTAPIHandler {
+	  public:
+		RESTAPI_tags_handler(const RESTAPIHandler::BindingMap &bindings, Poco::Logger &L,
+							 RESTAPI_GenericServerAccounting &Server, uint64_t TransactionId,
+							 bool Internal)
+			: RESTAPIHandler(bindings, L,
+							 std::vector<std::string>{Poco::Net::HTTPRequest::HTTP_GET,
+													  Poco::Net::HTTPRequest::HTTP_PUT,
+													  Poco::Net::HTTPRequest::HTTP_DELETE,
+													  Poco::Net::HTTPRequest::HTTP_OPTIONS},
+							 Server, TransactionId, Internal) {}
+		static auto PathName() {
+			return std::list<std::string>{"/api/v1/tags", "/api/v1/tags/{arn}"};
+		};
+
+	  private:
+		//	What the checks need to know about the object an ARN names.
+		struct TaggedObject {
+			std::string Entity;
+			//	Only set for objects that only their creator or an administrator may change.
+			std::string Creator;
+			//	For those objects: "public", "private" or "select", and who may see a "select" one.
+			std::string Visibility;
+			Types::StringVec Readers;
+		};
+
+		bool FindObject(const std::string &Arn, TaggedObject &Object, bool &Known);
+		[[nodiscard]] bool MayChange(const TaggedObject &Object) const;
+		[[nodiscard]] bool MayView(const TaggedObject &Object) const;
+		[[nodiscard]] bool MayView(const std::string &Arn);
+		[[nodiscard]] bool IsAdministrator() const;
+
+		void DoGet() final;
+		void DoPost() final{};
+		void DoPut() final;
+		void DoDelete() final;
+	};
+} // namespace OpenWifi
@@ -11,6 +11,8 @@
 #include "RESTAPI/RESTAPI_db_helpers.h"
 #include "RESTObjects/RESTAPI_ProvObjects.h"
 #include "StorageService.h"
+#include "FirmwareCatalog.h"
+#include "OwnershipRing.h"
 #include "Tasks/VenueConfigUpdater.h"
 #include "Tasks/VenueRebooter.h"
 #include "Tasks/VenueUpgrade.h"
@@ -292,6 +294,7 @@ namespace OpenWifi {
 			auto NewJob = new VenueConfigUpdater(JobId, "VenueConfigurationUpdater", Parameters, 0,
 												 UserInfo_.userinfo, Logger());
 			JobController()->AddJob(dynamic_cast<Job *>(NewJob));
+			OwnershipRing()->ShareJob("VenueConfigurationUpdater", JobId, Parameters, UserInfo_.userinfo);
 			SNL.to_json(Answer);
 			Answer.set("jobId", JobId);
 			return ReturnObject(Answer);
@@ -315,7 +318,7 @@ namespace OpenWifi {
 				bool first_pass = true;
 				for (const auto &device_type : DeviceTypes) {
 					FirmwareList list;
-					if (SDK::FMS::Firmware::GetDeviceTypeFirmwares(device_type, list)) {
+					if (FirmwareCatalog()->GetFirmwares(device_type, list)) {
 						AllFMs[device_type] = list;
 						FirmwareRevisions DeviceRevisions;
 						if (first_pass) {
@@ -382,9 +385,28 @@ namespace OpenWifi {
 			Poco::JSON::Object Answer;
 			auto JobId = MicroServiceCreateUUID();
 			Types::StringVec Parameters{UUID, Revision};
+			//	Waves are only given to the job when asked for: the defaults come from the
+			//	configuration of the replica running it.
+			auto Plan = VenueUpgradePlan::Defaults();
+			bool HasPlan = false;
+			for (const auto &[Name, Field] :
+				 std::vector<std::pair<std::string, uint64_t *>>{
+					 {"canary", &Plan.Canary},
+					 {"waveSize", &Plan.WaveSize},
+					 {"concurrency", &Plan.Concurrency},
+					 {"maxFailures", &Plan.MaxFailures},
+					 {"healthWait", &Plan.HealthWait}}) {
+				if (!GetParameter(Name, "").empty()) {
+					*Field = GetParameter(Name, *Field);
+					HasPlan = true;
+				}
+			}
+			if (HasPlan)
+				Parameters.push_back(Plan.ToString());
 			auto NewJob = new VenueUpgrade(JobId, "VenueFirmwareUpgrade", Parameters, 0,
 										   UserInfo_.userinfo, Logger());
 			JobController()->AddJob(dynamic_cast<Job *>(NewJob));
+			OwnershipRing()->ShareJob("VenueFirmwareUpgrade", JobId, Parameters, UserInfo_.userinfo);
 			SNL.to_json(Answer);
 			Answer.set("jobId", JobId);
 			return ReturnObject(Answer);
@@ -401,6 +423,7 @@ namespace OpenWifi {
 			auto NewJob = new VenueRebooter(JobId, "VenueRebooter", Parameters, 0,
 											UserInfo_.userinfo, Logger());
 			JobController()->AddJob(dynamic_cast<Job *>(NewJob));
+			OwnershipRing()->ShareJob("VenueRebooter", JobId, Parameters, UserInfo_.userinfo);
 			SNL.to_json(Answer);
 			Answer.set("jobId", JobId);
 			return ReturnObject(Answer);
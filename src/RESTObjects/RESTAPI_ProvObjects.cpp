@@ -26,6 +26,16 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "tags", tags);
 	}
 
+	void ObjectInfo::to_json(JSONWriter &W) const {
+		field_to_json(W, "id", id);
+		field_to_json(W, "name", name);
+		field_to_json(W, "description", description);
+		field_to_json(W, "created", created);
+		field_to_json(W, "modified", modified);
+		field_to_json(W, "notes", notes);
+		field_to_json(W, "tags", tags);
+	}
+
 	bool ObjectInfo::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			field_from_json(Obj, "id", id);
@@ -98,6 +108,25 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "configurations", configurations);
 	}
 
+	void Entity::to_json(JSONWriter &W) const {
+		info.to_json(W);
+		field_to_json(W, "parent", parent);
+		field_to_json(W, "venues", venues);
+		field_to_json(W, "children", children);
+		field_to_json(W, "contacts", contacts);
+		field_to_json(W, "locations", locations);
+		field_to_json(W, "managementPolicy", managementPolicy);
+		field_to_json(W, "deviceConfiguration", deviceConfiguration);
+		field_to_json(W, "devices", devices);
+		field_to_json(W, "deviceRules", deviceRules);
+		field_to_json(W, "sourceIP", sourceIP);
+		field_to_json(W, "variables", variables);
+		field_to_json(W, "managementPolicies", managementPolicies);
+		field_to_json(W, "managementRoles", managementRoles);
+		field_to_json(W, "maps", maps);
+		field_to_json(W, "configurations", configurations);
+	}
+
 	bool Entity::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			info.from_json(Obj);
@@ -127,6 +156,11 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "child", child);
 	}
 
+	void DiGraphEntry::to_json(JSONWriter &W) const {
+		field_to_json(W, "parent", parent);
+		field_to_json(W, "child", child);
+	}
+
 	bool DiGraphEntry::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			field_from_json(Obj, "parent", parent);
@@ -160,6 +194,28 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "boards", boards);
 	}
 
+	void Venue::to_json(JSONWriter &W) const {
+		info.to_json(W);
+		field_to_json(W, "parent", parent);
+		field_to_json(W, "entity", entity);
+		field_to_json(W, "children", children);
+		field_to_json(W, "devices", devices);
+		field_to_json(W, "topology", topology);
+		field_to_json(W, "design", design);
+		field_to_json(W, "managementPolicy", managementPolicy);
+		field_to_json(W, "deviceConfiguration", deviceConfiguration);
+		field_to_json(W, "contacts", contacts);
+		field_to_json(W, "location", location);
+		field_to_json(W, "deviceRules", deviceRules);
+		field_to_json(W, "sourceIP", sourceIP);
+		field_to_json(W, "variables", variables);
+		field_to_json(W, "managementPolicies", managementPolicies);
+		field_to_json(W, "managementRoles", managementRoles);
+		field_to_json(W, "maps", maps);
+		field_to_json(W, "configurations", configurations);
+		field_to_json(W, "boards", boards);
+	}
+
 	bool Venue::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			info.from_json(Obj);
@@ -592,6 +648,30 @@ namespace OpenWifi::ProvObjects {
         field_to_json(Obj, "platform", platform);
 	}
 
+	void InventoryTag::to_json(JSONWriter &W) const {
+		info.to_json(W);
+		field_to_json(W, "serialNumber", serialNumber);
+		field_to_json(W, "venue", venue);
+		field_to_json(W, "entity", entity);
+		field_to_json(W, "subscriber", subscriber);
+		field_to_json(W, "deviceType", deviceType);
+		field_to_json(W, "qrCode", qrCode);
+		field_to_json(W, "geoCode", geoCode);
+		field_to_json(W, "location", location);
+		field_to_json(W, "contact", contact);
+		field_to_json(W, "deviceConfiguration", deviceConfiguration);
+		field_to_json(W, "deviceRules", deviceRules);
+		field_to_json(W, "managementPolicy", managementPolicy);
+		field_to_json(W, "state", state);
+		field_to_json(W, "devClass", devClass);
+		field_to_json(W, "locale", locale);
+		field_to_json(W, "realMacAddress", realMacAddress);
+		field_to_json(W, "doNotAllowOverrides", doNotAllowOverrides);
+		field_to_json(W, "imported", imported);
+		field_to_json(W, "connected", connected);
+		field_to_json(W, "platform", platform);
+	}
+
 	bool InventoryTag::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			info.from_json(Obj);
@@ -660,6 +740,13 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "configuration", configuration);
 	}
 
+	void DeviceConfigurationElement::to_json(JSONWriter &W) const {
+		field_to_json(W, "name", name);
+		field_to_json(W, "description", description);
+		field_to_json(W, "weight", weight);
+		field_to_json(W, "configuration", configuration);
+	}
+
 	bool DeviceConfigurationElement::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			field_from_json(Obj, "name", name);
@@ -686,6 +773,20 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "deviceRules", deviceRules);
 	}
 
+	void DeviceConfiguration::to_json(JSONWriter &W) const {
+		info.to_json(W);
+		field_to_json(W, "managementPolicy", managementPolicy);
+		field_to_json(W, "deviceTypes", deviceTypes);
+		field_to_json(W, "subscriberOnly", subscriberOnly);
+		field_to_json(W, "entity", entity);
+		field_to_json(W, "venue", venue);
+		field_to_json(W, "subscriber", subscriber);
+		field_to_json(W, "configuration", configuration);
+		field_to_json(W, "inUse", inUse);
+		field_to_json(W, "variables", variables);
+		field_to_json(W, "deviceRules", deviceRules);
+	}
+
 	bool DeviceConfiguration::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			info.from_json(Obj);
@@ -707,10 +808,26 @@ namespace OpenWifi::ProvObjects {
 
 	void Report::to_json(Poco::JSON::Object &Obj) const {
 		field_to_json(Obj, "snapshot", snapShot);
+		field_to_json(Obj, "totalDevices", totalDevices);
 		field_to_json(Obj, "devices", tenants);
+		field_to_json(Obj, "deviceTypes", deviceTypes);
+		field_to_json(Obj, "venues", venues);
+		field_to_json(Obj, "deviceClasses", deviceClasses);
+		field_to_json(Obj, "connection", connection);
+		field_to_json(Obj, "firmwareUpgrade", firmwareUpgrade);
+		field_to_json(Obj, "claimState", claimState);
 	};
 
-	void Report::reset() { tenants.clear(); }
+	void Report::reset() {
+		snapShot = totalDevices = 0;
+		tenants.clear();
+		deviceTypes.clear();
+		venues.clear();
+		deviceClasses.clear();
+		connection.clear();
+		firmwareUpgrade.clear();
+		claimState.clear();
+	}
 
 	void ExpandedUseEntry::to_json(Poco::JSON::Object &Obj) const {
 		field_to_json(Obj, "uuid", uuid);
@@ -893,6 +1010,13 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "value", value);
 	}
 
+	void Variable::to_json(JSONWriter &W) const {
+		field_to_json(W, "type", type);
+		field_to_json(W, "weight", weight);
+		field_to_json(W, "prefix", prefix);
+		field_to_json(W, "value", value);
+	}
+
 	bool Variable::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			field_from_json(Obj, "type", type);
@@ -929,6 +1053,17 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "managementPolicy", managementPolicy);
 	}
 
+	void VariableBlock::to_json(JSONWriter &W) const {
+		info.to_json(W);
+		field_to_json(W, "variables", variables);
+		field_to_json(W, "entity", entity);
+		field_to_json(W, "venue", venue);
+		field_to_json(W, "subscriber", subscriber);
+		field_to_json(W, "inventory", inventory);
+		field_to_json(W, "configurations", configurations);
+		field_to_json(W, "managementPolicy", managementPolicy);
+	}
+
 	bool VariableBlock::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			info.from_json(Obj);
@@ -1117,6 +1252,12 @@ namespace OpenWifi::ProvObjects {
 		field_to_json(Obj, "firmwareUpgrade", firmwareUpgrade);
 	}
 
+	void DeviceRules::to_json(JSONWriter &W) const {
+		field_to_json(W, "rcOnly", rcOnly);
+		field_to_json(W, "rrm", rrm);
+		field_to_json(W, "firmwareUpgrade", firmwareUpgrade);
+	}
+
 	bool DeviceRules::from_json(const Poco::JSON::Object::Ptr &Obj) {
 		try {
 			field_from_json(Obj, "rcOnly", rcOnly);
@@ -1390,6 +1531,56 @@ namespace OpenWifi::ProvObjects {
         return false;
     }
 
+    void ScheduledVenueJob::to_json(Poco::JSON::Object &Obj) const {
+        field_to_json(Obj, "id", id);
+        field_to_json(Obj, "venue", venue);
+        field_to_json(Obj, "name", name);
+        field_to_json(Obj, "parameters", parameters);
+        field_to_json(Obj, "schedule", schedule);
+        field_to_json(Obj, "nextRun", nextRun);
+        field_to_json(Obj, "window", window);
+        field_to_json(Obj, "lastRun", lastRun);
+        field_to_json(Obj, "lastJobId", lastJobId);
+        field_to_json(Obj, "userId", userId);
+        field_to_json(Obj, "email", email);
+        field_to_json(Obj, "created", created);
+    }
+
+    bool ScheduledVenueJob::from_json(const Poco::JSON::Object::Ptr &Obj) {
+        try {
+            field_from_json(Obj, "id", id);
+            field_from_json(Obj, "venue", venue);
+            field_from_json(Obj, "name", name);
+            field_from_json(Obj, "parameters", parameters);
+            field_from_json(Obj, "schedule", schedule);
+            field_from_json(Obj, "nextRun", nextRun);
+            field_from_json(Obj, "window", window);
+            field_from_json(Obj, "lastRun", lastRun);
+            field_from_json(Obj, "lastJobId", lastJobId);
+            field_from_json(Obj, "userId", userId);
+            field_from_json(Obj, "email", email);
+            field_from_json(Obj, "created", created);
+            return true;
+        } catch (const Poco::Exception &E) {
+
+        }
+        return false;
+    }
+
+    void ScheduledVenueJobList::to_json(Poco::JSON::Object &Obj) const {
+        field_to_json(Obj, "jobs", jobs);
+    }
+
+    bool ScheduledVenueJobList::from_json(const Poco::JSON::Object::Ptr &Obj) {
+        try {
+            field_from_json(Obj, "jobs", jobs);
+            return true;
+        } catch (const Poco::Exception &E) {
+
+        }
+        return false;
+    }
+
     void RADIUSEndpointUpdateStatus::to_json(Poco::JSON::Object &Obj) const {
         field_to_json(Obj, "lastUpdate", lastUpdate);
         field_to_json(Obj, "lastConfigurationChange", lastConfigurationChange);
@@ -29,6 +29,7 @@ namespace OpenWifi::ProvObjects {
         Types::TagList tags;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -91,6 +92,7 @@ namespace OpenWifi::ProvObjects {
         std::string firmwareUpgrade{"inherit"};
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -114,6 +116,7 @@ namespace OpenWifi::ProvObjects {
         Types::UUIDvec_t configurations;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -125,6 +128,7 @@ namespace OpenWifi::ProvObjects {
         Types::UUID_t child;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -153,6 +157,7 @@ namespace OpenWifi::ProvObjects {
         Types::UUIDvec_t boards;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -445,6 +450,7 @@ namespace OpenWifi::ProvObjects {
         std::string configuration;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -465,6 +471,7 @@ namespace OpenWifi::ProvObjects {
         std::string subscriber;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -495,6 +502,7 @@ namespace OpenWifi::ProvObjects {
         std::string platform{"AP"};
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
 
@@ -521,7 +529,14 @@ namespace OpenWifi::ProvObjects {
 
     struct Report {
         uint64_t snapShot = 0;
+        uint64_t totalDevices = 0;
         Types::CountedMap tenants;
+        Types::CountedMap deviceTypes;
+        Types::CountedMap venues;
+        Types::CountedMap deviceClasses;
+        Types::CountedMap connection;
+        Types::CountedMap firmwareUpgrade;
+        Types::CountedMap claimState;
 
         void reset();
 
@@ -645,6 +660,7 @@ namespace OpenWifi::ProvObjects {
         std::string value;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -668,6 +684,7 @@ namespace OpenWifi::ProvObjects {
         Types::UUID_t managementPolicy;
 
         void to_json(Poco::JSON::Object &Obj) const;
+        void to_json(JSONWriter &W) const;
 
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
@@ -904,6 +921,31 @@ namespace OpenWifi::ProvObjects {
         bool from_json(const Poco::JSON::Object::Ptr &Obj);
     };
 
+    struct ScheduledVenueJob {
+        std::string                 id;
+        std::string                 venue;
+        std::string                 name;
+        Types::StringVec            parameters;
+        std::string                 schedule;
+        std::uint64_t               nextRun=0;
+        std::uint64_t               window=0;
+        std::uint64_t               lastRun=0;
+        std::string                 lastJobId;
+        std::string                 userId;
+        std::string                 email;
+        std::uint64_t               created=0;
+
+        void to_json(Poco::JSON::Object &Obj) const;
+        bool from_json(const Poco::JSON::Object::Ptr &Obj);
+    };
+
+    struct ScheduledVenueJobList {
+        std::vector<ScheduledVenueJob>  jobs;
+
+        void to_json(Poco::JSON::Object &Obj) const;
+        bool from_json(const Poco::JSON::Object::Ptr &Obj);
+    };
+
     struct RADIUSEndpointUpdateStatus {
         std::uint64_t   lastUpdate=0;
         std::uint64_t   lastConfigurationChange=0;
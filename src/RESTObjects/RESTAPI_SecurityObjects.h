@@ -11,6 +11,7 @@
 #include "Poco/Data/LOB.h"
 #include "Poco/Data/LOBStream.h"
 #include "Poco/JSON/Object.h"
+#include "framework/JSONCodec.h"
 #include "framework/OpenWifiTypes.h"
 #include "framework/utils.h"
 #include <string>
@@ -77,6 +78,7 @@ namespace OpenWifi {
 			std::string note;
 
 			void to_json(Poco::JSON::Object &Obj) const;
+			void to_json(JSONWriter &W) const;
 			bool from_json(const Poco::JSON::Object::Ptr &Obj);
 		};
 		typedef std::vector<NoteInfo> NoteInfoVec;
@@ -5,10 +5,10 @@
 #include "GlobalReach.h"
 #include <Poco/JWT/Token.h>
 #include <Poco/JWT/Signer.h>
+#include <Poco/Net/HTTPClientSession.h>
 #include <Poco/Net/HTTPSClientSession.h>
 #include <Poco/Net/DNS.h>
 #include <Poco/URI.h>
-#include <Poco/TemporaryFile.h>
 #include <Poco/JSON/Object.h>
 #include <Poco/JSON/Parser.h>
 #include <framework/RESTAPI_Handler.h>
@@ -20,6 +20,15 @@ namespace OpenWifi {
     namespace GlobalReach {
         int OpenRoaming::Start() {
             poco_information(Logger(), "Starting...");
+            TokenLifetime_ = MicroServiceConfigGetInt("globalreach.token.lifetime", 300);
+            if (TokenLifetime_ <= 2 * TokenRenewMargin)
+                TokenLifetime_ = 2 * TokenRenewMargin + 1;
+            APIURI_ = MicroServiceConfigGetString("globalreach.api.uri", "https://config.openro.am");
+            while (!APIURI_.empty() && APIURI_.back() == '/')
+                APIURI_.pop_back();
+            Stub_ = MicroServiceConfigGetBool("globalreach.stub", false);
+            if (Stub_)
+                poco_warning(Logger(), "GlobalReach API calls are answered locally (globalreach.stub).");
             InitCache();
             return 0;
         }
@@ -30,16 +39,15 @@ namespace OpenWifi {
         }
 
         void OpenRoaming::InitCache() {
+            //  Keys are loaded the first time an account needs a token, so starting up no longer
+            //  walks the account table and parses every key.
+            std::lock_guard G(KeysMutex_);
+            PrivateKeys_.clear();
+        }
 
-            auto F = [&](const ProvObjects::GLBLRAccountInfo &Info) {
-                poco_information(Logger(), fmt::format("Adding {} to cache.", Info.info.name));
-                if (!Info.privateKey.empty() && !Info.GlobalReachAcctId.empty()) {
-                    MakeToken(Info.GlobalReachAcctId, Info.privateKey);
-                }
-                return true;
-            };
-
-            StorageService()->GLBLRAccountInfoDB().Iterate(F);
+        void OpenRoaming::RemoveAccount(const std::string &GlobalReachAccountId) {
+            std::lock_guard G(KeysMutex_);
+            PrivateKeys_.erase(GlobalReachAccountId);
         }
 
         bool OpenRoaming::Render(const OpenWifi::ProvObjects::RADIUSEndPoint &RE, const std::string &SerialNumber, Poco::JSON::Object &Result) {
@@ -69,6 +77,77 @@ namespace OpenWifi {
             return false;
         }
 
+        bool OpenRoaming::CallAPI(const std::string &Method, const std::string &Path,
+                                  const std::string &BearerToken, const Poco::JSON::Object *Body,
+                                  Poco::JSON::Object::Ptr &Result) {
+            if (BearerToken.empty())
+                return false;
+            if (Stub_)
+                return StubAPI(Method, Path, Body, Result);
+
+            Poco::URI URI{APIURI_ + Path};
+            Poco::Net::HTTPRequest Request(Method, URI.getPathAndQuery(),
+                                           Poco::Net::HTTPMessage::HTTP_1_1);
+            Request.add("Authorization", "Bearer " + BearerToken);
+
+            std::unique_ptr<Poco::Net::HTTPClientSession> Session;
+            if (URI.getScheme() == "https")
+                Session = std::make_unique<Poco::Net::HTTPSClientSession>(URI.getHost(), URI.getPort());
+            else
+                Session = std::make_unique<Poco::Net::HTTPClientSession>(URI.getHost(), URI.getPort());
+            Session->setTimeout(Poco::Timespan(10000, 10000));
+
+            if (Body != nullptr) {
+                std::ostringstream os;
+                Body->stringify(os);
+                Request.setContentType("application/json");
+                Request.setContentLength((long) os.str().size());
+                Session->sendRequest(Request) << os.str();
+            } else {
+                Session->sendRequest(Request);
+            }
+
+            Poco::Net::HTTPResponse Response;
+            std::istream &is = Session->receiveResponse(Response);
+            if (Response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK) {
+                poco_debug(Logger(), fmt::format("GlobalReach {} {} returned {}.", Method, Path,
+                                                 (int) Response.getStatus()));
+                return false;
+            }
+            Poco::JSON::Parser P;
+            Result = P.parse(is).extract<Poco::JSON::Object::Ptr>();
+            return true;
+        }
+
+        bool OpenRoaming::StubAPI(const std::string &Method, const std::string &Path,
+                                  const Poco::JSON::Object *Body, Poco::JSON::Object::Ptr &Result) {
+            static const std::string CertPath{"/v1/radsec/cert/"};
+            Result = Poco::makeShared<Poco::JSON::Object>();
+            if (Method == Poco::Net::HTTPRequest::HTTP_GET && Path == "/v1/config") {
+                Result->set("name", "stub");
+                return true;
+            }
+            if (Method == Poco::Net::HTTPRequest::HTTP_POST && Path == "/v1/radsec/issue" && Body != nullptr) {
+                auto Id = MicroServiceCreateUUID();
+                Result->set("certificate_id", Id);
+                Result->set("certificate", "-----BEGIN CERTIFICATE-----\nstub\n-----END CERTIFICATE-----\n");
+                Result->set("certificate_chain", "");
+                Result->set("expires_at", Utils::Now() + 365 * 24 * 60 * 60);
+                std::lock_guard G(StubMutex_);
+                StubCertificates_[Id] = Result;
+                return true;
+            }
+            if (Method == Poco::Net::HTTPRequest::HTTP_GET && Path.compare(0, CertPath.size(), CertPath) == 0) {
+                std::lock_guard G(StubMutex_);
+                auto Hint = StubCertificates_.find(Path.substr(CertPath.size()));
+                if (Hint == StubCertificates_.end())
+                    return false;
+                Result = Hint->second;
+                return true;
+            }
+            return false;
+        }
+
         bool OpenRoaming::CreateRADSECCertificate(
             const std::string &GlobalReachAccountId,
             const std::string &Name,
@@ -76,42 +155,19 @@ namespace OpenWifi {
             ProvObjects::GLBLRCertificateInfo &NewCertificate) {
 
             try {
-                auto BearerToken = MakeToken(GlobalReachAccountId);
-                Poco::URI URI{"https://config.openro.am/v1/radsec/issue"};
-                std::string Path(URI.getPathAndQuery());
-                Poco::Net::HTTPRequest Request(Poco::Net::HTTPRequest::HTTP_POST, Path,
-                                               Poco::Net::HTTPMessage::HTTP_1_1);
-                Request.add("Authorization", "Bearer " + BearerToken);
-
-                Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-                Session.setTimeout(Poco::Timespan(10000, 10000));
                 Poco::JSON::Object CertRequestBody;
                 CertRequestBody.set("name", Name);
                 CertRequestBody.set("csr", CSR);
 
-                std::ostringstream os;
-                CertRequestBody.stringify(os);
-                Request.setContentType("application/json");
-                Request.setContentLength((long) os.str().size());
-
-                auto &Body = Session.sendRequest(Request);
-                Body << os.str();
-
-                Poco::Net::HTTPResponse Response;
-                std::istream &is = Session.receiveResponse(Response);
-                if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-                    Poco::JSON::Parser P;
-                    auto Result = P.parse(is).extract<Poco::JSON::Object::Ptr>();
+                Poco::JSON::Object::Ptr Result;
+                if (CallAPI(Poco::Net::HTTPRequest::HTTP_POST, "/v1/radsec/issue",
+                            MakeToken(GlobalReachAccountId), &CertRequestBody, Result)) {
                     RESTAPIHandler::AssignIfPresent(Result, "certificate", NewCertificate.certificate);
                     RESTAPIHandler::AssignIfPresent(Result, "certificate_chain", NewCertificate.certificateChain);
                     RESTAPIHandler::AssignIfPresent(Result, "certificate_id", NewCertificate.certificateId);
                     RESTAPIHandler::AssignIfPresent(Result, "expires_at", NewCertificate.expiresAt);
                     return true;
                 }
-                Poco::JSON::Parser P;
-                std::ostringstream oos;
-                auto Result = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-                Result->stringify(oos);
             } catch (const Poco::Exception &E) {
                 poco_error(Logger(),
                            fmt::format("Could not create a new RADSEC certificate: {},{}", E.name(), E.displayText()));
@@ -125,26 +181,9 @@ namespace OpenWifi {
                 ProvObjects::GLBLRCertificateInfo &NewCertificate) {
 
             try {
-                Poco::URI URI{fmt::format("https://config.openro.am/v1/radsec/cert/{}", CertificateId)};
-
-                std::string Path(URI.getPathAndQuery());
-
-                Poco::Net::HTTPRequest Request(Poco::Net::HTTPRequest::HTTP_GET, Path,
-                                               Poco::Net::HTTPMessage::HTTP_1_1);
-
-                auto BearerToken = MakeToken(GlobalReachAccountId);
-                Request.add("Authorization", "Bearer " + BearerToken);
-
-                Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-                Session.setTimeout(Poco::Timespan(10000, 10000));
-
-                Session.sendRequest(Request);
-
-                Poco::Net::HTTPResponse Response;
-                std::istream &is = Session.receiveResponse(Response);
-                if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-                    Poco::JSON::Parser P;
-                    auto Result = P.parse(is).extract<Poco::JSON::Object::Ptr>();
+                Poco::JSON::Object::Ptr Result;
+                if (CallAPI(Poco::Net::HTTPRequest::HTTP_GET, fmt::format("/v1/radsec/cert/{}", CertificateId),
+                            MakeToken(GlobalReachAccountId), nullptr, Result)) {
                     RESTAPIHandler::AssignIfPresent(Result, "certificate", NewCertificate.certificate);
                     RESTAPIHandler::AssignIfPresent(Result, "certificate_chain", NewCertificate.certificateChain);
                     RESTAPIHandler::AssignIfPresent(Result, "certificate_id", NewCertificate.certificateId);
@@ -158,41 +197,76 @@ namespace OpenWifi {
             return false;
         }
 
+        Poco::SharedPtr<Poco::Crypto::ECKey> OpenRoaming::LoadKey(const std::string &PrivateKey) {
+            std::istringstream IS(PrivateKey);
+            return Poco::SharedPtr<Poco::Crypto::ECKey>(new Poco::Crypto::ECKey(nullptr, &IS, ""));
+        }
+
+        std::string OpenRoaming::SignToken(const std::string &GlobalReachAccountId,
+                                           const Poco::SharedPtr<Poco::Crypto::ECKey> &Key, std::uint64_t Now) {
+            Poco::JWT::Token token;
+            token.setType("JWT");
+            token.setAlgorithm("ES256");
+            token.setIssuedAt(Poco::Timestamp::fromEpochTime((std::time_t) Now));
+            token.setExpiration(Poco::Timestamp::fromEpochTime((std::time_t) (Now + TokenLifetime_)));
+
+            token.payload().set("iss", GlobalReachAccountId);
+            token.payload().set("iat", (unsigned long) Now);
+
+            Poco::JWT::Signer Signer;
+            Signer.setECKey(Key);
+            Signer.addAlgorithm(Poco::JWT::Signer::ALGO_ES256);
+            return Signer.sign(token, Poco::JWT::Signer::ALGO_ES256);
+        }
+
+        //  Returns a token for the account, signing a new one only when there is none yet, the key
+        //  changed, or the current token is about to expire. Without a PrivateKey the key comes from
+        //  the cache, or from the account record the first time the account is used.
         std::string
         OpenRoaming::MakeToken(const std::string &GlobalReachAccountId, const std::string &PrivateKey) {
             try {
-                Poco::JWT::Token token;
-                token.setType("JWT");
-                token.setAlgorithm("ES256");
-                token.setIssuedAt(std::time(nullptr));
-
-                token.payload().set("iss", GlobalReachAccountId);
-                token.payload().set("iat", (unsigned long) std::time(nullptr));
+                auto Now = Utils::Now();
+                {
+                    std::lock_guard G(KeysMutex_);
+                    auto KeyHint = PrivateKeys_.find(GlobalReachAccountId);
+                    if (KeyHint != PrivateKeys_.end() &&
+                        (PrivateKey.empty() || KeyHint->second.KeyHash == Utils::ComputeHash(PrivateKey)) &&
+                        KeyHint->second.TokenExpires > Now + TokenRenewMargin) {
+                        return KeyHint->second.Token;
+                    }
+                }
 
-                Poco::SharedPtr<Poco::Crypto::ECKey> Key;
-                auto KeyHash = Utils::ComputeHash(PrivateKey);
-                auto KeyHint = PrivateKeys_.find(GlobalReachAccountId);
-                if (KeyHint != PrivateKeys_.end() && PrivateKey.empty()) {
-                    Key = KeyHint->second.second;
-                } else {
-                    if (PrivateKey.empty()) {
+                auto KeyText = PrivateKey;
+                if (KeyText.empty()) {
+                    ProvObjects::GLBLRAccountInfo Info;
+                    if (!StorageService()->GLBLRAccountInfoDB().GetRecord("GlobalReachAcctId", GlobalReachAccountId, Info) ||
+                        Info.privateKey.empty()) {
                         return "";
                     }
-                    Poco::TemporaryFile F;
-                    std::ofstream ofs(F.path().c_str(),
-                                      std::ios_base::trunc | std::ios_base::out | std::ios_base::binary);
-                    ofs << PrivateKey;
-                    ofs.close();
-                    auto NewKey = Poco::SharedPtr<Poco::Crypto::ECKey>(
-                            new Poco::Crypto::ECKey("", F.path(), ""));
-                    Key = NewKey;
-                    PrivateKeys_[GlobalReachAccountId] = std::make_pair(KeyHash, NewKey);
+                    KeyText = Info.privateKey;
                 }
+                auto KeyHash = Utils::ComputeHash(KeyText);
 
-                Poco::JWT::Signer Signer;
-                Signer.setECKey(Key);
-                Signer.addAllAlgorithms();
-                return Signer.sign(token, Poco::JWT::Signer::ALGO_ES256);
+                //  Parsing and signing happen outside the lock: concurrent callers for the same
+                //  account may each sign a token, and the last one is kept.
+                Poco::SharedPtr<Poco::Crypto::ECKey> Key;
+                {
+                    std::lock_guard G(KeysMutex_);
+                    auto KeyHint = PrivateKeys_.find(GlobalReachAccountId);
+                    if (KeyHint != PrivateKeys_.end() && KeyHint->second.KeyHash == KeyHash)
+                        Key = KeyHint->second.Key;
+                }
+                if (Key.isNull())
+                    Key = LoadKey(KeyText);
+
+                auto Token = SignToken(GlobalReachAccountId, Key, Now);
+                std::lock_guard G(KeysMutex_);
+                auto &Entry = PrivateKeys_[GlobalReachAccountId];
+                Entry.KeyHash = KeyHash;
+                Entry.Key = Key;
+                Entry.Token = Token;
+                Entry.TokenExpires = Now + TokenLifetime_;
+                return Token;
             } catch (const Poco::Exception &E) {
                 poco_error(Logger(),
                            fmt::format("Cannot create a Global Reach token: {},{}", E.name(), E.displayText()));
@@ -203,26 +277,20 @@ namespace OpenWifi {
         bool
         OpenRoaming::VerifyAccount(const std::string &GlobalReachAccountId, const std::string &PrivateKey,
                                                std::string &Name) {
-            auto BearerToken = MakeToken(GlobalReachAccountId, PrivateKey);
-
-            Poco::URI URI{"https://config.openro.am/v1/config"};
-            std::string Path(URI.getPathAndQuery());
-            Poco::Net::HTTPRequest Request(Poco::Net::HTTPRequest::HTTP_GET, Path,
-                                           Poco::Net::HTTPMessage::HTTP_1_1);
-            Request.add("Authorization", "Bearer " + BearerToken);
-
-            Poco::Net::HTTPSClientSession Session(URI.getHost(), URI.getPort());
-            Session.setTimeout(Poco::Timespan(10000, 10000));
-            Session.sendRequest(Request);
-            Poco::Net::HTTPResponse Response;
-            std::istream &is = Session.receiveResponse(Response);
-            if (Response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
-                Poco::JSON::Parser P;
-                auto Result = P.parse(is).extract<Poco::JSON::Object::Ptr>();
-                if (Result->has("name")) {
-                    Name = Result->get("name").toString();
+            try {
+                //  The key being verified may not be saved yet, so sign with it directly and keep
+                //  it out of the cache.
+                auto BearerToken = SignToken(GlobalReachAccountId, LoadKey(PrivateKey), Utils::Now());
+                Poco::JSON::Object::Ptr Result;
+                if (CallAPI(Poco::Net::HTTPRequest::HTTP_GET, "/v1/config", BearerToken, nullptr, Result)) {
+                    if (Result->has("name")) {
+                        Name = Result->get("name").toString();
+                    }
+                    return true;
                 }
-                return true;
+            } catch (const Poco::Exception &E) {
+                poco_error(Logger(),
+                           fmt::format("Could not verify GlobalReach account: {},{}", E.name(), E.displayText()));
             }
             return false;
         }
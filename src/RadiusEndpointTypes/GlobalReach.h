@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
+
 #include "framework/SubSystemServer.h"
 #include "framework/utils.h"
 #include "Poco/JSON/Object.h"
@@ -35,14 +38,41 @@ namespace OpenWifi {
             VerifyAccount(const std::string &GlobalReachAccountId, const std::string &PrivateKey, std::string &Name);
 
             void InitCache();
+            //  Forget the key and token of an account, i.e. when the account is deleted.
+            void RemoveAccount(const std::string &GlobalReachAccountId);
 
             bool Render(const OpenWifi::ProvObjects::RADIUSEndPoint &RE, const std::string & SerialNUmber, Poco::JSON::Object &Result);
             std::vector<Utils::HostNameServerResult> GetServers();
 
         private:
-            std::string MakeToken(const std::string &GlobalReachAccountId, const std::string &PrivateKey = "");
+            //  Parsed signing key of an account and the last token signed with it. The token is
+            //  reused until TokenRenewMargin seconds before it expires.
+            struct AccountKey {
+                std::string KeyHash;
+                Poco::SharedPtr<Poco::Crypto::ECKey> Key;
+                std::string Token;
+                std::uint64_t TokenExpires = 0;
+            };
 
-            std::map<std::string, std::pair<std::string, Poco::SharedPtr<Poco::Crypto::ECKey>>> PrivateKeys_;
+            static constexpr std::uint64_t TokenRenewMargin = 30;
+
+            std::string MakeToken(const std::string &GlobalReachAccountId, const std::string &PrivateKey = "");
+            std::string SignToken(const std::string &GlobalReachAccountId, const Poco::SharedPtr<Poco::Crypto::ECKey> &Key,
+                                  std::uint64_t Now);
+            static Poco::SharedPtr<Poco::Crypto::ECKey> LoadKey(const std::string &PrivateKey);
+            bool CallAPI(const std::string &Method, const std::string &Path, const std::string &BearerToken,
+                         const Poco::JSON::Object *Body, Poco::JSON::Object::Ptr &Result);
+            bool StubAPI(const std::string &Method, const std::string &Path, const Poco::JSON::Object *Body,
+                         Poco::JSON::Object::Ptr &Result);
+
+            std::mutex KeysMutex_;
+            std::map<std::string, AccountKey> PrivateKeys_;
+            std::uint64_t TokenLifetime_ = 300;
+            std::string APIURI_{"https://config.openro.am"};
+            //  Answer API calls locally instead of calling GlobalReach, to test or benchmark offline.
+            bool Stub_ = false;
+            std::mutex StubMutex_;
+            std::map<std::string, Poco::JSON::Object::Ptr> StubCertificates_;
 
             OpenRoaming() noexcept
                     : SubSystemServer("OpenRoaming_GlobalReach", "GLBL-REACH", "globalreach") {
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "Poco/JSON/Object.h"
+
+#include "StorageService.h"
+#include "framework/SubSystemServer.h"
+#include "framework/utils.h"
+#include <RadiusEndpointTypes/GenericRadius.h>
+#include <RadiusEndpointTypes/GlobalReach.h>
+#include <RadiusEndpointTypes/OrionWifi.h>
+#include <RadiusEndpointTypes/Radsec.h>
+
+namespace OpenWifi {
+
+	//	The part of a device configuration produced by a __radiusEndpoint reference. Only
+	//	nas-identifier depends on the device, so each endpoint is rendered once and copied into
+	//	every configuration that uses it. Entries are dropped when the endpoint or an OpenRoaming
+	//	account changes, and after EntryLifetime seconds to pick up changes made through another
+	//	instance.
+	class RadiusEndpointRenderCache : public SubSystemServer {
+	  public:
+		static constexpr std::uint64_t EntryLifetime = 60;
+
+		static auto instance() {
+			static auto instance_ = new RadiusEndpointRenderCache;
+			return instance_;
+		}
+
+		inline int Start() override { return 0; }
+
+		inline void Stop() override { Invalidate(); }
+
+		//	Adds the rendered endpoint to Result. Returns false if the endpoint does not exist.
+		inline bool Render(const std::string &EndpointId, const std::string &SerialNumber,
+						   Poco::JSON::Object &Result) {
+			auto Now = Utils::Now();
+			std::shared_ptr<const Entry> E;
+			std::uint64_t Generation;
+			{
+				std::lock_guard G(Mutex_);
+				auto Hint = Cache_.find(EndpointId);
+				if (Hint != Cache_.end() && Hint->second->Loaded + EntryLifetime > Now)
+					E = Hint->second;
+				Generation = Generation_;
+			}
+
+			if (!E) {
+				ProvObjects::RADIUSEndPoint RE;
+				if (!StorageService()->RadiusEndpointDB().GetRecord("id", EndpointId, RE))
+					return false;
+				auto NewEntry = std::make_shared<Entry>();
+				NewEntry->Loaded = Now;
+				RenderEndpoint(RE, NewEntry->Template);
+				NewEntry->SerialAsNasId =
+					RE.NasIdentifier.empty() && NewEntry->Template.has("nas-identifier");
+				E = NewEntry;
+				std::lock_guard G(Mutex_);
+				//	Do not store what was read before an invalidation that happened meanwhile.
+				if (Generation == Generation_)
+					Cache_[EndpointId] = NewEntry;
+			}
+
+			for (const auto &[Name, Value] : E->Template)
+				Result.set(Name, Value);
+			if (E->SerialAsNasId)
+				Result.set("nas-identifier", SerialNumber);
+			return true;
+		}
+
+		inline void Invalidate(const std::string &EndpointId) {
+			std::lock_guard G(Mutex_);
+			Generation_++;
+			Cache_.erase(EndpointId);
+		}
+
+		//	Used when an OpenRoaming account or certificate changes: those are rare, and several
+		//	endpoints may refer to the same one.
+		inline void Invalidate() {
+			std::lock_guard G(Mutex_);
+			Generation_++;
+			Cache_.clear();
+		}
+
+	  private:
+		struct Entry {
+			std::uint64_t Loaded = 0;
+			bool SerialAsNasId = false;
+			Poco::JSON::Object Template;
+		};
+
+		std::map<std::string, std::shared_ptr<const Entry>> Cache_;
+		std::uint64_t Generation_ = 0;
+
+		static inline void RenderEndpoint(const ProvObjects::RADIUSEndPoint &RE,
+										  Poco::JSON::Object &Result) {
+			if (!RE.UseGWProxy)
+				return;
+			if (RE.Type == "orion") {
+				OpenRoaming_Orion()->Render(RE, "", Result);
+			} else if (RE.Type == "globalreach") {
+				OpenRoaming_GlobalReach()->Render(RE, "", Result);
+			} else if (RE.Type == "radsec") {
+				OpenRoaming_Radsec()->Render(RE, "", Result);
+			} else if (RE.Type == "generic") {
+				OpenRoaming_GenericRadius()->Render(RE, "", Result);
+			} else {
+				Result.set("radius", Poco::JSON::Object());
+			}
+		}
+
+		RadiusEndpointRenderCache() noexcept
+			: SubSystemServer("RadiusEndpointRenderCache", "RADIUS-RENDER", "radius.render") {}
+	};
+
+	inline auto RadiusEndpointRenderCache() { return RadiusEndpointRenderCache::instance(); }
+
+} // namespace OpenWifi
@@ -3,6 +3,8 @@
 //
 
 #pragma once
+#include <map>
+#include <mutex>
 #include <vector>
 #include <utility>
 #include <framework/AppServiceRegistry.h>
@@ -68,122 +70,59 @@ namespace OpenWifi {
                                      std::string & ErrorDetails,
                                      std::string & ErrorDescription) {
 
+            //  One update at a time: the render cache and the last pushed pools are shared.
+            auto &State = RenderState();
+            std::lock_guard G(State.Mutex);
+
             std::vector<ProvObjects::RADIUSEndPoint>    Endpoints;
-            GWObjects::RadiusProxyPoolList  Pools;
-            StorageService()->RadiusEndpointDB().GetRecords(0,500,Endpoints);
+            for(std::uint64_t Offset=0;;Offset+=EndpointPageSize) {
+                auto Before = Endpoints.size();
+                if(!StorageService()->RadiusEndpointDB().GetRecords(Offset,EndpointPageSize,Endpoints,""," ORDER BY id ") ||
+                   Endpoints.size()-Before < EndpointPageSize)
+                    break;
+            }
 
+            OpenRoamingServers  Servers;
+            std::map<std::string,RenderedPool>  Rendered;
+            GWObjects::RadiusProxyPoolList  Pools;
+            std::uint64_t Reused=0;
             for(const auto &Endpoint:Endpoints) {
-                GWObjects::RadiusProxyPool  PP;
-
-                PP.name = Endpoint.info.name;
-                PP.description = Endpoint.info.description;
-                PP.useByDefault = false;
-                PP.poolProxyIp = Endpoint.Index;
-                PP.radsecKeepAlive = 25;
-                PP.enabled = true;
-
-                if(Endpoint.Type=="orion" && !Endpoint.RadsecServers.empty()) {
-                    auto Svrs = OpenRoaming_Orion()->GetServers();
-                    PP.radsecPoolType="orion";
-                    ProvObjects::GooglOrionAccountInfo  OA;
-                    if(StorageService()->OrionAccountsDB().GetRecord("id", Endpoint.RadsecServers[0].UseOpenRoamingAccount, OA)) {
-                        for(auto *ServerType:{&PP.authConfig, &PP.acctConfig, &PP.coaConfig}) {
-                            ServerType->monitor = false;
-                            ServerType->strategy = Endpoint.PoolStrategy;
-                            ServerType->monitorMethod = "none";
-                            ServerType->strategy = "random";
-                            int i=1;
-                            for (const auto &Server: Svrs) {
-                                GWObjects::RadiusProxyServerEntry PE;
-                                PE.radsecCert = Utils::base64encode((const u_char *)OA.certificate.c_str(),OA.certificate.size());
-                                PE.radsecKey = Utils::base64encode((const u_char *)OA.privateKey.c_str(),OA.privateKey.size());
-                                for(const auto &cert:OA.cacerts) {
-                                    auto C = Utils::base64encode((const u_char *)cert.c_str(),cert.size());
-                                    PE.radsecCacerts.emplace_back(C);
-                                }
-                                PE.radsec = true;
-                                PE.name = fmt::format("Server {}",i++);
-                                PE.ignore = false;
-                                PE.ip = Server.Hostname;
-                                PE.port = PE.radsecPort = Server.Port;
-                                PE.allowSelfSigned = false;
-                                PE.weight = 10;
-                                PE.secret = PE.radsecSecret = "radsec";
-                                ServerType->servers.emplace_back(PE);
-                            }
-                        }
-                        Pools.pools.emplace_back(PP);
-                    }
-                } else if(Endpoint.Type=="globalreach" && !Endpoint.RadsecServers.empty()) {
-                    auto Svrs = OpenRoaming_GlobalReach()->GetServers();
-                    PP.radsecPoolType="globalreach";
-                    ProvObjects::GLBLRCertificateInfo   GRCertificate;
-                    ProvObjects::GLBLRAccountInfo       GRAccountInfo;
-                    if( StorageService()->GLBLRCertsDB().GetRecord("id",Endpoint.RadsecServers[0].UseOpenRoamingAccount,GRCertificate) &&
-                        StorageService()->GLBLRAccountInfoDB().GetRecord("id",GRCertificate.accountId,GRAccountInfo)) {
-                        for(auto *ServerType:{&PP.authConfig, &PP.acctConfig, &PP.coaConfig}) {
-                            ServerType->monitor = false;
-                            ServerType->monitorMethod = "none";
-                            ServerType->strategy = Endpoint.PoolStrategy;
-                            ServerType->strategy = "random";
-                            int i = 1;
-                            for (const auto &Server: Svrs) {
-                                GWObjects::RadiusProxyServerEntry PE;
-                                PE.radsecCert = Utils::base64encode((const u_char *)GRCertificate.certificate.c_str(),GRCertificate.certificate.size());
-                                PE.radsecKey = Utils::base64encode((const u_char *)GRAccountInfo.CSRPrivateKey.c_str(),GRAccountInfo.CSRPrivateKey.size());
-                                std::vector<std::string> Chain;
-                                ParseCertChain(GRCertificate.certificateChain,Chain);
-                                for(const auto &cert:Chain) {
-                                    PE.radsecCacerts.emplace_back( Utils::base64encode((const u_char *)cert.c_str(),cert.size()));
-                                }
-                                PE.radsec = true;
-                                PE.name = fmt::format("Server {}", i++);
-                                PE.ignore = false;
-                                PE.ip = Server.Hostname;
-                                PE.port = PE.radsecPort = Server.Port;
-                                PE.allowSelfSigned = false;
-                                PE.weight = 10;
-                                PE.secret = PE.radsecSecret = "radsec";
-                                ServerType->servers.emplace_back(PE);
-                            }
-                        }
-                        Pools.pools.emplace_back(PP);
-                    }
-                } else if(Endpoint.Type=="radsec"  && !Endpoint.RadsecServers.empty()) {
-                    PP.radsecPoolType="radsec";
-                    for(auto *ServerType:{&PP.authConfig, &PP.acctConfig, &PP.coaConfig}) {
-                        ServerType->monitor = false;
-                        ServerType->strategy = Endpoint.PoolStrategy;
-                        ServerType->monitorMethod = "none";
-                        ServerType->strategy = "random";
-                        for (const auto &Server: Endpoint.RadsecServers) {
-                            GWObjects::RadiusProxyServerEntry PE;
-                            PE.radsecCert = Utils::base64encode((const u_char *)Server.Certificate.c_str(), Server.Certificate.size());
-                            PE.radsecKey = Utils::base64encode((const u_char *)Server.PrivateKey.c_str(),Server.PrivateKey.size());
-                            for(const auto &C:Server.CaCerts) {
-                                PE.radsecCacerts.emplace_back(Utils::base64encode(
-                                        (const u_char *) C.c_str(),
-                                        C.size()));
-                            }
-                            PE.radsec = true;
-                            PE.name = Server.Hostname;
-                            PE.ignore = false;
-                            PE.ip = Server.IP;
-                            PE.port = PE.radsecPort = Server.Port;
-                            PE.allowSelfSigned = false;
-                            PE.weight = 10;
-                            PE.secret = PE.radsecSecret = "radsec";
-                            ServerType->servers.emplace_back(PE);
-                        }
-                    }
-                    Pools.pools.emplace_back(PP);
-                } else if(Endpoint.Type=="generic"  && !Endpoint.RadiusServers.empty()) {
-                    PP.radsecPoolType="generic";
-                    UpdateRadiusServerEntry(PP.authConfig, Endpoint, Endpoint.RadiusServers[0].Authentication);
-                    UpdateRadiusServerEntry(PP.acctConfig, Endpoint, Endpoint.RadiusServers[0].Accounting);
-                    UpdateRadiusServerEntry(PP.coaConfig, Endpoint, Endpoint.RadiusServers[0].CoA);
-                    Pools.pools.emplace_back(PP);
-                }
+                auto Previous = State.Rendered.find(Endpoint.info.id);
+                auto &R = Rendered[Endpoint.info.id];
+                if(!Render(Endpoint, Servers, Previous==State.Rendered.end() ? nullptr : &Previous->second, R))
+                    continue;
+                if(R.Reused)
+                    Reused++;
+                Pools.pools.emplace_back(R.Pool);
+            }
+            State.Rendered.swap(Rendered);
+
+            //  The gateway replaces its whole pool list on every call, so changed pools cannot be
+            //  sent alone: the full list goes out when at least one pool was added, changed or
+            //  removed since the last successful push, and nothing is sent otherwise.
+            std::uint64_t Added=0, Changed=0, Removed=0;
+            for(const auto &[Id,R]:State.Rendered) {
+                if(!R.Valid)
+                    continue;
+                auto Hint = State.Pushed.find(Id);
+                if(Hint==State.Pushed.end())
+                    Added++;
+                else if(Hint->second!=R.Json)
+                    Changed++;
+            }
+            for(const auto &[Id,Json]:State.Pushed) {
+                auto Hint = State.Rendered.find(Id);
+                if(Hint==State.Rendered.end() || !Hint->second.Valid)
+                    Removed++;
+            }
+
+            ProvObjects::RADIUSEndpointUpdateStatus Status;
+            Status.Read();
+            if(State.HavePushed && Added==0 && Changed==0 && Removed==0) {
+                poco_debug(Logger(), fmt::format("RADIUS pools unchanged ({} pools, {} rendered from cache). Nothing sent to the gateway.",
+                                                  Pools.pools.size(), Reused));
+                Status.lastUpdate = Utils::Now();
+                return Status.Save();
             }
 
 /*
@@ -194,11 +133,19 @@ namespace OpenWifi {
             GWObjects::RadiusProxyPoolList  NewPools;
             Poco::JSON::Object ErrorObj;
             if(SDK::GW::RADIUS::SetConfiguration(Client, Pools, NewPools, ErrorObj)) {
-                ProvObjects::RADIUSEndpointUpdateStatus Status;
-                Status.Read();
+                State.Pushed.clear();
+                for(const auto &[Id,R]:State.Rendered) {
+                    if(R.Valid)
+                        State.Pushed[Id] = R.Json;
+                }
+                State.HavePushed = true;
+                poco_information(Logger(), fmt::format("RADIUS pools sent to the gateway: {} pools, {} added, {} changed, {} removed, {} rendered from cache.",
+                                                        Pools.pools.size(), Added, Changed, Removed, Reused));
                 Status.lastConfigurationChange = Status.lastUpdate = Utils::Now();
                 return Status.Save();
             }
+            //  The gateway may have kept part of the change: push everything next time.
+            State.HavePushed = false;
 /*
             ErrorCode:
             type: integer
@@ -217,7 +164,190 @@ namespace OpenWifi {
         }
 
     private:
+        static constexpr std::uint64_t EndpointPageSize = 500;
 
+        //  A pool as last rendered for an endpoint. Version covers everything the pool is built
+        //  from (the endpoint, its OpenRoaming account or certificate, and the server list), so
+        //  the certificates and keys are only encoded again when one of them changes.
+        struct RenderedPool {
+            std::string Version;
+            bool Valid = false;
+            bool Reused = false;
+            GWObjects::RadiusProxyPool Pool;
+            std::string Json;
+        };
+
+        struct RenderCache {
+            std::mutex Mutex;
+            std::map<std::string,RenderedPool>  Rendered;
+            //  Pools the gateway accepted on the last push, by endpoint id.
+            std::map<std::string,std::string>   Pushed;
+            bool HavePushed = false;
+        };
+
+        static RenderCache &RenderState() {
+            static RenderCache Cache;
+            return Cache;
+        }
+
+        static Poco::Logger &Logger() {
+            static Poco::Logger &L = Poco::Logger::get("RADIUS-ENDPOINT-UPDATER");
+            return L;
+        }
+
+        //  OpenRoaming servers come from DNS: look them up once per update, not once per endpoint.
+        struct OpenRoamingServers {
+            bool HaveOrion = false, HaveGlobalReach = false;
+            std::vector<Utils::HostNameServerResult> Orion, GlobalReach;
+            std::string OrionKey, GlobalReachKey;
+
+            static std::string Key(const std::vector<Utils::HostNameServerResult> &Servers) {
+                std::string K;
+                for(const auto &Server:Servers)
+                    K += fmt::format("{}:{},", Server.Hostname, Server.Port);
+                return K;
+            }
+
+            const std::vector<Utils::HostNameServerResult> &GetOrion() {
+                if(!HaveOrion) {
+                    Orion = OpenRoaming_Orion()->GetServers();
+                    OrionKey = Key(Orion);
+                    HaveOrion = true;
+                }
+                return Orion;
+            }
+
+            const std::vector<Utils::HostNameServerResult> &GetGlobalReach() {
+                if(!HaveGlobalReach) {
+                    GlobalReach = OpenRoaming_GlobalReach()->GetServers();
+                    GlobalReachKey = Key(GlobalReach);
+                    HaveGlobalReach = true;
+                }
+                return GlobalReach;
+            }
+        };
+
+        static std::string Encode(const std::string &S) {
+            return Utils::base64encode((const u_char *)S.c_str(), S.size());
+        }
+
+        //  Server entry carrying the encoded RADSEC credentials, ready to be copied per server.
+        static GWObjects::RadiusProxyServerEntry RadsecEntry(const std::string &Certificate,
+                                                             const std::string &PrivateKey,
+                                                             const std::vector<std::string> &CaCerts) {
+            GWObjects::RadiusProxyServerEntry PE;
+            PE.radsecCert = Encode(Certificate);
+            PE.radsecKey = Encode(PrivateKey);
+            for(const auto &C:CaCerts)
+                PE.radsecCacerts.emplace_back(Encode(C));
+            PE.radsec = true;
+            PE.ignore = false;
+            PE.allowSelfSigned = false;
+            PE.weight = 10;
+            PE.secret = PE.radsecSecret = "radsec";
+            return PE;
+        }
+
+        static void RadsecServerConfig(GWObjects::RadiusProxyServerConfig &Config) {
+            Config.monitor = false;
+            Config.monitorMethod = "none";
+            Config.strategy = "random";
+        }
+
+        void OpenRoamingPool(GWObjects::RadiusProxyPool &PP, const GWObjects::RadiusProxyServerEntry &Template,
+                             const std::vector<Utils::HostNameServerResult> &Svrs) {
+            for(auto *ServerType:{&PP.authConfig, &PP.acctConfig, &PP.coaConfig}) {
+                RadsecServerConfig(*ServerType);
+                int i=1;
+                for (const auto &Server: Svrs) {
+                    auto PE = Template;
+                    PE.name = fmt::format("Server {}",i++);
+                    PE.ip = Server.Hostname;
+                    PE.port = PE.radsecPort = Server.Port;
+                    ServerType->servers.emplace_back(PE);
+                }
+            }
+        }
+
+        //  Fills R with the pool for Endpoint, reusing Previous when its version still matches.
+        //  Returns false when the endpoint does not produce a pool.
+        bool Render(const ProvObjects::RADIUSEndPoint &Endpoint, OpenRoamingServers &Servers,
+                    const RenderedPool *Previous, RenderedPool &R) {
+            ProvObjects::GooglOrionAccountInfo  OA;
+            ProvObjects::GLBLRCertificateInfo   GRCertificate;
+            ProvObjects::GLBLRAccountInfo       GRAccountInfo;
+
+            if(Endpoint.Type=="orion" && !Endpoint.RadsecServers.empty()) {
+                if(!StorageService()->OrionAccountsDB().GetRecord("id", Endpoint.RadsecServers[0].UseOpenRoamingAccount, OA))
+                    return false;
+                Servers.GetOrion();
+                R.Version = fmt::format("orion:{}:{}:{}", Endpoint.info.modified, OA.info.modified, Servers.OrionKey);
+            } else if(Endpoint.Type=="globalreach" && !Endpoint.RadsecServers.empty()) {
+                if( !StorageService()->GLBLRCertsDB().GetRecord("id",Endpoint.RadsecServers[0].UseOpenRoamingAccount,GRCertificate) ||
+                    !StorageService()->GLBLRAccountInfoDB().GetRecord("id",GRCertificate.accountId,GRAccountInfo))
+                    return false;
+                Servers.GetGlobalReach();
+                R.Version = fmt::format("globalreach:{}:{}:{}:{}:{}", Endpoint.info.modified, GRAccountInfo.info.modified,
+                                        GRCertificate.certificateId, GRCertificate.expiresAt, Servers.GlobalReachKey);
+            } else if(Endpoint.Type=="radsec"  && !Endpoint.RadsecServers.empty()) {
+                R.Version = fmt::format("radsec:{}", Endpoint.info.modified);
+            } else if(Endpoint.Type=="generic"  && !Endpoint.RadiusServers.empty()) {
+                R.Version = fmt::format("generic:{}", Endpoint.info.modified);
+            } else {
+                return false;
+            }
+
+            if(Previous!=nullptr && Previous->Valid && Previous->Version==R.Version) {
+                R = *Previous;
+                R.Reused = true;
+                return true;
+            }
+
+            auto &PP = R.Pool;
+            PP.name = Endpoint.info.name;
+            PP.description = Endpoint.info.description;
+            PP.useByDefault = false;
+            PP.poolProxyIp = Endpoint.Index;
+            PP.radsecKeepAlive = 25;
+            PP.enabled = true;
+
+            if(Endpoint.Type=="orion") {
+                PP.radsecPoolType="orion";
+                OpenRoamingPool(PP, RadsecEntry(OA.certificate, OA.privateKey, OA.cacerts), Servers.Orion);
+            } else if(Endpoint.Type=="globalreach") {
+                PP.radsecPoolType="globalreach";
+                std::vector<std::string> Chain;
+                ParseCertChain(GRCertificate.certificateChain,Chain);
+                OpenRoamingPool(PP, RadsecEntry(GRCertificate.certificate, GRAccountInfo.CSRPrivateKey, Chain), Servers.GlobalReach);
+            } else if(Endpoint.Type=="radsec") {
+                PP.radsecPoolType="radsec";
+                std::vector<GWObjects::RadiusProxyServerEntry> Entries;
+                for (const auto &Server: Endpoint.RadsecServers) {
+                    auto PE = RadsecEntry(Server.Certificate, Server.PrivateKey, Server.CaCerts);
+                    PE.name = Server.Hostname;
+                    PE.ip = Server.IP;
+                    PE.port = PE.radsecPort = Server.Port;
+                    Entries.emplace_back(PE);
+                }
+                for(auto *ServerType:{&PP.authConfig, &PP.acctConfig, &PP.coaConfig}) {
+                    RadsecServerConfig(*ServerType);
+                    ServerType->servers = Entries;
+                }
+            } else {
+                PP.radsecPoolType="generic";
+                UpdateRadiusServerEntry(PP.authConfig, Endpoint, Endpoint.RadiusServers[0].Authentication);
+                UpdateRadiusServerEntry(PP.acctConfig, Endpoint, Endpoint.RadiusServers[0].Accounting);
+                UpdateRadiusServerEntry(PP.coaConfig, Endpoint, Endpoint.RadiusServers[0].CoA);
+            }
+
+            Poco::JSON::Object  O;
+            PP.to_json(O);
+            std::ostringstream  OS;
+            O.stringify(OS);
+            R.Json = OS.str();
+            R.Valid = true;
+            return true;
+        }
     };
 
 
@@ -7,106 +7,249 @@
 
 namespace OpenWifi {
 
+	static inline uint64_t DigitsMask(uint Digits) { return (1ULL << (4 * Digits)) - 1; }
+
+	static uint64_t ReverseDigits(uint64_t N, uint Digits) {
+		uint64_t Res = 0;
+		for (uint i = 0; i < Digits; i++) {
+			Res = (Res << 4) + (N & 0x0f);
+			N >>= 4;
+		}
+		return Res;
+	}
+
+	static bool ParseHexDigits(const std::string &S, uint64_t &Value) {
+		Value = 0;
+		for (const auto c : S) {
+			if (c >= '0' && c <= '9')
+				Value = (Value << 4) + (c - '0');
+			else if (c >= 'a' && c <= 'f')
+				Value = (Value << 4) + (c - 'a' + 10);
+			else
+				return false;
+		}
+		return true;
+	}
+
+	static bool ContainsDigits(uint64_t SN, uint64_t Pattern, uint Digits, uint TotalDigits) {
+		auto Mask = DigitsMask(Digits);
+		for (uint Shift = 0; Shift + Digits <= TotalDigits; ++Shift) {
+			if (((SN >> (4 * Shift)) & Mask) == Pattern)
+				return true;
+		}
+		return false;
+	}
+
 	int SerialNumberCache::Start() { return 0; }
 
 	void SerialNumberCache::Stop() {}
 
-	void SerialNumberCache::AddSerialNumber(const std::string &S,
-											[[maybe_unused]] const std::string &DeviceType) {
+	void SerialNumberCache::SerialTrigrams(uint64_t SN, std::vector<uint16_t> &T) {
+		T.clear();
+		for (uint Shift = 0; Shift + 3 <= SerialNumberDigits; ++Shift)
+			T.push_back((uint16_t)((SN >> (4 * Shift)) & 0xfff));
+		std::sort(T.begin(), T.end());
+		T.erase(std::unique(T.begin(), T.end()), T.end());
+	}
+
+	std::uint32_t SerialNumberCache::NameId(const std::string &Name) {
+		auto Hint = NameIds_.find(Name);
+		if (Hint != NameIds_.end())
+			return Hint->second;
+		auto Id = (std::uint32_t)Names_.size();
+		Names_.push_back(Name);
+		NameIds_[Name] = Id;
+		return Id;
+	}
+
+	bool SerialNumberCache::FindNameId(const std::string &Name, std::uint32_t &Id) const {
+		auto Hint = NameIds_.find(Name);
+		if (Hint == NameIds_.end())
+			return false;
+		Id = Hint->second;
+		return true;
+	}
+
+	void SerialNumberCache::AddSerialNumber(const std::string &S, const std::string &DeviceType,
+											const std::string &Venue, const std::string &Entity) {
 		std::lock_guard G(Mutex_);
 
 		uint64_t SN = std::stoull(S, nullptr, 16);
-		if (std::find(std::begin(SNs_), std::end(SNs_), SN) == std::end(SNs_)) {
-			auto insert_point = std::lower_bound(SNs_.begin(), SNs_.end(), SN);
-			SNs_.insert(insert_point, SN);
-
-			auto R = ReverseSerialNumber(S);
-			uint64_t RSN = std::stoull(R, nullptr, 16);
-			auto rev_insert_point = std::lower_bound(Reverse_SNs_.begin(), Reverse_SNs_.end(), RSN);
-			Reverse_SNs_.insert(rev_insert_point, RSN);
+		auto &Attributes = Attributes_[SN];
+		Attributes.DeviceType = NameId(DeviceType);
+		Attributes.Venue = NameId(Venue);
+		Attributes.Entity = NameId(Entity);
+
+		auto insert_point = std::lower_bound(SNs_.begin(), SNs_.end(), SN);
+		if (insert_point != SNs_.end() && *insert_point == SN)
+			return;
+		SNs_.insert(insert_point, SN);
+
+		uint64_t RSN = ReverseDigits(SN, SerialNumberDigits);
+		auto rev_insert_point = std::lower_bound(Reverse_SNs_.begin(), Reverse_SNs_.end(), RSN);
+		Reverse_SNs_.insert(rev_insert_point, RSN);
+
+		std::vector<uint16_t> T;
+		SerialTrigrams(SN, T);
+		for (const auto Trigram : T) {
+			auto &Postings = Trigrams_[Trigram];
+			Postings.insert(std::lower_bound(Postings.begin(), Postings.end(), SN), SN);
 		}
 	}
 
+	void SerialNumberCache::AddSerialNumbers(const std::vector<SerialEntry> &Entries) {
+		std::lock_guard G(Mutex_);
+
+		auto SortUnique = [](std::vector<uint64_t> &V) {
+			std::sort(V.begin(), V.end());
+			V.erase(std::unique(V.begin(), V.end()), V.end());
+		};
+
+		SNs_.reserve(SNs_.size() + Entries.size());
+		Reverse_SNs_.reserve(Reverse_SNs_.size() + Entries.size());
+		std::vector<uint16_t> T;
+		for (const auto &Entry : Entries) {
+			uint64_t SN = std::stoull(Entry.SerialNumber, nullptr, 16);
+			auto &Attributes = Attributes_[SN];
+			Attributes.DeviceType = NameId(Entry.DeviceType);
+			Attributes.Venue = NameId(Entry.Venue);
+			Attributes.Entity = NameId(Entry.Entity);
+			SNs_.push_back(SN);
+			Reverse_SNs_.push_back(ReverseDigits(SN, SerialNumberDigits));
+			SerialTrigrams(SN, T);
+			for (const auto Trigram : T)
+				Trigrams_[Trigram].push_back(SN);
+		}
+
+		SortUnique(SNs_);
+		SortUnique(Reverse_SNs_);
+		for (auto &Postings : Trigrams_)
+			SortUnique(Postings);
+	}
+
 	void SerialNumberCache::DeleteSerialNumber(const std::string &S) {
 		std::lock_guard G(Mutex_);
 
 		uint64_t SN = std::stoull(S, nullptr, 16);
-		auto It = std::find(SNs_.begin(), SNs_.end(), SN);
-		if (It != SNs_.end()) {
+		auto It = std::lower_bound(SNs_.begin(), SNs_.end(), SN);
+		if (It != SNs_.end() && *It == SN) {
 			SNs_.erase(It);
+			Attributes_.erase(SN);
 
-			auto R = ReverseSerialNumber(S);
-			uint64_t RSN = std::stoull(R, nullptr, 16);
-			auto RIt = std::find(Reverse_SNs_.begin(), Reverse_SNs_.end(), RSN);
-			if (RIt != Reverse_SNs_.end()) {
+			uint64_t RSN = ReverseDigits(SN, SerialNumberDigits);
+			auto RIt = std::lower_bound(Reverse_SNs_.begin(), Reverse_SNs_.end(), RSN);
+			if (RIt != Reverse_SNs_.end() && *RIt == RSN) {
 				Reverse_SNs_.erase(RIt);
 			}
+
+			std::vector<uint16_t> T;
+			SerialTrigrams(SN, T);
+			for (const auto Trigram : T) {
+				auto &Postings = Trigrams_[Trigram];
+				auto PIt = std::lower_bound(Postings.begin(), Postings.end(), SN);
+				if (PIt != Postings.end() && *PIt == SN)
+					Postings.erase(PIt);
+			}
 		}
 	}
 
-	uint64_t Reverse(uint64_t N) {
-		uint64_t Res = 0;
-
-		for (int i = 0; i < 16; i++) {
-			Res = (Res << 4) + (N & 0x000000000000000f);
-			N >>= 4;
+	bool SerialNumberCache::Search(const std::string &Query, const SearchFilter &Filter,
+								   uint HowMany, const std::string &After,
+								   std::vector<uint64_t> &A, std::string &Continuation) {
+		Continuation.clear();
+		if (Query.empty() || HowMany == 0)
+			return false;
+
+		bool Leading = Query.front() == '*';
+		bool Trailing = Query.size() > 1 && Query.back() == '*';
+		auto Skip = (Leading ? 1 : 0) + (Trailing ? 1 : 0);
+		if (Query.size() <= (std::size_t)Skip)
+			return false;
+		auto Digits = Query.substr(Leading ? 1 : 0, Query.size() - Skip);
+		uint64_t Pattern = 0;
+		if (Digits.size() > SerialNumberDigits || !ParseHexDigits(Digits, Pattern))
+			return false;
+		uint Len = Digits.size();
+
+		bool HasAfter = false;
+		uint64_t Last = 0;
+		if (!After.empty()) {
+			if (After.size() != SerialNumberDigits || !ParseHexDigits(After, Last))
+				return false;
+			HasAfter = true;
 		}
-		Res >>= 16;
-		return Res;
-	}
 
-	void SerialNumberCache::ReturnNumbers(const std::string &S, uint HowMany,
-										  const std::vector<uint64_t> &SNArr,
-										  std::vector<uint64_t> &A, bool ReverseResult) {
 		std::lock_guard G(Mutex_);
 
-		if (S.length() == 12) {
-			uint64_t SN = std::stoull(S, nullptr, 16);
-			auto It = std::find(SNArr.begin(), SNArr.end(), SN);
-			if (It != SNArr.end()) {
-				A.push_back(ReverseResult ? Reverse(*It) : *It);
+		std::uint32_t DeviceType = 0, Venue = 0, Entity = 0;
+		if ((!Filter.DeviceType.empty() && !FindNameId(Filter.DeviceType, DeviceType)) ||
+			(!Filter.Venue.empty() && !FindNameId(Filter.Venue, Venue)) ||
+			(!Filter.Entity.empty() && !FindNameId(Filter.Entity, Entity)))
+			return true;
+		bool Filtered = DeviceType || Venue || Entity;
+
+		uint Found = 0;
+		uint64_t LastFound = 0;
+		//	Returns false on the first match past a full page: only then is there a next page.
+		auto Collect = [&](uint64_t SN) -> bool {
+			if (Filtered) {
+				auto Attributes = Attributes_.find(SN);
+				if (Attributes == Attributes_.end() ||
+					(DeviceType && Attributes->second.DeviceType != DeviceType) ||
+					(Venue && Attributes->second.Venue != Venue) ||
+					(Entity && Attributes->second.Entity != Entity))
+					return true;
+			}
+			if (Found == HowMany) {
+				Continuation = Utils::IntToSerialNumber(LastFound);
+				return false;
 			}
-		} else if (S.length() < 12) {
-			std::string SS{S};
-			SS.insert(SS.end(), 12 - SS.size(), '0');
-			uint64_t SN = std::stoull(SS, nullptr, 16);
-			auto LB = std::lower_bound(SNArr.begin(), SNArr.end(), SN);
-			if (LB != SNArr.end()) {
-				for (; LB != SNArr.end() && HowMany; ++LB, --HowMany) {
-					if (ReverseResult) {
-						const auto TSN =
-							ReverseSerialNumber(Utils::IntToSerialNumber(Reverse(*LB)));
-						if (S == TSN.substr(0, S.size())) {
-							A.emplace_back(Reverse(*LB));
-						} else {
-							break;
-						}
-					} else {
-						const auto TSN = Utils::IntToSerialNumber(*LB);
-						if (S == TSN.substr(0, S.size())) {
-							A.emplace_back(*LB);
-						} else {
-							break;
-						}
-					}
-				}
+			A.push_back(SN);
+			LastFound = SN;
+			++Found;
+			return true;
+		};
+
+		auto Shift = 4 * (SerialNumberDigits - Len);
+		if (!Leading) {
+			uint64_t Lo = Pattern << Shift, Hi = Lo + (1ULL << Shift);
+			uint64_t Start = HasAfter ? std::max(Lo, Last + 1) : Lo;
+			for (auto It = std::lower_bound(SNs_.begin(), SNs_.end(), Start);
+				 It != SNs_.end() && *It < Hi; ++It) {
+				if (!Collect(*It))
+					break;
+			}
+		} else if (!Trailing) {
+			uint64_t Lo = ReverseDigits(Pattern, Len) << Shift, Hi = Lo + (1ULL << Shift);
+			uint64_t Start =
+				HasAfter ? std::max(Lo, ReverseDigits(Last, SerialNumberDigits) + 1) : Lo;
+			for (auto It = std::lower_bound(Reverse_SNs_.begin(), Reverse_SNs_.end(), Start);
+				 It != Reverse_SNs_.end() && *It < Hi; ++It) {
+				if (!Collect(ReverseDigits(*It, SerialNumberDigits)))
+					break;
+			}
+		} else {
+			//	Walk the shortest trigram posting list of the pattern and verify each candidate.
+			//	Patterns under 3 digits match most serial numbers, so a plain scan is fine.
+			const std::vector<uint64_t> *Candidates = &SNs_;
+			for (uint i = 0; i + 3 <= Len; ++i) {
+				const auto &Postings = Trigrams_[(Pattern >> (4 * i)) & 0xfff];
+				if (Postings.size() < Candidates->size())
+					Candidates = &Postings;
+			}
+			uint64_t Start = HasAfter ? Last + 1 : 0;
+			for (auto It = std::lower_bound(Candidates->begin(), Candidates->end(), Start);
+				 It != Candidates->end(); ++It) {
+				if (ContainsDigits(*It, Pattern, Len, SerialNumberDigits) && !Collect(*It))
+					break;
 			}
 		}
+		return true;
 	}
 
 	void SerialNumberCache::FindNumbers(const std::string &S, uint HowMany,
 										std::vector<uint64_t> &A) {
-		if (S.empty())
-			return;
-
-		if (S[0] == '*') {
-			std::string Reversed;
-			std::copy(rbegin(S), rend(S) - 1, std::back_inserter(Reversed));
-			if (Reversed.empty())
-				return;
-			return ReturnNumbers(Reversed, HowMany, Reverse_SNs_, A, true);
-		} else {
-			return ReturnNumbers(S, HowMany, SNs_, A, false);
-		}
+		std::string Continuation;
+		Search(S, SearchFilter{}, HowMany, "", A, Continuation);
 	}
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "framework/SubSystemServer.h"
+#include <array>
 #include <mutex>
+#include <unordered_map>
 
 namespace OpenWifi {
 	class SerialNumberCache : public SubSystemServer {
@@ -15,19 +17,43 @@ namespace OpenWifi {
 			return instance_;
 		}
 
+		//	Optional restrictions on a search. Empty fields match anything.
+		struct SearchFilter {
+			std::string DeviceType;
+			std::string Venue;
+			std::string Entity;
+		};
+
+		struct SerialEntry {
+			std::string SerialNumber;
+			std::string DeviceType;
+			std::string Venue;
+			std::string Entity;
+		};
+
 		int Start() override;
 		void Stop() override;
-		void AddSerialNumber(const std::string &SerialNumber,
-							 [[maybe_unused]] const std::string &DeviceType);
+		void AddSerialNumber(const std::string &SerialNumber, const std::string &DeviceType,
+							 const std::string &Venue = "", const std::string &Entity = "");
+		//	Bulk load used at startup: appends everything and sorts once.
+		void AddSerialNumbers(const std::vector<SerialEntry> &Entries);
 		void DeleteSerialNumber(const std::string &SerialNumber);
 		void FindNumbers(const std::string &SerialNumber, uint HowMany, std::vector<uint64_t> &A);
+
+		//	Query syntax: "abc" or "abc*" is a prefix search, "*abc" a suffix search and "*abc*"
+		//	a contains search. Results come in a stable order, one page at a time: when more matches
+		//	follow a page, Continuation is set and must be passed back as After to get them.
+		bool Search(const std::string &Query, const SearchFilter &Filter, uint HowMany,
+					const std::string &After, std::vector<uint64_t> &A,
+					std::string &Continuation);
+
 		inline std::vector<uint64_t> GetCacheCopy() {
 			std::lock_guard G(Mutex_);
 			return SNs_;
 		}
 		inline bool NumberExists(uint64_t SerialNumber) {
 			std::lock_guard G(Mutex_);
-			return std::find(SNs_.begin(), SNs_.end(), SerialNumber) != SNs_.end();
+			return std::binary_search(SNs_.begin(), SNs_.end(), SerialNumber);
 		}
 
 		static inline std::string ReverseSerialNumber(const std::string &S) {
@@ -37,11 +63,28 @@ namespace OpenWifi {
 		}
 
 	  private:
+		static constexpr uint SerialNumberDigits = 12;
+		static constexpr uint TrigramCount = 16 * 16 * 16;
+
+		struct SerialAttributes {
+			std::uint32_t DeviceType = 0;
+			std::uint32_t Venue = 0;
+			std::uint32_t Entity = 0;
+		};
+
 		std::vector<uint64_t> SNs_;
 		std::vector<uint64_t> Reverse_SNs_;
+		//	For every 3 hex digit sequence, the sorted list of serial numbers containing it. A
+		//	serial has up to 10 distinct trigrams of 8 bytes each: about 80MB per million serials.
+		std::array<std::vector<uint64_t>, TrigramCount> Trigrams_;
+		std::unordered_map<uint64_t, SerialAttributes> Attributes_;
+		//	deviceType, venue and entity values are interned: 0 is always the empty string.
+		std::vector<std::string> Names_{""};
+		std::unordered_map<std::string, std::uint32_t> NameIds_{{"", 0}};
 
-		void ReturnNumbers(const std::string &S, uint HowMany, const std::vector<uint64_t> &SNArr,
-						   std::vector<uint64_t> &A, bool ReverseResult);
+		std::uint32_t NameId(const std::string &Name);
+		bool FindNameId(const std::string &Name, std::uint32_t &Id) const;
+		static void SerialTrigrams(uint64_t SN, std::vector<uint16_t> &T);
 
 		SerialNumberCache() noexcept
 			: SubSystemServer("SerialNumberCache", "SNCACHE-SVR", "serialcache") {
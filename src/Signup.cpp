@@ -20,6 +20,7 @@ namespace OpenWifi {
 
 		for (const auto &i : Signups_) {
 			OutstandingSignups_[i.info.id] = i;
+			Index(i);
 		}
 
 		TimerCallback_ = std::make_unique<Poco::TimerCallback<Signup>>(*this, &Signup::onTimer);
@@ -27,6 +28,7 @@ namespace OpenWifi {
 		Timer_.setPeriodicInterval(1 * 60 * 60 * 1000); // 1 hours
 		Timer_.start(*TimerCallback_);
 
+		Running_ = true;
 		Worker_.start(*this);
 		return 0;
 	}
@@ -35,7 +37,7 @@ namespace OpenWifi {
 		poco_information(Logger(), "Stopping...");
 		Running_ = false;
 		Timer_.stop();
-		Worker_.wakeUp();
+		Queue_.wakeUpAll();
 		Worker_.join();
 		poco_information(Logger(), "Stopped...");
 	}
@@ -45,109 +47,162 @@ namespace OpenWifi {
 		StorageService()->SignupDB().RemoveIncompleteSignups();
 	}
 
+	static std::vector<std::string> CandidateSerialNumbers(const ProvObjects::SignupEntry &SE) {
+		std::vector<std::string> Candidates;
+		try {
+			auto First = Utils::SerialNumberToInt(SE.macAddress);
+			for (uint i = 0; i < 4; ++i)
+				Candidates.push_back(Utils::IntToSerialNumber(First + i));
+		} catch (...) {
+		}
+		return Candidates;
+	}
+
+	void Signup::Index(const ProvObjects::SignupEntry &SE) {
+		if (SE.statusCode != ProvObjects::SignupStatusCodes::SignupWaitingForDevice)
+			return;
+		auto Candidates = CandidateSerialNumbers(SE);
+		if (Candidates.empty())
+			poco_warning(Logger(), fmt::format("Signup {} has an invalid MAC address '{}'.",
+											   SE.info.id, SE.macAddress));
+		for (const auto &SerialNumber : Candidates)
+			WaitingFor_.emplace(SerialNumber, SE.info.id);
+	}
+
+	void Signup::Unindex(const ProvObjects::SignupEntry &SE) {
+		for (const auto &SerialNumber : CandidateSerialNumbers(SE)) {
+			auto Range = WaitingFor_.equal_range(SerialNumber);
+			for (auto i = Range.first; i != Range.second;) {
+				if (i->second == SE.info.id)
+					i = WaitingFor_.erase(i);
+				else
+					++i;
+			}
+		}
+	}
+
+	bool Signup::Complete(ProvObjects::SignupEntry &SE, const std::string &SerialNumber) {
+		ProvObjects::InventoryTag IT;
+		//  if the deviceType is empty, we know that the device has not
+		//  contacted the service yet.
+		if (!StorageService()->InventoryDB().GetRecord("serialNumber", SerialNumber, IT) ||
+			IT.deviceType.empty())
+			return false;
+
+		//	Every replica sees the same connection at the same time: only the one that claims the
+		//	signup completes it. The others drop it.
+		if (!StorageService()->SignupDB().ClaimSignup(SE.info.id)) {
+			poco_debug(Logger(),
+					   fmt::format("Signup {} is completed by another replica.", SE.info.id));
+			return true;
+		}
+		try {
+			Transfer(SE, IT, SerialNumber);
+		} catch (...) {
+			StorageService()->SignupDB().ReleaseSignup(SE.info.id);
+			throw;
+		}
+		return true;
+	}
+
+	void Signup::Transfer(ProvObjects::SignupEntry &SE, ProvObjects::InventoryTag &IT,
+						  const std::string &SerialNumber) {
+		//  We have a device type, so the device contacted us.
+		//  We must now complete the device transfer to this new subscriber and
+		//  complete the signup job.
+		IT.subscriber = SE.userId;
+		IT.info.modified = Utils::Now();
+		IT.realMacAddress = SE.macAddress;
+		if (IT.entity.empty()) {
+
+		} else {
+			// if the entity was not a subscriber entity, then we need to goto
+			// the default entity
+		}
+		Poco::JSON::Object NewState;
+		NewState.set("method", "signup");
+		NewState.set("date", Utils::Now());
+		NewState.set("status", "completed");
+		std::ostringstream OS;
+		NewState.stringify(OS);
+		IT.state = OS.str();
+		StorageService()->InventoryDB().UpdateRecord("id", IT.info.id, IT);
+
+		// we need to move this device to the SubscriberDevice DB
+		ProvObjects::SubscriberDevice SD;
+		SD.info.id = MicroServiceCreateUUID();
+		SD.info.modified = SD.info.created = Utils::Now();
+		SD.info.name = IT.realMacAddress;
+		SD.operatorId = SE.operatorId;
+		SD.serialNumber = SerialNumber;
+		SD.realMacAddress = SE.macAddress;
+		SD.locale = IT.locale;
+		SD.deviceType = IT.deviceType;
+		SD.state = OS.str();
+		SD.subscriberId = SE.userId;
+
+		poco_information(Logger(), fmt::format("Setting service class for {}", SD.serialNumber));
+		SD.serviceClass = StorageService()->ServiceClassDB().DefaultForOperator(SE.operatorId);
+		poco_information(Logger(),
+						 fmt::format("Removing old device information for {}", SD.serialNumber));
+		StorageService()->SubscriberDeviceDB().DeleteRecord("serialNumber", SD.serialNumber);
+		poco_information(Logger(),
+						 fmt::format("Creating subscriber device for {}", SD.serialNumber));
+		StorageService()->SubscriberDeviceDB().CreateRecord(SD);
+		poco_information(Logger(), fmt::format("Removing old inventory for {}", SD.serialNumber));
+		StorageService()->InventoryDB().DeleteRecord("serialNumber", SD.serialNumber);
+
+		SE.status = "signup completed";
+		SE.serialNumber = SerialNumber;
+		SE.statusCode = ProvObjects::SignupStatusCodes::SignupSuccess;
+		SE.completed = Utils::Now();
+		SE.info.modified = Utils::Now();
+		SE.error = 0;
+		poco_information(Logger(), fmt::format("Completed signup for {}", SD.serialNumber));
+		StorageService()->SignupDB().UpdateRecord("id", SE.info.id, SE);
+		poco_information(Logger(), fmt::format("Setting GW subscriber for {}", SD.serialNumber));
+		SDK::GW::Device::SetSubscriber(SerialNumber, IT.subscriber);
+		poco_information(Logger(), fmt::format("Success for {}", SD.serialNumber));
+	}
+
 	void Signup::run() {
-		Running_ = true;
+		Poco::AutoPtr<Poco::Notification> Note(Queue_.waitDequeueNotification());
 		Utils::SetThreadName("signup-mgr");
-		while (Running_) {
-			Poco::Thread::trySleep(5000);
-
-			if (!Running_)
-				break;
-
-			//  get the list of outstanding stuff and see if we have gotten the device...
-			std::lock_guard G(Mutex_);
-			for (auto &[uuid, SE] : OutstandingSignups_) {
-				if (SE.statusCode == ProvObjects::SignupStatusCodes::SignupWaitingForDevice) {
-					//  look for the device...
-					ProvObjects::InventoryTag IT;
-					auto TrySerialNumber = Utils::SerialNumberToInt(SE.macAddress);
-					for (uint i = 0; i < 4; ++i) {
-						std::string SerialNumber = Utils::IntToSerialNumber(TrySerialNumber + i);
-						if (StorageService()->InventoryDB().GetRecord("serialNumber", SerialNumber,
-																	  IT)) {
-							//  if the deviceType is empty, we know that the device has not
-							//  contacted the service yet.
-							if (IT.deviceType.empty())
-								continue;
-
-							//  We have a device type, so the device contacted us.
-							//  We must now complete the device transfer to this new subscriber and
-							//  complete the signup job.
-							IT.subscriber = SE.userId;
-							IT.info.modified = Utils::Now();
-							IT.realMacAddress = SE.macAddress;
-							if (IT.entity.empty()) {
-
-							} else {
-								// if the entity was not a subscriber entity, then we need to goto
-								// the default entity
-							}
-							Poco::JSON::Object NewState;
-							NewState.set("method", "signup");
-							NewState.set("date", Utils::Now());
-							NewState.set("status", "completed");
-							std::ostringstream OS;
-							NewState.stringify(OS);
-							IT.state = OS.str();
-							StorageService()->InventoryDB().UpdateRecord("id", IT.info.id, IT);
-
-							// we need to move this device to the SubscriberDevice DB
-							ProvObjects::SubscriberDevice SD;
-							SD.info.id = MicroServiceCreateUUID();
-							SD.info.modified = SD.info.created = Utils::Now();
-							SD.info.name = IT.realMacAddress;
-							SD.operatorId = SE.operatorId;
-							SD.serialNumber = SerialNumber;
-							SD.realMacAddress = SE.macAddress;
-							SD.locale = IT.locale;
-							SD.deviceType = IT.deviceType;
-							SD.state = OS.str();
-							SD.subscriberId = SE.userId;
-
-							poco_information(Logger(), fmt::format("Setting service class for {}",
-																   SD.serialNumber));
-							SD.serviceClass = StorageService()->ServiceClassDB().DefaultForOperator(
-								SE.operatorId);
-							poco_information(Logger(),
-											 fmt::format("Removing old device information for {}",
-														 SD.serialNumber));
-							StorageService()->SubscriberDeviceDB().DeleteRecord("serialNumber",
-																				SD.serialNumber);
-							poco_information(
-								Logger(),
-								fmt::format("Creating subscriber device for {}", SD.serialNumber));
-							StorageService()->SubscriberDeviceDB().CreateRecord(SD);
-							poco_information(Logger(), fmt::format("Removing old inventory for {}",
-																   SD.serialNumber));
-							StorageService()->InventoryDB().DeleteRecord("serialNumber",
-																		 SD.serialNumber);
-
-							SE.status = "signup completed";
-							SE.serialNumber = SerialNumber;
-							SE.statusCode = ProvObjects::SignupStatusCodes::SignupSuccess;
-							SE.completed = Utils::Now();
-							SE.info.modified = Utils::Now();
-							SE.error = 0;
-							poco_information(
-								Logger(), fmt::format("Completed signup for {}", SD.serialNumber));
-							StorageService()->SignupDB().UpdateRecord("id", SE.info.id, SE);
-							poco_information(Logger(), fmt::format("Setting GW subscriber for {}",
-																   SD.serialNumber));
-							SDK::GW::Device::SetSubscriber(SerialNumber, IT.subscriber);
-							poco_information(Logger(),
-											 fmt::format("Success for {}", SD.serialNumber));
-							break;
-						}
+		while (Note && Running_) {
+			auto Msg = dynamic_cast<SignupDeviceMessage *>(Note.get());
+			if (Msg != nullptr) {
+				//	Completing talks to the database and the gateway: work on copies, so
+				//	auto discovery is never blocked behind it.
+				std::vector<ProvObjects::SignupEntry> Waiting;
+				{
+					std::lock_guard G(Mutex_);
+					auto Candidates = WaitingFor_.equal_range(Msg->SerialNumber());
+					for (auto i = Candidates.first; i != Candidates.second; ++i) {
+						auto hint = OutstandingSignups_.find(i->second);
+						if (hint != end(OutstandingSignups_))
+							Waiting.push_back(hint->second);
 					}
 				}
-			}
 
-			for (auto i = begin(OutstandingSignups_); i != end(OutstandingSignups_);) {
-				if (i->second.completed != 0)
-					i = OutstandingSignups_.erase(i);
-				else
-					i++;
+				for (auto &SE : Waiting) {
+					try {
+						//	Not in the inventory yet: another replica may own the device. Its
+						//	next ping tries again.
+						if (!Complete(SE, Msg->SerialNumber()))
+							continue;
+					} catch (const Poco::Exception &E) {
+						Logger().log(E);
+						continue;
+					}
+					std::lock_guard G(Mutex_);
+					auto hint = OutstandingSignups_.find(SE.info.id);
+					if (hint != end(OutstandingSignups_)) {
+						Unindex(hint->second);
+						OutstandingSignups_.erase(hint);
+					}
+				}
 			}
+			Note = Queue_.waitDequeueNotification();
 		}
 	}
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
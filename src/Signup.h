@@ -4,12 +4,27 @@
 
 #pragma once
 
+#include "Poco/Notification.h"
+#include "Poco/NotificationQueue.h"
 #include "Poco/Timer.h"
 #include "RESTObjects/RESTAPI_ProvObjects.h"
 #include "framework/SubSystemServer.h"
 
 namespace OpenWifi {
 
+	class SignupDeviceMessage : public Poco::Notification {
+	  public:
+		explicit SignupDeviceMessage(const std::string &SerialNumber)
+			: SerialNumber_(SerialNumber) {}
+		const std::string &SerialNumber() { return SerialNumber_; }
+
+	  private:
+		std::string SerialNumber_;
+	};
+
+	//	A signup waits for a device whose serial number is its MAC address, or one of the next
+	//	three. Those candidates are indexed, so a connecting device is matched with a map lookup
+	//	and the signup completes as soon as the device shows up, without polling the inventory.
 	class Signup : public SubSystemServer, Poco::Runnable {
 	  public:
 		static auto instance() {
@@ -37,12 +52,27 @@ namespace OpenWifi {
 
 		inline void RemoveSignupById(const std::string &UUID) {
 			std::lock_guard G(Mutex_);
-			OutstandingSignups_.erase(UUID);
+			auto hint = OutstandingSignups_.find(UUID);
+			if (hint == end(OutstandingSignups_))
+				return;
+			Unindex(hint->second);
+			OutstandingSignups_.erase(hint);
 		}
 
 		inline void AddOutstandingSignup(const ProvObjects::SignupEntry &SE) {
 			std::lock_guard G(Mutex_);
+			auto hint = OutstandingSignups_.find(SE.info.id);
+			if (hint != end(OutstandingSignups_))
+				Unindex(hint->second);
 			OutstandingSignups_[SE.info.id] = SE;
+			Index(SE);
+		}
+
+		//	Called for every connection and ping seen by auto discovery.
+		inline void DeviceConnected(const std::string &SerialNumber) {
+			std::lock_guard G(Mutex_);
+			if (WaitingFor_.find(SerialNumber) != end(WaitingFor_))
+				Queue_.enqueueNotification(new SignupDeviceMessage(SerialNumber));
 		}
 
 		void onTimer(Poco::Timer &timer);
@@ -52,10 +82,20 @@ namespace OpenWifi {
 		uint64_t LingerPeriod_ = 7 * 24 * 60 * 60; //   7 days
 		std::atomic_bool Running_ = false;
 		std::map<std::string, ProvObjects::SignupEntry> OutstandingSignups_;
+		//	Candidate serial number -> id of the signup waiting for it.
+		std::multimap<std::string, std::string> WaitingFor_;
+		Poco::NotificationQueue Queue_;
 		Poco::Thread Worker_;
 		Poco::Timer Timer_;
 		std::unique_ptr<Poco::TimerCallback<Signup>> TimerCallback_;
 
+		void Index(const ProvObjects::SignupEntry &SE);
+		void Unindex(const ProvObjects::SignupEntry &SE);
+		//	True once the signup no longer waits, completed here or by another replica.
+		bool Complete(ProvObjects::SignupEntry &SE, const std::string &SerialNumber);
+		void Transfer(ProvObjects::SignupEntry &SE, ProvObjects::InventoryTag &IT,
+					  const std::string &SerialNumber);
+
 		Signup() noexcept : SubSystemServer("SignupServer", "SIGNUP", "signup") {}
 	};
 
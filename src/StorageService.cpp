@@ -8,6 +8,7 @@
 
 #include "StorageService.h"
 #include "RESTObjects/RESTAPI_ProvObjects.h"
+#include "SerialNumberCache.h"
 #include "fmt/format.h"
 #include "framework/utils.h"
 
@@ -18,6 +19,8 @@ namespace OpenWifi {
 		std::lock_guard Guard(Mutex_);
 
 		StorageClass::Start();
+		ORM::QueryStats()->SetLogger(&Logger());
+		ORM::QueryStats()->SetSlowQueryThreshold(MicroServiceConfigGetInt("storage.slowquery.ms", 250));
 
 		EntityDB_ = std::make_unique<OpenWifi::EntityDB>(dbType_, *Pool_, Logger());
 		PolicyDB_ = std::make_unique<OpenWifi::PolicyDB>(dbType_, *Pool_, Logger());
@@ -43,6 +46,8 @@ namespace OpenWifi {
         GLBLRCertsDB_ = std::make_unique<OpenWifi::GLBLRCertsDB>(dbType_, *Pool_, Logger());
         OrionAccountsDB_ = std::make_unique<OpenWifi::OrionAccountsDB>(dbType_, *Pool_, Logger());
         RadiusEndpointDB_ = std::make_unique<OpenWifi::RadiusEndpointDB>(dbType_, *Pool_, Logger());
+		MembershipDB_ = std::make_unique<OpenWifi::MembershipDB>(dbType_, *Pool_, Logger());
+		ScheduledJobsDB_ = std::make_unique<OpenWifi::ScheduledJobsDB>(dbType_, *Pool_, Logger());
 
 		EntityDB_->Create();
 		PolicyDB_->Create();
@@ -67,6 +72,9 @@ namespace OpenWifi {
         GLBLRCertsDB_->Create();
         OrionAccountsDB_->Create();
         RadiusEndpointDB_->Create();
+		MembershipDB_->Create();
+		ScheduledJobsDB_->Create();
+		NormalizeMemberships();
 
 		ExistFunc_[EntityDB_->Prefix()] = [=](const char *F, std::string &V) -> bool {
 			return EntityDB_->Exists(F, V);
@@ -250,6 +258,8 @@ namespace OpenWifi {
                     [[maybe_unused]] std::string &Name,
                     [[maybe_unused]] std::string &Description) -> bool { return false; };
 
+        InitializeBatchLookups();
+
         InventoryDB_->InitializeSerialCache();
 		ConsistencyCheck();
 		InitializeSystemDBs();
@@ -271,10 +281,99 @@ namespace OpenWifi {
 		poco_information(Logger(), "Stopped...");
 	}
 
+	void Storage::InitializeBatchLookups() {
+		auto AddExist = [this](auto &DB) {
+			BatchExistFunc_[DB.Prefix()] = [&DB](const Types::StringVec &Ids,
+												 std::set<std::string> &Found) -> bool {
+				return DB.GetExistingIds(Ids, Found);
+			};
+		};
+		//	Tables without name/description only report which ids exist, like their ExpandFunc_.
+		auto AddExpand = [this](auto &DB, bool Named) {
+			BatchExpandFunc_[DB.Prefix()] = [&DB, Named](const Types::StringVec &Ids,
+														 ORM::NameAndDescriptionMap &Found) -> bool {
+				if (Named)
+					return DB.GetNamesAndDescriptions(Ids, Found);
+				std::set<std::string> Existing;
+				if (!DB.GetExistingIds(Ids, Existing))
+					return false;
+				for (const auto &Id : Existing)
+					Found[Id];
+				return true;
+			};
+		};
+
+		AddExist(*EntityDB_);
+		AddExist(*PolicyDB_);
+		AddExist(*VenueDB_);
+		AddExist(*ContactDB_);
+		AddExist(*InventoryDB_);
+		AddExist(*ConfigurationDB_);
+		AddExist(*LocationDB_);
+		AddExist(*RolesDB_);
+		AddExist(*MapDB_);
+		AddExist(*SignupDB_);
+		AddExist(*VariablesDB_);
+		AddExist(*OperatorDB_);
+		AddExist(*ServiceClassDB_);
+		AddExist(*SubscriberDeviceDB_);
+		AddExist(*OpLocationDB_);
+		AddExist(*OpContactDB_);
+		AddExist(*GLBLRAccountInfoDB_);
+		AddExist(*GLBLRCertsDB_);
+		AddExist(*OrionAccountsDB_);
+		AddExist(*RadiusEndpointDB_);
+
+		AddExpand(*EntityDB_, true);
+		AddExpand(*PolicyDB_, true);
+		AddExpand(*VenueDB_, true);
+		AddExpand(*ContactDB_, true);
+		AddExpand(*InventoryDB_, true);
+		AddExpand(*ConfigurationDB_, true);
+		AddExpand(*LocationDB_, true);
+		AddExpand(*RolesDB_, true);
+		AddExpand(*OperatorDB_, true);
+		AddExpand(*ServiceClassDB_, true);
+		AddExpand(*SubscriberDeviceDB_, true);
+		AddExpand(*OpLocationDB_, true);
+		AddExpand(*OpContactDB_, true);
+		AddExpand(*MapDB_, false);
+		AddExpand(*SignupDB_, false);
+		AddExpand(*VariablesDB_, false);
+	}
+
+	//	Groups prefix:uuid entries by prefix and finds which ones exist with one query per prefix.
+	//	Prefixes without a batch lookup are left out of Existing.
+	void Storage::FindExisting(const Types::StringVec &UUIDs,
+							   std::map<std::string, std::set<std::string>> &Existing) {
+		std::map<std::string, Types::StringVec> ByPrefix;
+		for (const auto &i : UUIDs) {
+			auto uuid_parts = Utils::Split(i, ':');
+			if (uuid_parts.size() == 2 && BatchExistFunc_.find(uuid_parts[0]) != BatchExistFunc_.end())
+				ByPrefix[uuid_parts[0]].push_back(uuid_parts[1]);
+		}
+		for (const auto &[Prefix, Ids] : ByPrefix)
+			BatchExistFunc_[Prefix](Ids, Existing[Prefix]);
+	}
+
 	bool Storage::Validate(const Poco::URI::QueryParameters &P, RESTAPI::Errors::msg &Error) {
-		for (const auto &i : P) {
-			auto uuid_parts = Utils::Split(i.second, ':');
+		Types::StringVec UUIDs;
+		for (const auto &i : P)
+			UUIDs.push_back(i.second);
+		std::map<std::string, std::set<std::string>> Existing;
+		FindExisting(UUIDs, Existing);
+
+		for (const auto &i : UUIDs) {
+			auto uuid_parts = Utils::Split(i, ':');
 			if (uuid_parts.size() == 2) {
+				auto Found = Existing.find(uuid_parts[0]);
+				if (Found != Existing.end()) {
+					if (Found->second.find(uuid_parts[1]) == Found->second.end()) {
+						Error = RESTAPI::Errors::UnknownId;
+						return false;
+					}
+					continue;
+				}
 				auto F = ExistFunc_.find(uuid_parts[0]);
 				if (F != ExistFunc_.end()) {
 					if (!F->second("id", uuid_parts[1])) {
@@ -307,9 +406,19 @@ namespace OpenWifi {
 	}
 
 	bool Storage::Validate(const Types::StringVec &P, std::string &Error) {
+		std::map<std::string, std::set<std::string>> Existing;
+		FindExisting(P, Existing);
+
 		for (const auto &i : P) {
-			if (!ValidateSingle(i, Error))
+			auto uuid_parts = Utils::Split(i, ':');
+			auto Found = uuid_parts.size() == 2 ? Existing.find(uuid_parts[0]) : Existing.end();
+			if (Found == Existing.end()) {
+				if (!ValidateSingle(i, Error))
+					return false;
+			} else if (Found->second.find(uuid_parts[1]) == Found->second.end()) {
+				Error = "Unknown " + Found->first + " UUID:" + uuid_parts[1];
 				return false;
+			}
 		}
 		if (Error.empty())
 			return true;
@@ -323,57 +432,101 @@ namespace OpenWifi {
 
 	bool Storage::ExpandInUse(const Types::StringVec &UUIDs, ExpandedListMap &Map,
 							  std::vector<std::string> &Errors) {
+		std::map<std::string, Types::StringVec> ByPrefix;
+		for (const auto &i : UUIDs) {
+			auto uuid_parts = Utils::Split(i, ':');
+			if (uuid_parts.size() == 2 &&
+				BatchExpandFunc_.find(uuid_parts[0]) != BatchExpandFunc_.end())
+				ByPrefix[uuid_parts[0]].push_back(uuid_parts[1]);
+		}
+		std::map<std::string, ORM::NameAndDescriptionMap> Expanded;
+		for (const auto &[Prefix, Ids] : ByPrefix)
+			BatchExpandFunc_[Prefix](Ids, Expanded[Prefix]);
+
 		for (const auto &i : UUIDs) {
 			auto uuid_parts = Utils::Split(i, ':');
 			if (uuid_parts.size() == 2) {
-				auto F = ExpandFunc_.find(uuid_parts[0]);
-				if (F != ExpandFunc_.end()) {
-					std::string Name, Description;
+				std::string Name, Description;
+				auto Batch = Expanded.find(uuid_parts[0]);
+				if (Batch != Expanded.end()) {
+					auto Entry = Batch->second.find(uuid_parts[1]);
+					if (Entry == Batch->second.end()) {
+						Errors.push_back(i);
+						continue;
+					}
+					Name = Entry->second.Name;
+					Description = Entry->second.Description;
+				} else {
+					auto F = ExpandFunc_.find(uuid_parts[0]);
+					if (F == ExpandFunc_.end())
+						continue;
 					if (!F->second("id", uuid_parts[1], Name, Description)) {
 						Errors.push_back(i);
-					} else {
-						auto Hint = Map.find(uuid_parts[0]);
-						ProvObjects::ExpandedUseEntry X{
-							.uuid = uuid_parts[1], .name = Name, .description = Description};
-						if (Hint == Map.end()) {
-							ProvObjects::ExpandedUseEntryList L;
-							L.type = uuid_parts[0];
-							L.entries.push_back(X);
-							Map[uuid_parts[0]] = L;
-						} else {
-							Hint->second.entries.push_back(X);
-						}
+						continue;
 					}
 				}
+				auto Hint = Map.find(uuid_parts[0]);
+				ProvObjects::ExpandedUseEntry X{
+					.uuid = uuid_parts[1], .name = Name, .description = Description};
+				if (Hint == Map.end()) {
+					ProvObjects::ExpandedUseEntryList L;
+					L.type = uuid_parts[0];
+					L.entries.push_back(X);
+					Map[uuid_parts[0]] = L;
+				} else {
+					Hint->second.entries.push_back(X);
+				}
 			}
 		}
 		return true;
 	}
 
+	//	Parent/child lists that only change through AddDevice, AddInUse... are kept one row per
+	//	member in the memberships table instead of a serialized vector in the parent row.
+	void Storage::NormalizeMemberships() {
+		auto Members = MembershipDB_.get();
+		EntityDB_->NormalizeMembers(Members, &ProvObjects::Entity::children, "children");
+		EntityDB_->NormalizeMembers(Members, &ProvObjects::Entity::venues, "venues");
+		EntityDB_->NormalizeMembers(Members, &ProvObjects::Entity::devices, "devices");
+		VenueDB_->NormalizeMembers(Members, &ProvObjects::Venue::children, "children");
+		VenueDB_->NormalizeMembers(Members, &ProvObjects::Venue::devices, "devices");
+		PolicyDB_->NormalizeMembers(Members, &ProvObjects::ManagementPolicy::inUse, "inUse");
+		LocationDB_->NormalizeMembers(Members, &ProvObjects::Location::inUse, "inUse");
+		ContactDB_->NormalizeMembers(Members, &ProvObjects::Contact::inUse, "inUse");
+		ConfigurationDB_->NormalizeMembers(Members, &ProvObjects::DeviceConfiguration::inUse,
+										   "inUse");
+
+		EntityDB_->MigrateMembers();
+		VenueDB_->MigrateMembers();
+		PolicyDB_->MigrateMembers();
+		LocationDB_->MigrateMembers();
+		ContactDB_->MigrateMembers();
+		ConfigurationDB_->MigrateMembers();
+	}
+
 	void Storage::ConsistencyCheck() {
 
 		// check that all inventory in venues and entities actually exists, if not, fix it.
 		auto FixVenueDevices = [&](const ProvObjects::Venue &V) -> bool {
-			Types::UUIDvec_t NewDevices;
-			bool modified = false;
+			Types::UUIDvec_t MissingDevices;
+			std::set<std::string> ExistingDevices;
+			if (!InventoryDB().GetExistingIds(V.devices, ExistingDevices))
+				return true;
 			for (const auto &device : V.devices) {
-				ProvObjects::InventoryTag T;
-				if (InventoryDB().GetRecord("id", device, T)) {
-					NewDevices.emplace_back(device);
-				} else {
-					modified = true;
-				}
+				if (ExistingDevices.find(device) == ExistingDevices.end())
+					MissingDevices.emplace_back(device);
 			}
 
-			ProvObjects::Venue NewVenue = V;
-			if (V.deviceRules.rrm == "yes") {
-				NewVenue.deviceRules.rrm = "inherit";
-				modified = true;
+			if (!MissingDevices.empty()) {
+				poco_warning(Logger(), fmt::format("  fixing venue devices: {}", V.info.name));
+				VenueDB().ManipulateVectorMembers(&ProvObjects::Venue::devices, "id", V.info.id,
+												  MissingDevices, false);
 			}
 
-			if (modified) {
+			if (V.deviceRules.rrm == "yes") {
 				poco_warning(Logger(), fmt::format("  fixing venue: {}", V.info.name));
-				NewVenue.devices = NewDevices;
+				ProvObjects::Venue NewVenue = V;
+				NewVenue.deviceRules.rrm = "inherit";
 				VenueDB().UpdateRecord("id", V.info.id, NewVenue);
 			}
 
@@ -381,15 +534,14 @@ namespace OpenWifi {
 		};
 
 		auto FixEntity = [&](const ProvObjects::Entity &E) -> bool {
-			Types::UUIDvec_t NewDevices;
+			Types::UUIDvec_t MissingDevices;
 			bool Modified = false;
+			std::set<std::string> ExistingDevices;
+			if (!InventoryDB().GetExistingIds(E.devices, ExistingDevices))
+				return true;
 			for (const auto &device : E.devices) {
-				ProvObjects::InventoryTag T;
-				if (InventoryDB().GetRecord("id", device, T)) {
-					NewDevices.emplace_back(device);
-				} else {
-					Modified = true;
-				}
+				if (ExistingDevices.find(device) == ExistingDevices.end())
+					MissingDevices.emplace_back(device);
 			}
 
 			Types::UUIDvec_t NewContacts;
@@ -412,14 +564,18 @@ namespace OpenWifi {
 				}
 			}
 
-			Types::UUIDvec_t NewVenues;
+			Types::UUIDvec_t MissingVenues;
 			for (const auto &venue : E.venues) {
-				ProvObjects::Venue V;
-				if (VenueDB().GetRecord("id", venue, V)) {
-					NewVenues.emplace_back(venue);
-				} else {
-					Modified = true;
-				}
+				if (!VenueDB().Exists("id", venue))
+					MissingVenues.emplace_back(venue);
+			}
+
+			if (!MissingDevices.empty() || !MissingVenues.empty()) {
+				poco_warning(Logger(), fmt::format("  fixing entity members: {}", E.info.name));
+				EntityDB().ManipulateVectorMembers(&ProvObjects::Entity::devices, "id", E.info.id,
+												   MissingDevices, false);
+				EntityDB().ManipulateVectorMembers(&ProvObjects::Entity::venues, "id", E.info.id,
+												   MissingVenues, false);
 			}
 
 			Types::UUIDvec_t NewVariables;
@@ -441,10 +597,8 @@ namespace OpenWifi {
 
 			if (Modified) {
 				poco_warning(Logger(), fmt::format("  fixing entity: {}", E.info.name));
-				NewEntity.devices = NewDevices;
 				NewEntity.contacts = NewContacts;
 				NewEntity.locations = NewLocations;
-				NewEntity.venues = NewVenues;
 				NewEntity.variables = NewVariables;
 				EntityDB().UpdateRecord("id", E.info.id, NewEntity);
 			}
@@ -483,6 +637,9 @@ namespace OpenWifi {
 			if (modified) {
 				poco_warning(Logger(), fmt::format("  fixing entity: {}", T.info.name));
 				InventoryDB().UpdateRecord("id", T.info.id, NewTag);
+				if (NewTag.venue != T.venue || NewTag.entity != T.entity)
+					SerialNumberCache()->AddSerialNumber(NewTag.serialNumber, NewTag.deviceType,
+														 NewTag.venue, NewTag.entity);
 			}
 			return true;
 		};
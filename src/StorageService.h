@@ -17,6 +17,7 @@
 #include "storage/storage_location.h"
 #include "storage/storage_management_roles.h"
 #include "storage/storage_maps.h"
+#include "storage/storage_membership.h"
 #include "storage/storage_op_contacts.h"
 #include "storage/storage_op_locations.h"
 #include "storage/storage_operataor.h"
@@ -32,6 +33,7 @@
 #include "storage/storage_glblrcerts.h"
 #include "storage/storage_orion_accounts.h"
 #include "storage/storage_radius_endpoints.h"
+#include "storage/storage_scheduled_jobs.h"
 
 #include "Poco/URI.h"
 #include "framework/ow_constants.h"
@@ -74,6 +76,8 @@ namespace OpenWifi {
         inline OpenWifi::GLBLRCertsDB &GLBLRCertsDB() { return *GLBLRCertsDB_; }
         inline OpenWifi::OrionAccountsDB &OrionAccountsDB() { return *OrionAccountsDB_; }
         inline OpenWifi::RadiusEndpointDB &RadiusEndpointDB() { return *RadiusEndpointDB_; }
+        inline OpenWifi::MembershipDB &MembershipDB() { return *MembershipDB_; }
+        inline OpenWifi::ScheduledJobsDB &ScheduledJobsDB() { return *ScheduledJobsDB_; }
 
 		bool Validate(const Poco::URI::QueryParameters &P, RESTAPI::Errors::msg &Error);
 		bool Validate(const Types::StringVec &P, std::string &Error);
@@ -137,6 +141,8 @@ namespace OpenWifi {
         std::unique_ptr<OpenWifi::GLBLRCertsDB> GLBLRCertsDB_;
         std::unique_ptr<OpenWifi::OrionAccountsDB> OrionAccountsDB_;
         std::unique_ptr<OpenWifi::RadiusEndpointDB> RadiusEndpointDB_;
+        std::unique_ptr<OpenWifi::MembershipDB> MembershipDB_;
+        std::unique_ptr<OpenWifi::ScheduledJobsDB> ScheduledJobsDB_;
 		std::string DefaultOperator_;
 
 		typedef std::function<bool(const char *FieldName, std::string &Value)> exist_func;
@@ -145,11 +151,22 @@ namespace OpenWifi {
 			expand_func;
 		std::map<std::string, exist_func> ExistFunc_;
 		std::map<std::string, expand_func> ExpandFunc_;
+		//	Same lookups for a whole list of ids of one prefix, in one query per batch of ids.
+		typedef std::function<bool(const Types::StringVec &Ids, std::set<std::string> &Found)>
+			batch_exist_func;
+		typedef std::function<bool(const Types::StringVec &Ids, ORM::NameAndDescriptionMap &Found)>
+			batch_expand_func;
+		std::map<std::string, batch_exist_func> BatchExistFunc_;
+		std::map<std::string, batch_expand_func> BatchExpandFunc_;
 		Poco::Timer Timer_;
 		std::unique_ptr<Poco::TimerCallback<Storage>> TimerCallback_;
 
 		void ConsistencyCheck();
 		void InitializeSystemDBs();
+		void NormalizeMemberships();
+		void InitializeBatchLookups();
+		void FindExisting(const Types::StringVec &UUIDs,
+						  std::map<std::string, std::set<std::string>> &Existing);
 	};
 
 	inline auto StorageService() { return Storage::instance(); }
@@ -3,23 +3,275 @@
 //
 
 #include "TagServer.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "Poco/String.h"
+
 #include "StorageService.h"
+#include "framework/orm_events.h"
 #include "framework/utils.h"
 
+#include "fmt/format.h"
+
 namespace OpenWifi {
 	int TagServer::Start() {
+		poco_information(Logger(), "Starting...");
+		LoadDictionary();
+		LoadObjects();
 
-		//  we need to get the entire dictionary in memory...
-		// std::function<bool(const TagsDictionary &)> Function = [](const TagsDictionary &D) ->
-		// bool { return  true; };
-		StorageService()->TagsDictionaryDB().Iterate(
-			[]([[maybe_unused]] const TagsDictionary &D) -> bool { return true; });
-
+		auto &Storage = *StorageService();
+		ORM::ChangeFeed()->Subscribe(
+			Storage.TagsObjectDB().TableName(),
+			[this](const std::string &, const std::vector<std::string> &Arns) {
+				if (Arns.empty())
+					return LoadObjects();
+				Reload(Arns);
+			});
+		ORM::ChangeFeed()->Subscribe(
+			Storage.TagsDictionaryDB().TableName(),
+			[this](const std::string &, const std::vector<std::string> &) { LoadDictionary(); });
 		return 0;
 	}
 
-	void TagServer::Stop() {}
+	void TagServer::Stop() {
+		poco_information(Logger(), "Stopping...");
+		poco_information(Logger(), "Stopped...");
+	}
+
+	void TagServer::LoadDictionary() {
+		EntityToDict E2D;
+		StorageService()->TagsDictionaryDB().Iterate([&](const TagsDictionary &D) -> bool {
+			auto &Dict = E2D[D.entity];
+			//	Two replicas adding the same name at once briefly leave two rows: the smallest
+			//	id is the one kept.
+			auto Hint = Dict.find(D.name);
+			if (Hint == Dict.end() || D.id < Hint->second)
+				Dict[D.name] = D.id;
+			return true;
+		});
+		std::lock_guard G(Mutex_);
+		E2D_.swap(E2D);
+	}
+
+	void TagServer::LoadObjects() {
+		std::vector<TagsObject> Objects;
+		StorageService()->TagsObjectDB().Iterate([&](const TagsObject &T) -> bool {
+			Objects.push_back(T);
+			return true;
+		});
+
+		std::lock_guard G(Mutex_);
+		Index_.Clear();
+		Index_.Reserve(Objects.size());
+		for (auto &T : Objects)
+			Index_.Insert(std::move(T));
+		poco_information(Logger(), fmt::format("Indexed {} tagged objects, {} distinct tags.",
+											   Index_.ObjectCount(), Index_.TagCount()));
+	}
+
+	void TagServer::Reload(const std::vector<std::string> &Arns) {
+		for (const auto &Arn : Arns) {
+			TagsObject T;
+			auto Found = StorageService()->TagsObjectDB().GetRecord("arn", Arn, T);
+			std::lock_guard G(Mutex_);
+			Index_.Erase(Arn);
+			if (Found)
+				Index_.Insert(std::move(T));
+		}
+	}
+
+	Types::StringVec TagIndex::Terms(const Types::StringVec &Entries) {
+		Types::StringVec Result;
+		for (const auto &Entry : Entries) {
+			auto Tag = Poco::trim(Entry);
+			if (Tag.empty())
+				continue;
+			Result.push_back(Tag);
+			auto Equal = Tag.find('=');
+			if (Equal != std::string::npos)
+				Result.push_back(Tag.substr(0, Equal));
+		}
+		std::sort(Result.begin(), Result.end());
+		Result.erase(std::unique(Result.begin(), Result.end()), Result.end());
+		return Result;
+	}
+
+	void TagIndex::Clear() {
+		Objects_.clear();
+		Ordinals_.clear();
+		Free_.clear();
+		Index_.clear();
+	}
+
+	void TagIndex::Reserve(std::size_t Objects) {
+		Objects_.reserve(Objects);
+		Ordinals_.reserve(Objects);
+	}
+
+	void TagIndex::Insert(TagsObject &&T) {
+		uint32_t Ordinal;
+		if (Free_.empty()) {
+			Ordinal = (uint32_t)Objects_.size();
+			Objects_.emplace_back();
+		} else {
+			Ordinal = Free_.back();
+			Free_.pop_back();
+		}
+		for (const auto &Term : Terms(T.entries)) {
+			auto &P = Index_[Term];
+			if (P.empty() || P.back() < Ordinal)
+				P.push_back(Ordinal);
+			else
+				P.insert(std::lower_bound(P.begin(), P.end(), Ordinal), Ordinal);
+		}
+		Ordinals_[T.arn] = Ordinal;
+		Objects_[Ordinal] = std::move(T);
+	}
 
-	void TagServer::run() { Utils::SetThreadName("tag-server"); }
+	void TagIndex::Erase(const std::string &Arn) {
+		auto Hint = Ordinals_.find(Arn);
+		if (Hint == Ordinals_.end())
+			return;
+		auto Ordinal = Hint->second;
+		for (const auto &Term : Terms(Objects_[Ordinal].entries)) {
+			auto Posting = Index_.find(Term);
+			if (Posting == Index_.end())
+				continue;
+			auto &P = Posting->second;
+			auto At = std::lower_bound(P.begin(), P.end(), Ordinal);
+			if (At != P.end() && *At == Ordinal)
+				P.erase(At);
+			if (P.empty())
+				Index_.erase(Posting);
+		}
+		Objects_[Ordinal] = TagsObject{};
+		Free_.push_back(Ordinal);
+		Ordinals_.erase(Hint);
+	}
+
+	const TagsObject *TagIndex::Get(const std::string &Arn) const {
+		auto Hint = Ordinals_.find(Arn);
+		return Hint == Ordinals_.end() ? nullptr : &Objects_[Hint->second];
+	}
+
+	//	Ids are allocated by the database, outside the lock.
+	void TagServer::AddToDictionary(const TagsObject &T) {
+		Types::StringVec Missing;
+		{
+			std::lock_guard G(Mutex_);
+			const auto &Dict = E2D_[T.entity];
+			for (const auto &Entry : T.entries) {
+				auto Name = Poco::trim(Entry.substr(0, Entry.find('=')));
+				if (!Name.empty() && Dict.find(Name) == Dict.end())
+					Missing.push_back(Name);
+			}
+		}
+		for (const auto &Name : Missing) {
+			uint32_t Id;
+			if (!StorageService()->TagsDictionaryDB().AddTag(T.entity, Name, Id))
+				continue;
+			std::lock_guard G(Mutex_);
+			E2D_[T.entity][Name] = Id;
+		}
+	}
+
+	bool TagServer::SetTags(const std::string &Arn, const std::string &Entity,
+							const Types::StringVec &Entries) {
+		TagsObject T{Entity, Arn, Entries};
+		auto &DB = StorageService()->TagsObjectDB();
+		auto Done = DB.Exists("arn", Arn) ? DB.UpdateRecord("arn", Arn, T) : DB.CreateRecord(T);
+		if (!Done)
+			return false;
+
+		AddToDictionary(T);
+		std::lock_guard G(Mutex_);
+		Index_.Erase(Arn);
+		Index_.Insert(std::move(T));
+		return true;
+	}
+
+	bool TagServer::RemoveTags(const std::string &Arn) {
+		if (!StorageService()->TagsObjectDB().DeleteRecord("arn", Arn))
+			return false;
+		std::lock_guard G(Mutex_);
+		Index_.Erase(Arn);
+		return true;
+	}
+
+	bool TagServer::GetTags(const std::string &Arn, TagsObject &T) {
+		std::lock_guard G(Mutex_);
+		auto Found = Index_.Get(Arn);
+		if (Found == nullptr)
+			return false;
+		T = *Found;
+		return true;
+	}
+
+	uint64_t TagIndex::Find(const Types::StringVec &Tags, const std::string &Prefix,
+							uint64_t Offset, uint64_t Limit, Types::StringVec &Arns) const {
+		std::vector<const Postings *> Lists;
+		for (const auto &Tag : Tags) {
+			auto Hint = Index_.find(Poco::trim(Tag));
+			if (Hint == Index_.end())
+				return 0;
+			Lists.push_back(&Hint->second);
+		}
+		if (Lists.empty())
+			return 0;
+		std::sort(Lists.begin(), Lists.end(),
+				  [](const Postings *L, const Postings *R) { return L->size() < R->size(); });
+
+		Postings Result(*Lists.front());
+		for (std::size_t i = 1; i < Lists.size() && !Result.empty(); ++i) {
+			const auto &Next = *Lists[i];
+			Postings Common;
+			//	Much longer lists are probed rather than walked.
+			if (Next.size() / 32 > Result.size()) {
+				std::copy_if(Result.begin(), Result.end(), std::back_inserter(Common),
+							 [&Next](uint32_t O) {
+								 return std::binary_search(Next.begin(), Next.end(), O);
+							 });
+			} else {
+				std::set_intersection(Result.begin(), Result.end(), Next.begin(), Next.end(),
+									  std::back_inserter(Common));
+			}
+			Result.swap(Common);
+		}
+
+		auto ArnPrefix = Prefix.empty() ? Prefix : Prefix + ":";
+		uint64_t Total = 0;
+		for (const auto Ordinal : Result) {
+			const auto &Arn = Objects_[Ordinal].arn;
+			if (Arn.compare(0, ArnPrefix.size(), ArnPrefix) != 0)
+				continue;
+			if (Total >= Offset && (Limit == 0 || Arns.size() < Limit))
+				Arns.push_back(Arn);
+			++Total;
+		}
+		return Total;
+	}
+
+	uint64_t TagServer::Find(const Types::StringVec &Tags, const std::string &Prefix,
+							 uint64_t Offset, uint64_t Limit, Types::StringVec &Arns) {
+		std::lock_guard G(Mutex_);
+		return Index_.Find(Tags, Prefix, Offset, Limit, Arns);
+	}
+
+	void TagServer::DictionaryToJson(Poco::JSON::Object &Obj) {
+		std::lock_guard G(Mutex_);
+		Poco::JSON::Array Entries;
+		for (const auto &[Entity, Dict] : E2D_) {
+			for (const auto &[Name, Id] : Dict) {
+				Poco::JSON::Object E;
+				E.set("entity", Entity);
+				E.set("id", Id);
+				E.set("name", Name);
+				Entries.add(E);
+			}
+		}
+		Obj.set("dictionary", Entries);
+	}
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
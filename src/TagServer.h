@@ -4,11 +4,51 @@
 
 #pragma once
 
+#include <unordered_map>
+
+#include "Poco/JSON/Object.h"
+
 #include "framework/SubSystemServer.h"
+#include "storage/storage_tags.h"
 
 namespace OpenWifi {
 
-	class TagServer : public SubSystemServer, Poco::Runnable {
+	//	Every tagged object, numbered so each tag maps to a plain sorted list of object numbers.
+	//	An entry "key=value" is found both by "key=value" and by "key"; an entry "key" only by
+	//	"key". A query for several tags intersects their lists, starting with the shortest. Not
+	//	thread safe: TagServer guards it with its mutex.
+	class TagIndex {
+	  public:
+		void Clear();
+		void Reserve(std::size_t Objects);
+		void Insert(TagsObject &&T);
+		void Erase(const std::string &Arn);
+		[[nodiscard]] const TagsObject *Get(const std::string &Arn) const;
+
+		//	Objects carrying all the Tags, restricted to one ARN prefix (i.e. "inv") when given.
+		//	Returns the total number of matches; Arns holds the ones within Offset and Limit.
+		uint64_t Find(const Types::StringVec &Tags, const std::string &Prefix, uint64_t Offset,
+					  uint64_t Limit, Types::StringVec &Arns) const;
+
+		[[nodiscard]] inline std::size_t ObjectCount() const { return Ordinals_.size(); }
+		[[nodiscard]] inline std::size_t TagCount() const { return Index_.size(); }
+
+		static Types::StringVec Terms(const Types::StringVec &Entries);
+
+	  private:
+		typedef std::vector<uint32_t> Postings;
+
+		std::vector<TagsObject> Objects_;
+		std::unordered_map<std::string, uint32_t> Ordinals_;
+		std::vector<uint32_t> Free_;
+		std::unordered_map<std::string, Postings> Index_;
+	};
+
+	//	Tags attached to objects (TagsObjectDB), kept in memory in a TagIndex.
+	//
+	//	Tags changed here are indexed right away. Changes made by other replicas arrive through
+	//	the ORM change feed.
+	class TagServer : public SubSystemServer {
 	  public:
 		typedef std::map<std::string, uint32_t> DictMap;
 		typedef std::map<std::string, DictMap> EntityToDict;
@@ -20,12 +60,25 @@ namespace OpenWifi {
 
 		int Start() override;
 		void Stop() override;
-		void run() override;
+
+		bool SetTags(const std::string &Arn, const std::string &Entity,
+					 const Types::StringVec &Entries);
+		bool RemoveTags(const std::string &Arn);
+		bool GetTags(const std::string &Arn, TagsObject &T);
+		//	See TagIndex::Find.
+		uint64_t Find(const Types::StringVec &Tags, const std::string &Prefix, uint64_t Offset,
+					  uint64_t Limit, Types::StringVec &Arns);
+
+		void DictionaryToJson(Poco::JSON::Object &Obj);
 
 	  private:
-		Poco::Thread Worker_;
-		std::atomic_bool Running_ = false;
 		EntityToDict E2D_;
+		TagIndex Index_;
+
+		void LoadDictionary();
+		void LoadObjects();
+		void Reload(const std::vector<std::string> &Arns);
+		void AddToDictionary(const TagsObject &T);
 
 		TagServer() noexcept : SubSystemServer("TagServer", "TAGS", "tags") {}
 	};
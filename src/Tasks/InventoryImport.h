@@ -0,0 +1,164 @@
+#pragma once
+
+#include "JobController.h"
+#include "SerialNumberCache.h"
+#include "StorageService.h"
+#include "UI_Prov_WebSocketNotifications.h"
+#include "framework/MicroServiceFuncs.h"
+#include "sdks/SDK_gw.h"
+
+namespace OpenWifi {
+
+	//	Pushes entity/venue/subscriber ownership to the gateway for a slice of imported devices.
+	class InventoryImportGWSync : public Poco::Runnable {
+	  public:
+		InventoryImportGWSync(const ProvObjects::InventoryTagVec &Devices, std::size_t First,
+							  std::size_t Stride, std::atomic_uint64_t &Updated,
+							  std::atomic_uint64_t &Failed)
+			: Devices_(Devices), First_(First), Stride_(Stride), Updated_(Updated),
+			  Failed_(Failed) {}
+
+		void run() final {
+			for (auto i = First_; i < Devices_.size(); i += Stride_) {
+				const auto &Device = Devices_[i];
+				if (Device.entity.empty() && Device.venue.empty() && Device.subscriber.empty())
+					continue;
+				if (SDK::GW::Device::SetOwnerShip(nullptr, Device.serialNumber, Device.entity,
+												  Device.venue, Device.subscriber))
+					Updated_++;
+				else
+					Failed_++;
+			}
+		}
+
+	  private:
+		const ProvObjects::InventoryTagVec &Devices_;
+		std::size_t First_, Stride_;
+		std::atomic_uint64_t &Updated_;
+		std::atomic_uint64_t &Failed_;
+	};
+
+	//	Creates already validated inventory records in batches, then fixes the parent membership
+	//	once per parent and finally syncs the gateway in the background.
+	class InventoryImport : public Job {
+	  public:
+		static constexpr std::size_t BatchSize = 500;
+		static constexpr std::size_t GWSyncThreads = 8;
+
+		InventoryImport(const std::string &JobID, const std::string &name,
+						const std::vector<std::string> &parameters, uint64_t when,
+						const SecurityObjects::UserInfo &UI, Poco::Logger &L,
+						ProvObjects::InventoryTagVec &&Devices)
+			: Job(JobID, name, parameters, when, UI, L), Devices_(std::move(Devices)) {}
+
+		inline virtual void run() final {
+			Utils::SetThreadName("inv-import");
+
+			ProvWebSocketNotifications::InventoryImportProgress_t N;
+			N.content.jobId = JobId();
+			N.content.title = fmt::format("Importing {} devices.", Devices_.size());
+			N.content.total = Devices_.size();
+
+			auto &DB = StorageService()->InventoryDB();
+			ProvObjects::InventoryTagVec Created;
+			Created.reserve(Devices_.size());
+			for (std::size_t From = 0; From < Devices_.size(); From += BatchSize) {
+				auto To = std::min(Devices_.size(), From + BatchSize);
+				ProvObjects::InventoryTagVec Batch(Devices_.begin() + From, Devices_.begin() + To);
+				if (DB.CreateRecords(Batch)) {
+					Created.insert(Created.end(), Batch.begin(), Batch.end());
+				} else {
+					//	Something in this batch was rejected, most likely a serial number created
+					//	since validation. Isolate it by falling back to single inserts.
+					for (const auto &Device : Batch) {
+						if (DB.CreateRecord(Device)) {
+							Created.push_back(Device);
+						} else {
+							N.content.failed++;
+							N.content.errors.push_back(Device.serialNumber);
+						}
+					}
+				}
+				N.content.imported = Created.size();
+				N.content.timeStamp = Utils::Now();
+				ProvWebSocketNotifications::InventoryImportUpdate(UserInfo().email, N);
+			}
+
+			UpdateParents(Created);
+
+			std::vector<SerialNumberCache::SerialEntry> Entries;
+			Entries.reserve(Created.size());
+			for (const auto &Device : Created)
+				Entries.emplace_back(SerialNumberCache::SerialEntry{
+					Device.serialNumber, Device.deviceType, Device.venue, Device.entity});
+			SerialNumberCache()->AddSerialNumbers(Entries);
+
+			std::atomic_uint64_t GWUpdated = 0, GWFailed = 0;
+			{
+				Poco::ThreadPool Pool(1, GWSyncThreads);
+				std::vector<std::unique_ptr<InventoryImportGWSync>> Workers;
+				for (std::size_t i = 0; i < GWSyncThreads && i < Created.size(); ++i) {
+					Workers.emplace_back(std::make_unique<InventoryImportGWSync>(
+						Created, i, GWSyncThreads, GWUpdated, GWFailed));
+					Pool.start(*Workers.back());
+				}
+				Pool.joinAll();
+			}
+
+			N.content.gwUpdated = GWUpdated;
+			N.content.gwFailed = GWFailed;
+			N.content.done = true;
+			N.content.timeStamp = Utils::Now();
+			N.content.details = fmt::format(
+				"Job {} Completed: {} imported, {} failed, {} gateway updates, {} gateway failures.",
+				JobId(), N.content.imported, N.content.failed, N.content.gwUpdated,
+				N.content.gwFailed);
+			ProvWebSocketNotifications::InventoryImportUpdate(UserInfo().email, N);
+			poco_information(Logger(), N.content.details);
+			Utils::SetThreadName("free");
+			Complete();
+		}
+
+	  private:
+		ProvObjects::InventoryTagVec Devices_;
+
+		inline void UpdateParents(const ProvObjects::InventoryTagVec &Created) {
+			using ParentMap = std::map<std::string, std::vector<std::string>>;
+			ParentMap Venues, Entities, Policies, Locations, Contacts, Configurations;
+			auto &DB = StorageService()->InventoryDB();
+			auto InUse = [&DB](const std::string &Id) { return DB.Prefix() + ":" + Id; };
+
+			for (const auto &Device : Created) {
+				if (!Device.venue.empty())
+					Venues[Device.venue].push_back(Device.info.id);
+				if (!Device.entity.empty())
+					Entities[Device.entity].push_back(Device.info.id);
+				if (!Device.managementPolicy.empty())
+					Policies[Device.managementPolicy].push_back(InUse(Device.info.id));
+				if (!Device.location.empty())
+					Locations[Device.location].push_back(InUse(Device.info.id));
+				if (!Device.contact.empty())
+					Contacts[Device.contact].push_back(InUse(Device.info.id));
+				if (!Device.deviceConfiguration.empty())
+					Configurations[Device.deviceConfiguration].push_back(InUse(Device.info.id));
+			}
+
+			for (const auto &[Parent, Children] : Venues)
+				StorageService()->VenueDB().AddDevices("id", Parent, Children);
+			for (const auto &[Parent, Children] : Entities)
+				StorageService()->EntityDB().AddDevices("id", Parent, Children);
+			for (const auto &[Parent, Children] : Policies)
+				StorageService()->PolicyDB().ManipulateVectorMembers(
+					&ProvObjects::ManagementPolicy::inUse, "id", Parent, Children, true);
+			for (const auto &[Parent, Children] : Locations)
+				StorageService()->LocationDB().ManipulateVectorMembers(
+					&ProvObjects::Location::inUse, "id", Parent, Children, true);
+			for (const auto &[Parent, Children] : Contacts)
+				StorageService()->ContactDB().ManipulateVectorMembers(
+					&ProvObjects::Contact::inUse, "id", Parent, Children, true);
+			for (const auto &[Parent, Children] : Configurations)
+				StorageService()->ConfigurationDB().ManipulateVectorMembers(
+					&ProvObjects::DeviceConfiguration::inUse, "id", Parent, Children, true);
+		}
+	};
+} // namespace OpenWifi
@@ -6,6 +6,7 @@
 
 #include "APConfig.h"
 #include "JobController.h"
+#include "OwnershipRing.h"
 #include "StorageService.h"
 #include "UI_Prov_WebSocketNotifications.h"
 #include "framework/MicroServiceFuncs.h"
@@ -137,99 +138,97 @@ namespace OpenWifi {
 						   const SecurityObjects::UserInfo &UI, Poco::Logger &L)
 			: Job(JobID, name, parameters, when, UI, L) {}
 
+		//	Returns early when pacing holds back the next device, and continues from it when run
+		//	again.
 		inline virtual void run() {
 			std::string VenueUUID_;
 
 			Utils::SetThreadName("venue-update");
 			VenueUUID_ = Parameter(0);
 
-			ProvWebSocketNotifications::ConfigUpdateList_t N;
-
-			ProvObjects::Venue Venue;
-			uint64_t Updated = 0, Failed = 0, BadConfigs = 0;
-			if (StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
-
-				N.content.title = fmt::format("Updating {} configurations", Venue.info.name);
-				N.content.jobId = JobId();
-
-				Poco::ThreadPool Pool_;
-				std::list<VenueDeviceConfigUpdater *> JobList;
-                std::vector<std::string> DeviceList;
-                StorageService()->InventoryDB().GetDevicesUUIDForVenue(Venue.info.id, DeviceList);
-				for (const auto &uuid : DeviceList) {
-					auto NewTask = new VenueDeviceConfigUpdater(uuid, Venue.info.name, Logger());
-					bool TaskAdded = false;
-					while (!TaskAdded) {
-						if (Pool_.available()) {
-							JobList.push_back(NewTask);
-							Pool_.start(*NewTask);
-							TaskAdded = true;
-							continue;
-						}
-					}
+			if (Pool_ == nullptr) {
+				ProvObjects::Venue Venue;
+				if (!StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
+					N_.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
+					poco_warning(Logger(), N_.content.details);
+					return Finish();
+				}
+				N_.content.title = fmt::format("Updating {} configurations", Venue.info.name);
+				N_.content.jobId = JobId();
+				VenueName_ = Venue.info.name;
+				OwnershipRing()->OwnedVenueDevices(Venue.info.id, DeviceList_);
+				Pool_ = std::make_unique<Poco::ThreadPool>();
+			}
 
-					for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-						VenueDeviceConfigUpdater *current_job = *job_it;
-						if (current_job != nullptr && current_job->done_) {
-							Updated += current_job->updated_;
-							Failed += current_job->failed_;
-							BadConfigs += current_job->bad_config_;
-							if (current_job->updated_) {
-								N.content.success.push_back(current_job->SerialNumber);
-							} else if (current_job->failed_) {
-								N.content.warning.push_back(current_job->SerialNumber);
-							} else {
-								N.content.error.push_back(current_job->SerialNumber);
-							}
-							job_it = JobList.erase(job_it);
-							delete current_job;
-						} else {
-							++job_it;
-						}
+			for (; Index_ < DeviceList_.size(); ++Index_) {
+				if (!Pace(Index_, DeviceList_.size())) {
+					Utils::SetThreadName("free");
+					return;
+				}
+				auto NewTask =
+					new VenueDeviceConfigUpdater(DeviceList_[Index_], VenueName_, Logger());
+				bool TaskAdded = false;
+				while (!TaskAdded) {
+					if (Pool_->available()) {
+						JobList_.push_back(NewTask);
+						Pool_->start(*NewTask);
+						TaskAdded = true;
+						continue;
 					}
 				}
+				Collect();
+			}
 
-				poco_debug(Logger(), "Waiting for outstanding update threads to finish.");
-				Pool_.joinAll();
-				for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-					VenueDeviceConfigUpdater *current_job = *job_it;
-					if (current_job != nullptr && current_job->done_) {
-						Updated += current_job->updated_;
-						Failed += current_job->failed_;
-						BadConfigs += current_job->bad_config_;
-						if (current_job->updated_) {
-							N.content.success.push_back(current_job->SerialNumber);
-						} else if (current_job->failed_) {
-							N.content.warning.push_back(current_job->SerialNumber);
-						} else {
-							N.content.error.push_back(current_job->SerialNumber);
-						}
-						job_it = JobList.erase(job_it);
-						delete current_job;
+			poco_debug(Logger(), "Waiting for outstanding update threads to finish.");
+			Pool_->joinAll();
+			Collect();
+			N_.content.details = fmt::format(
+				"Job {} Completed: {} updated, {} failed to update, {} bad configurations. ",
+				JobId(), Updated_, Failed_, BadConfigs_);
+			Finish();
+		}
+
+	  private:
+		ProvWebSocketNotifications::ConfigUpdateList_t N_;
+		std::string VenueName_;
+		std::vector<std::string> DeviceList_;
+		std::size_t Index_ = 0;
+		std::unique_ptr<Poco::ThreadPool> Pool_;
+		std::list<VenueDeviceConfigUpdater *> JobList_;
+		uint64_t Updated_ = 0, Failed_ = 0, BadConfigs_ = 0;
+
+		void Collect() {
+			for (auto job_it = JobList_.begin(); job_it != JobList_.end();) {
+				VenueDeviceConfigUpdater *current_job = *job_it;
+				if (current_job != nullptr && current_job->done_) {
+					Updated_ += current_job->updated_;
+					Failed_ += current_job->failed_;
+					BadConfigs_ += current_job->bad_config_;
+					if (current_job->updated_) {
+						N_.content.success.push_back(current_job->SerialNumber);
+					} else if (current_job->failed_) {
+						N_.content.warning.push_back(current_job->SerialNumber);
 					} else {
-						++job_it;
+						N_.content.error.push_back(current_job->SerialNumber);
 					}
+					job_it = JobList_.erase(job_it);
+					delete current_job;
+				} else {
+					++job_it;
 				}
-
-				N.content.details = fmt::format(
-					"Job {} Completed: {} updated, {} failed to update, {} bad configurations. ",
-					JobId(), Updated, Failed, BadConfigs);
-
-			} else {
-				N.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
-				poco_warning(Logger(), N.content.details);
 			}
+		}
 
-			// std::cout << N.content.details << std::endl;
-			ProvWebSocketNotifications::VenueConfigUpdateCompletion(UserInfo().email, N);
+		void Finish() {
+			ProvWebSocketNotifications::VenueConfigUpdateCompletion(UserInfo().email, N_);
 			poco_information(
 				Logger(),
 				fmt::format(
 					"Job {} Completed: {} updated, {} failed to update , {} bad configurations.",
-					JobId(), Updated, Failed, BadConfigs));
+					JobId(), Updated_, Failed_, BadConfigs_));
 			Utils::SetThreadName("free");
 			Complete();
 		}
 	};
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
@@ -2,8 +2,11 @@
 // Created by stephane bourque on 2022-05-04.
 //
 
+#pragma once
+
 #include "APConfig.h"
 #include "JobController.h"
+#include "OwnershipRing.h"
 #include "StorageService.h"
 #include "UI_Prov_WebSocketNotifications.h"
 #include "framework/MicroServiceFuncs.h"
@@ -52,82 +55,82 @@ namespace OpenWifi {
 					  const SecurityObjects::UserInfo &UI, Poco::Logger &L)
 			: Job(JobID, name, parameters, when, UI, L) {}
 
+		//	Returns early when pacing holds back the next device, and continues from it when run
+		//	again.
 		inline virtual void run() final {
 
 			Utils::SetThreadName("venue-reboot");
 
-			ProvWebSocketNotifications::VenueRebootList_t N;
 			auto VenueUUID_ = Parameter(0);
-
-			ProvObjects::Venue Venue;
-			uint64_t rebooted_ = 0, failed_ = 0;
-			if (StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
-
-				N.content.title = fmt::format("Rebooting {} devices.", Venue.info.name);
-				N.content.jobId = JobId();
-
-				Poco::ThreadPool Pool_;
-				std::list<VenueDeviceRebooter *> JobList;
-                std::vector<std::string> DeviceList;
-                StorageService()->InventoryDB().GetDevicesUUIDForVenue(Venue.info.id, DeviceList);
-
-				for (const auto &uuid : DeviceList) {
-					auto NewTask = new VenueDeviceRebooter(uuid, Venue.info.name, Logger());
-					bool TaskAdded = false;
-					while (!TaskAdded) {
-						if (Pool_.available()) {
-							JobList.push_back(NewTask);
-							Pool_.start(*NewTask);
-							TaskAdded = true;
-							continue;
-						}
-					}
-
-					for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-						VenueDeviceRebooter *current_job = *job_it;
-						if (current_job != nullptr && current_job->done_) {
-							if (current_job->rebooted_)
-								N.content.success.push_back(current_job->SerialNumber);
-							else
-								N.content.warning.push_back(current_job->SerialNumber);
-							rebooted_ += current_job->rebooted_;
-							failed_ += current_job->failed_;
-							job_it = JobList.erase(job_it);
-							delete current_job;
-						} else {
-							++job_it;
-						}
-					}
+			if (Pool_ == nullptr) {
+				ProvObjects::Venue Venue;
+				if (!StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
+					N_.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
+					Logger().warning(N_.content.details);
+					return Finish();
 				}
+				N_.content.title = fmt::format("Rebooting {} devices.", Venue.info.name);
+				N_.content.jobId = JobId();
+				VenueName_ = Venue.info.name;
+				OwnershipRing()->OwnedVenueDevices(Venue.info.id, DeviceList_);
+				Pool_ = std::make_unique<Poco::ThreadPool>();
+			}
 
-				Logger().debug("Waiting for outstanding update threads to finish.");
-				Pool_.joinAll();
-				for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-					VenueDeviceRebooter *current_job = *job_it;
-					if (current_job != nullptr && current_job->done_) {
-						if (current_job->rebooted_)
-							N.content.success.push_back(current_job->SerialNumber);
-						else
-							N.content.warning.push_back(current_job->SerialNumber);
-						rebooted_ += current_job->rebooted_;
-						failed_ += current_job->failed_;
-						job_it = JobList.erase(job_it);
-						delete current_job;
-					} else {
-						++job_it;
+			for (; Index_ < DeviceList_.size(); ++Index_) {
+				if (!Pace(Index_, DeviceList_.size())) {
+					Utils::SetThreadName("free");
+					return;
+				}
+				auto NewTask = new VenueDeviceRebooter(DeviceList_[Index_], VenueName_, Logger());
+				bool TaskAdded = false;
+				while (!TaskAdded) {
+					if (Pool_->available()) {
+						JobList_.push_back(NewTask);
+						Pool_->start(*NewTask);
+						TaskAdded = true;
+						continue;
 					}
 				}
-				N.content.details =
-					fmt::format("Job {} Completed: {} rebooted, {} failed to reboot.", JobId(),
-								rebooted_, failed_);
+				Collect();
+			}
 
-			} else {
-				N.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
-				Logger().warning(N.content.details);
+			Logger().debug("Waiting for outstanding update threads to finish.");
+			Pool_->joinAll();
+			Collect();
+			N_.content.details = fmt::format("Job {} Completed: {} rebooted, {} failed to reboot.",
+											 JobId(), rebooted_, failed_);
+			Finish();
+		}
+
+	  private:
+		ProvWebSocketNotifications::VenueRebootList_t N_;
+		std::string VenueName_;
+		std::vector<std::string> DeviceList_;
+		std::size_t Index_ = 0;
+		std::unique_ptr<Poco::ThreadPool> Pool_;
+		std::list<VenueDeviceRebooter *> JobList_;
+		uint64_t rebooted_ = 0, failed_ = 0;
+
+		void Collect() {
+			for (auto job_it = JobList_.begin(); job_it != JobList_.end();) {
+				VenueDeviceRebooter *current_job = *job_it;
+				if (current_job != nullptr && current_job->done_) {
+					if (current_job->rebooted_)
+						N_.content.success.push_back(current_job->SerialNumber);
+					else
+						N_.content.warning.push_back(current_job->SerialNumber);
+					rebooted_ += current_job->rebooted_;
+					failed_ += current_job->failed_;
+					job_it = JobList_.erase(job_it);
+					delete current_job;
+				} else {
+					++job_it;
+				}
 			}
+		}
 
-			// std::cout << N.content.details << std::endl;
-			ProvWebSocketNotifications::VenueRebootCompletion(UserInfo().email, N);
+		void Finish() {
+			ProvWebSocketNotifications::VenueRebootCompletion(UserInfo().email, N_);
 			poco_information(Logger(),
 							 fmt::format("Job {} Completed: {} rebooted, {} failed to reboot.",
 										 JobId(), rebooted_, failed_));
@@ -136,4 +139,4 @@ namespace OpenWifi {
 		}
 	};
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
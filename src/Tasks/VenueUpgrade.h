@@ -4,15 +4,87 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
 #include "APConfig.h"
+#include "FirmwareCatalog.h"
 #include "JobController.h"
+#include "OwnershipRing.h"
+#include "Poco/JSON/Parser.h"
 #include "StorageService.h"
 #include "UI_Prov_WebSocketNotifications.h"
 #include "framework/MicroServiceFuncs.h"
-#include "sdks/SDK_fms.h"
 #include "sdks/SDK_gw.h"
 
 namespace OpenWifi {
+
+	//	How a venue upgrade is rolled out. The first wave has Canary devices, the next ones
+	//	WaveSize devices (0: all the remaining devices). After each wave but the last, the
+	//	upgraded devices get HealthWait seconds to reconnect, and the upgrade stops when more
+	//	than MaxFailures percent of them did not. At most Concurrency devices are upgraded at once.
+	struct VenueUpgradePlan {
+		uint64_t Canary = 0;
+		uint64_t WaveSize = 0;
+		uint64_t Concurrency = 16;
+		uint64_t MaxFailures = 10;
+		uint64_t HealthWait = 600;
+
+		static VenueUpgradePlan Defaults() {
+			VenueUpgradePlan P;
+			P.Canary = MicroServiceConfigGetInt("provisioning.upgrade.canary", 0);
+			P.WaveSize = MicroServiceConfigGetInt("provisioning.upgrade.wavesize", 0);
+			P.Concurrency = MicroServiceConfigGetInt("provisioning.upgrade.concurrency", 16);
+			P.MaxFailures = MicroServiceConfigGetInt("provisioning.upgrade.maxfailures", 10);
+			P.HealthWait = MicroServiceConfigGetInt("provisioning.upgrade.healthwait", 600);
+			return P;
+		}
+
+		//	The defaults, overridden by the fields present in the JSON document S.
+		static VenueUpgradePlan FromString(const std::string &S) {
+			auto P = Defaults();
+			try {
+				Poco::JSON::Parser Parser;
+				auto O = Parser.parse(S).extract<Poco::JSON::Object::Ptr>();
+				P.Canary = O->optValue("canary", P.Canary);
+				P.WaveSize = O->optValue("waveSize", P.WaveSize);
+				P.Concurrency = O->optValue("concurrency", P.Concurrency);
+				P.MaxFailures = O->optValue("maxFailures", P.MaxFailures);
+				P.HealthWait = O->optValue("healthWait", P.HealthWait);
+			} catch (...) {
+			}
+			return P;
+		}
+
+		[[nodiscard]] std::string ToString() const {
+			Poco::JSON::Object O;
+			O.set("canary", Canary);
+			O.set("waveSize", WaveSize);
+			O.set("concurrency", Concurrency);
+			O.set("maxFailures", MaxFailures);
+			O.set("healthWait", HealthWait);
+			std::ostringstream OS;
+			O.stringify(OS);
+			return OS.str();
+		}
+
+		//	Where each wave ends, for Count devices.
+		[[nodiscard]] std::vector<std::size_t> Waves(std::size_t Count) const {
+			std::vector<std::size_t> Ends;
+			std::size_t End = 0;
+			if (Canary > 0 && Count > 0) {
+				End = std::min((std::size_t)Canary, Count);
+				Ends.push_back(End);
+			}
+			while (End < Count) {
+				End = WaveSize > 0 ? std::min(End + WaveSize, Count) : Count;
+				Ends.push_back(End);
+			}
+			return Ends;
+		}
+	};
+
 	class VenueDeviceUpgrade : public Poco::Runnable {
 	  public:
 		VenueDeviceUpgrade(const std::string &UUID, const std::string &venue,
@@ -35,7 +107,7 @@ namespace OpenWifi {
 				}
 
 				FMSObjects::Firmware F;
-				if (SDK::FMS::Firmware::GetFirmware(Device.deviceType, revision_, F)) {
+				if (FirmwareCatalog()->GetFirmware(Device.deviceType, revision_, F)) {
                     std::string Status;
 					if (SDK::GW::Device::Upgrade(nullptr, Device.serialNumber, 0, F.uri, Status)) {
                         if(Status=="pending") {
@@ -61,7 +133,7 @@ namespace OpenWifi {
 		}
 
 		std::uint64_t upgraded_ = 0, not_connected_ = 0, skipped_ = 0, no_firmware_ = 0, pending_ = 0;
-		bool started_ = false, done_ = false;
+		std::atomic_bool started_ = false, done_ = false;
 		std::string SerialNumber;
 
 	  private:
@@ -73,115 +145,210 @@ namespace OpenWifi {
 		inline Poco::Logger &Logger() { return Logger_; }
 	};
 
+	//	Parameters: venue, revision and optionally a VenueUpgradePlan. Each replica rolls out
+	//	the plan on its own devices of the venue.
 	class VenueUpgrade : public Job {
 	  public:
+		static constexpr uint64_t ProgressInterval = 5;
+		static constexpr int64_t HealthPollInterval = 15000;
+
 		VenueUpgrade(const std::string &JobID, const std::string &name,
 					 const std::vector<std::string> &parameters, uint64_t when,
 					 const SecurityObjects::UserInfo &UI, Poco::Logger &L)
 			: Job(JobID, name, parameters, when, UI, L) {}
 
+		//	Returns early when pacing holds back the next device, and continues from it when run
+		//	again.
 		inline virtual void run() final {
 
 			Utils::SetThreadName("venue-upgr");
 			auto VenueUUID_ = Parameter(0);
-			auto Revision_ = Parameter(1);
-
-			ProvWebSocketNotifications::VenueFWUpgradeList_t N;
-
-			ProvObjects::Venue Venue;
-			uint64_t upgraded_ = 0, not_connected_ = 0, skipped_ = 0, no_firmware_ = 0, pending_=0;
-			if (StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
-
-				N.content.title = fmt::format("Upgrading {} devices.", Venue.info.name);
-				N.content.jobId = JobId();
-
-				Poco::ThreadPool Pool_;
-				std::list<VenueDeviceUpgrade *> JobList;
-				ProvObjects::DeviceRules Rules;
-
-				StorageService()->VenueDB().EvaluateDeviceRules(Venue.info.id, Rules);
-                std::vector<std::string> DeviceList;
-                StorageService()->InventoryDB().GetDevicesUUIDForVenue(Venue.info.id, DeviceList);
-
-				for (const auto &uuid : DeviceList) {
-					auto NewTask =
-						new VenueDeviceUpgrade(uuid, Venue.info.name, Revision_, Rules, Logger());
-					bool TaskAdded = false;
-					while (!TaskAdded) {
-						if (Pool_.available()) {
-							JobList.push_back(NewTask);
-							Pool_.start(*NewTask);
-							TaskAdded = true;
-							continue;
+
+			if (Pool_ == nullptr) {
+				ProvObjects::Venue Venue;
+				if (!StorageService()->VenueDB().GetRecord("id", VenueUUID_, Venue)) {
+					N_.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
+					Logger().warning(N_.content.details);
+					return Finish();
+				}
+				Revision_ = Parameter(1);
+				Plan_ = ParameterCount() > 2 ? VenueUpgradePlan::FromString(Parameter(2))
+											 : VenueUpgradePlan::Defaults();
+				N_.content.title = fmt::format("Upgrading {} devices.", Venue.info.name);
+				N_.content.jobId = JobId();
+				P_.content.title = N_.content.title;
+				P_.content.jobId = JobId();
+				VenueName_ = Venue.info.name;
+
+				StorageService()->VenueDB().EvaluateDeviceRules(Venue.info.id, Rules_);
+				OwnershipRing()->OwnedVenueDevices(Venue.info.id, DeviceList_);
+
+				Waves_ = Plan_.Waves(DeviceList_.size());
+				P_.content.total = DeviceList_.size();
+				P_.content.waves = Waves_.size();
+				Pool_ = std::make_unique<Poco::ThreadPool>(
+					1, (int)std::max((uint64_t)1, Plan_.Concurrency));
+			}
+
+			for (; Wave_ < Waves_.size(); ++Wave_) {
+				if (!InWave_ && !Gating_) {
+					WaveStart_ = Utils::Now();
+					Upgraded_.clear();
+					P_.content.wave = Wave_ + 1;
+					InWave_ = true;
+				}
+
+				if (InWave_) {
+					for (; Index_ < Waves_[Wave_]; ++Index_) {
+						if (!Pace(Index_, DeviceList_.size())) {
+							Utils::SetThreadName("free");
+							return;
+						}
+						while (Pool_->available() == 0) {
+							Collect(false);
+							Poco::Thread::sleep(10);
 						}
+						auto NewTask = new VenueDeviceUpgrade(DeviceList_[Index_], VenueName_,
+															  Revision_, Rules_, Logger());
+						JobList_.push_back(NewTask);
+						Pool_->start(*NewTask);
+						Collect(false);
 					}
+					InWave_ = false;
 
-					for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-						VenueDeviceUpgrade *current_job = *job_it;
-						if (current_job != nullptr && current_job->done_) {
-							if (current_job->upgraded_)
-								N.content.success.push_back(current_job->SerialNumber);
-							else if (current_job->skipped_)
-								N.content.skipped.push_back(current_job->SerialNumber);
-							else if (current_job->not_connected_)
-								N.content.not_connected.push_back(current_job->SerialNumber);
-							else if (current_job->no_firmware_)
-								N.content.no_firmware.push_back(current_job->SerialNumber);
-                            else if (current_job->pending_)
-                                N.content.pending.push_back(current_job->SerialNumber);
-							upgraded_ += current_job->upgraded_;
-							skipped_ += current_job->skipped_;
-							no_firmware_ += current_job->no_firmware_;
-							not_connected_ += current_job->not_connected_;
-                            pending_ += current_job->pending_;
-							job_it = JobList.erase(job_it);
-							delete current_job;
-						} else {
-							++job_it;
-						}
+					Logger().debug("Waiting for outstanding upgrade threads to finish.");
+					Pool_->joinAll();
+					Collect(true);
+
+					if (Wave_ + 1 < Waves_.size() && !Upgraded_.empty()) {
+						P_.content.details = fmt::format("Wave {} of {}: waiting for {} devices to reconnect.",
+														 Wave_ + 1, Waves_.size(), Upgraded_.size());
+						SendProgress(true);
+						Unhealthy_ = Upgraded_;
+						GateDeadline_ = Utils::Now() + Plan_.HealthWait;
+						Gating_ = true;
 					}
 				}
 
-				Logger().debug("Waiting for outstanding upgrade threads to finish.");
-				Pool_.joinAll();
-				for (auto job_it = JobList.begin(); job_it != JobList.end();) {
-					VenueDeviceUpgrade *current_job = *job_it;
-					if (current_job != nullptr && current_job->done_) {
-						if (current_job->upgraded_)
-							N.content.success.push_back(current_job->SerialNumber);
-						else if (current_job->skipped_)
-							N.content.skipped.push_back(current_job->SerialNumber);
-						else if (current_job->not_connected_)
-							N.content.not_connected.push_back(current_job->SerialNumber);
-						else if (current_job->no_firmware_)
-							N.content.no_firmware.push_back(current_job->SerialNumber);
-                        else if (current_job->pending_)
-                            N.content.pending.push_back(current_job->SerialNumber);
-						upgraded_ += current_job->upgraded_;
-						skipped_ += current_job->skipped_;
-						no_firmware_ += current_job->no_firmware_;
-						not_connected_ += current_job->not_connected_;
-                        pending_ += current_job->pending_;
-						job_it = JobList.erase(job_it);
-						delete current_job;
-					} else {
-						++job_it;
+				if (Gating_) {
+					//	The devices are checked again when the controller next runs the job,
+					//	rather than by sleeping in its pool.
+					if (!GatePassed()) {
+						ResumeIn(std::chrono::milliseconds(HealthPollInterval));
+						Utils::SetThreadName("free");
+						return;
+					}
+					Gating_ = false;
+					//	The next wave is paced from the end of the wait, not from the start
+					//	of the job.
+					RestartPacing(Index_, DeviceList_.size());
+					auto Unhealthy = Unhealthy_.size();
+					P_.content.unhealthy += Unhealthy;
+					if (Unhealthy * 100 > Plan_.MaxFailures * Upgraded_.size()) {
+						P_.content.halted = true;
+						P_.content.details = fmt::format(
+							"Halted after wave {} of {}: {} of {} upgraded devices did not reconnect. {} devices not upgraded.",
+							Wave_ + 1, Waves_.size(), Unhealthy, Upgraded_.size(),
+							DeviceList_.size() - Index_);
+						poco_warning(Logger(), fmt::format("Job {}: {}", JobId(), P_.content.details));
+						SendProgress(true);
+						break;
 					}
 				}
-
-				N.content.details = fmt::format(
-					"Job {} Completed: {} upgraded, {} not connected, {} skipped, {} no firmware, {} pending.",
-					JobId(), upgraded_, not_connected_, skipped_, no_firmware_, pending_);
-			} else {
-				N.content.details = fmt::format("Venue {} no longer exists.", VenueUUID_);
-				Logger().warning(N.content.details);
+				P_.content.details = fmt::format("Wave {} of {} completed.", Wave_ + 1, Waves_.size());
+				SendProgress(true);
 			}
 
-			// std::cout << N.content.details << std::endl;
-			ProvWebSocketNotifications::VenueFWUpgradeCompletion(UserInfo().email, N);
-			poco_information(Logger(), N.content.details);
+			N_.content.details = fmt::format(
+				"Job {} {}: {} upgraded, {} not connected, {} skipped, {} no firmware, {} pending.",
+				JobId(), P_.content.halted ? "Halted" : "Completed", P_.content.upgraded,
+				P_.content.notConnected, P_.content.skipped, P_.content.noFirmware,
+				P_.content.pending);
+			Finish();
+		}
+
+	  private:
+		ProvWebSocketNotifications::VenueFWUpgradeProgress_t P_;
+		ProvWebSocketNotifications::VenueFWUpgradeList_t N_;
+		uint64_t LastProgress_ = 0;
+		VenueUpgradePlan Plan_;
+		std::string Revision_;
+		std::string VenueName_;
+		ProvObjects::DeviceRules Rules_;
+		std::vector<std::string> DeviceList_;
+		std::vector<std::size_t> Waves_;
+		std::unique_ptr<Poco::ThreadPool> Pool_;
+		std::list<VenueDeviceUpgrade *> JobList_;
+		std::vector<std::string> Upgraded_;
+		std::size_t Wave_ = 0, Index_ = 0;
+		bool InWave_ = false;
+		uint64_t WaveStart_ = 0;
+		//	Between waves: the upgraded devices not seen back yet, until GateDeadline_.
+		bool Gating_ = false;
+		std::vector<std::string> Unhealthy_;
+		uint64_t GateDeadline_ = 0;
+
+		void Finish() {
+			ProvWebSocketNotifications::VenueFWUpgradeCompletion(UserInfo().email, N_);
+			poco_information(Logger(), N_.content.details);
 			Utils::SetThreadName("free");
 			Complete();
 		}
+
+		//	Accounts for the finished devices, or waits for all of them when All is set.
+		void Collect(bool All) {
+			for (auto job_it = JobList_.begin(); job_it != JobList_.end();) {
+				VenueDeviceUpgrade *current_job = *job_it;
+				if (current_job != nullptr && (All || current_job->done_)) {
+					if (current_job->upgraded_) {
+						N_.content.success.push_back(current_job->SerialNumber);
+						Upgraded_.push_back(current_job->SerialNumber);
+					} else if (current_job->skipped_)
+						N_.content.skipped.push_back(current_job->SerialNumber);
+					else if (current_job->not_connected_)
+						N_.content.not_connected.push_back(current_job->SerialNumber);
+					else if (current_job->no_firmware_)
+						N_.content.no_firmware.push_back(current_job->SerialNumber);
+					else if (current_job->pending_)
+						N_.content.pending.push_back(current_job->SerialNumber);
+					P_.content.upgraded += current_job->upgraded_;
+					P_.content.skipped += current_job->skipped_;
+					P_.content.noFirmware += current_job->no_firmware_;
+					P_.content.notConnected += current_job->not_connected_;
+					P_.content.pending += current_job->pending_;
+					P_.content.processed++;
+					job_it = JobList_.erase(job_it);
+					delete current_job;
+				} else {
+					++job_it;
+				}
+			}
+			SendProgress(false);
+		}
+
+		//	Progress goes out at most every ProgressInterval seconds, unless Now is set.
+		void SendProgress(bool Now) {
+			auto T = Utils::Now();
+			if (!Now && T - LastProgress_ < ProgressInterval)
+				return;
+			LastProgress_ = T;
+			P_.content.timeStamp = T;
+			ProvWebSocketNotifications::VenueFWUpgradeProgress(UserInfo().email, P_);
+		}
+
+		//	Drops the devices that reconnected since the wave started. True when none is left,
+		//	or when the wait is over.
+		bool GatePassed() {
+			for (auto it = Unhealthy_.begin(); it != Unhealthy_.end();) {
+				bool Connected = false;
+				uint64_t Started = 0;
+				if (SDK::GW::Device::GetStatus(*it, Connected, Started) && Connected &&
+					Started >= WaveStart_)
+					it = Unhealthy_.erase(it);
+				else
+					++it;
+			}
+			return Unhealthy_.empty() || Utils::Now() >= GateDeadline_;
+		}
 	};
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
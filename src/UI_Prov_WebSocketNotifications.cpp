@@ -83,9 +83,87 @@ namespace OpenWifi::ProvWebSocketNotifications {
 		return false;
 	}
 
+	void FWUpgradeProgress::to_json(Poco::JSON::Object &Obj) const {
+		RESTAPI_utils::field_to_json(Obj, "title", title);
+		RESTAPI_utils::field_to_json(Obj, "jobId", jobId);
+		RESTAPI_utils::field_to_json(Obj, "wave", wave);
+		RESTAPI_utils::field_to_json(Obj, "waves", waves);
+		RESTAPI_utils::field_to_json(Obj, "total", total);
+		RESTAPI_utils::field_to_json(Obj, "processed", processed);
+		RESTAPI_utils::field_to_json(Obj, "upgraded", upgraded);
+		RESTAPI_utils::field_to_json(Obj, "pending", pending);
+		RESTAPI_utils::field_to_json(Obj, "notConnected", notConnected);
+		RESTAPI_utils::field_to_json(Obj, "noFirmware", noFirmware);
+		RESTAPI_utils::field_to_json(Obj, "skipped", skipped);
+		RESTAPI_utils::field_to_json(Obj, "unhealthy", unhealthy);
+		RESTAPI_utils::field_to_json(Obj, "halted", halted);
+		RESTAPI_utils::field_to_json(Obj, "timeStamp", timeStamp);
+		RESTAPI_utils::field_to_json(Obj, "details", details);
+	}
+
+	bool FWUpgradeProgress::from_json(const Poco::JSON::Object::Ptr &Obj) {
+		try {
+			RESTAPI_utils::field_from_json(Obj, "title", title);
+			RESTAPI_utils::field_from_json(Obj, "jobId", jobId);
+			RESTAPI_utils::field_from_json(Obj, "wave", wave);
+			RESTAPI_utils::field_from_json(Obj, "waves", waves);
+			RESTAPI_utils::field_from_json(Obj, "total", total);
+			RESTAPI_utils::field_from_json(Obj, "processed", processed);
+			RESTAPI_utils::field_from_json(Obj, "upgraded", upgraded);
+			RESTAPI_utils::field_from_json(Obj, "pending", pending);
+			RESTAPI_utils::field_from_json(Obj, "notConnected", notConnected);
+			RESTAPI_utils::field_from_json(Obj, "noFirmware", noFirmware);
+			RESTAPI_utils::field_from_json(Obj, "skipped", skipped);
+			RESTAPI_utils::field_from_json(Obj, "unhealthy", unhealthy);
+			RESTAPI_utils::field_from_json(Obj, "halted", halted);
+			RESTAPI_utils::field_from_json(Obj, "timeStamp", timeStamp);
+			RESTAPI_utils::field_from_json(Obj, "details", details);
+			return true;
+		} catch (...) {
+		}
+		return false;
+	}
+
+	void InventoryImportProgress::to_json(Poco::JSON::Object &Obj) const {
+		RESTAPI_utils::field_to_json(Obj, "title", title);
+		RESTAPI_utils::field_to_json(Obj, "jobId", jobId);
+		RESTAPI_utils::field_to_json(Obj, "total", total);
+		RESTAPI_utils::field_to_json(Obj, "imported", imported);
+		RESTAPI_utils::field_to_json(Obj, "failed", failed);
+		RESTAPI_utils::field_to_json(Obj, "gwUpdated", gwUpdated);
+		RESTAPI_utils::field_to_json(Obj, "gwFailed", gwFailed);
+		RESTAPI_utils::field_to_json(Obj, "done", done);
+		RESTAPI_utils::field_to_json(Obj, "errors", errors);
+		RESTAPI_utils::field_to_json(Obj, "timeStamp", timeStamp);
+		RESTAPI_utils::field_to_json(Obj, "details", details);
+	}
+
+	bool InventoryImportProgress::from_json(const Poco::JSON::Object::Ptr &Obj) {
+		try {
+			RESTAPI_utils::field_from_json(Obj, "title", title);
+			RESTAPI_utils::field_from_json(Obj, "jobId", jobId);
+			RESTAPI_utils::field_from_json(Obj, "total", total);
+			RESTAPI_utils::field_from_json(Obj, "imported", imported);
+			RESTAPI_utils::field_from_json(Obj, "failed", failed);
+			RESTAPI_utils::field_from_json(Obj, "gwUpdated", gwUpdated);
+			RESTAPI_utils::field_from_json(Obj, "gwFailed", gwFailed);
+			RESTAPI_utils::field_from_json(Obj, "done", done);
+			RESTAPI_utils::field_from_json(Obj, "errors", errors);
+			RESTAPI_utils::field_from_json(Obj, "timeStamp", timeStamp);
+			RESTAPI_utils::field_from_json(Obj, "details", details);
+			return true;
+		} catch (...) {
+		}
+		return false;
+	}
+
 	void Register() {
 		static const UI_WebSocketClientServer::NotificationTypeIdVec Notifications = {
-			{1000, "venue_fw_upgrade"}, {2000, "venue_config_update"}, {3000, "venue_rebooter"}};
+			{1000, "venue_fw_upgrade"},
+			{1001, "venue_fw_upgrade_progress"},
+			{2000, "venue_config_update"},
+			{3000, "venue_rebooter"},
+			{4000, "inventory_import"}};
 		UI_WebSocketClientServer()->RegisterNotifications(Notifications);
 	}
 
@@ -99,6 +177,11 @@ namespace OpenWifi::ProvWebSocketNotifications {
 		UI_WebSocketClientServer()->SendUserNotification(User, N);
 	}
 
+	void VenueFWUpgradeProgress(const std::string &User, VenueFWUpgradeProgress_t &N) {
+		N.type_id = 1001;
+		UI_WebSocketClientServer()->SendUserNotification(User, N);
+	}
+
 	void VenueConfigUpdateCompletion(ConfigUpdateList_t &N) {
 		N.type_id = 2000;
 		UI_WebSocketClientServer()->SendNotification(N);
@@ -119,4 +202,9 @@ namespace OpenWifi::ProvWebSocketNotifications {
 		UI_WebSocketClientServer()->SendUserNotification(User, N);
 	}
 
+	void InventoryImportUpdate(const std::string &User, InventoryImportProgress_t &N) {
+		N.type_id = 4000;
+		UI_WebSocketClientServer()->SendUserNotification(User, N);
+	}
+
 } // namespace OpenWifi::ProvWebSocketNotifications
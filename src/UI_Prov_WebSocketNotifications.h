@@ -42,15 +42,45 @@ namespace OpenWifi::ProvWebSocketNotifications {
 
 	typedef WebSocketNotification<FWUpgradeList> VenueFWUpgradeList_t;
 
+	struct FWUpgradeProgress {
+		std::string title, details, jobId;
+		uint64_t wave = 0, waves = 0, total = 0, processed = 0;
+		uint64_t upgraded = 0, pending = 0, notConnected = 0, noFirmware = 0, skipped = 0,
+				 unhealthy = 0;
+		bool halted = false;
+		uint64_t timeStamp = OpenWifi::Utils::Now();
+
+		void to_json(Poco::JSON::Object &Obj) const;
+		bool from_json(const Poco::JSON::Object::Ptr &Obj);
+	};
+
+	typedef WebSocketNotification<FWUpgradeProgress> VenueFWUpgradeProgress_t;
+
+	struct InventoryImportProgress {
+		std::string title, details, jobId;
+		uint64_t total = 0, imported = 0, failed = 0, gwUpdated = 0, gwFailed = 0;
+		bool done = false;
+		std::vector<std::string> errors;
+		uint64_t timeStamp = OpenWifi::Utils::Now();
+
+		void to_json(Poco::JSON::Object &Obj) const;
+		bool from_json(const Poco::JSON::Object::Ptr &Obj);
+	};
+
+	typedef WebSocketNotification<InventoryImportProgress> InventoryImportProgress_t;
+
 	void Register();
 
 	void VenueFWUpgradeCompletion(const std::string &User, VenueFWUpgradeList_t &N);
 	void VenueFWUpgradeCompletion(VenueFWUpgradeList_t &N);
+	void VenueFWUpgradeProgress(const std::string &User, VenueFWUpgradeProgress_t &N);
 
 	void VenueConfigUpdateCompletion(const std::string &User, ConfigUpdateList_t &N);
 	void VenueConfigUpdateCompletion(ConfigUpdateList_t &N);
 
 	void VenueRebootCompletion(const std::string &User, VenueRebootList_t &N);
 	void VenueRebootCompletion(VenueRebootList_t &N);
+
+	void InventoryImportUpdate(const std::string &User, InventoryImportProgress_t &N);
 } // namespace OpenWifi::ProvWebSocketNotifications
 // namespace OpenWifi
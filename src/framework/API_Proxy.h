@@ -18,8 +18,9 @@ namespace OpenWifi {
 						  Poco::Net::HTTPServerResponse *Response, const char *ServiceType,
 						  const char *PathRewrite, uint64_t msTimeout_ = 10000) {
 		try {
-			auto Services = MicroServiceGetServices(ServiceType);
-			for (auto const &Svc : Services) {
+			auto Services = MicroServiceGetServicesInTurn(ServiceType);
+			for (std::size_t i = 0; i < Services.size(); ++i) {
+				const auto &Svc = Services[i];
 				Poco::URI SourceURI(Request->getURI());
 				Poco::URI DestinationURI(Svc.PrivateEndPoint);
 				DestinationURI.setPath(PathRewrite);
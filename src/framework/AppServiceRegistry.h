@@ -4,91 +4,180 @@
 
 #pragma once
 
-#include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "Poco/File.h"
-#include "Poco/StreamCopier.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Parser.h"
+#include "Poco/MemoryStream.h"
+#include "Poco/SharedMemory.h"
+#include "Poco/Timer.h"
 
 #include "framework/MicroServiceFuncs.h"
 
-// #include "nlohmann/json.hpp"
-
 namespace OpenWifi {
 
+	//	Small persistent key/value store in <data directory>/registry.json. Changes are kept in
+	//	memory and written at most once per FlushInterval: the new content goes to a temporary
+	//	file, is synced, then renamed over the old one, so a crash leaves either version intact.
 	class AppServiceRegistry {
 	  public:
-		AppServiceRegistry() {
-			FileName = MicroServiceDataDirectory() + "/registry.json";
-			Poco::File F(FileName);
+		static constexpr long FlushInterval = 1000;
 
-			try {
-				if (F.exists()) {
-					std::ostringstream OS;
-					std::ifstream IF(FileName);
-                    Poco::JSON::Parser  P;
-					Registry_ = P.parse(IF).extract<Poco::JSON::Object::Ptr>();
-				}
-			} catch (...) {
-				Registry_ = Poco::makeShared<Poco::JSON::Object>();
-			}
-		}
+		AppServiceRegistry(const AppServiceRegistry &) = delete;
+		AppServiceRegistry &operator=(const AppServiceRegistry &) = delete;
 
 		static AppServiceRegistry &instance() {
 			static auto instance_ = new AppServiceRegistry;
 			return *instance_;
 		}
 
-		inline ~AppServiceRegistry() { Save(); }
+		inline ~AppServiceRegistry() {
+			Timer_.stop();
+			Save();
+		}
 
-		inline void Save() {
-			std::ofstream OF;
-			OF.open(FileName, std::ios::binary | std::ios::trunc);
-            Registry_->stringify(OF);
+		//	Writes pending changes now. Returns false when the file could not be written: the
+		//	changes stay pending and the next flush tries again.
+		inline bool Save() {
+			std::lock_guard F(FileMutex_);
+			std::string Content;
+			{
+				std::lock_guard G(Mutex_);
+				if (!Dirty_)
+					return true;
+				std::ostringstream OS;
+				Registry_->stringify(OS);
+				Content = OS.str();
+				Dirty_ = false;
+			}
+			if (WriteFile(Content))
+				return true;
+			std::lock_guard G(Mutex_);
+			Dirty_ = true;
+			return false;
 		}
 
-        void Set(const char *key, const std::vector<std::string> &V) {
-            Poco::JSON::Array   Arr;
-            for(const auto &s:V) {
-                Arr.add(s);
-            }
-            Registry_->set(key,Arr);
-            Save();
-        }
-
-        template<class T> void Set(const char *key, const T &Value) {
-            Registry_->set(key,Value);
-			Save();
+		void Set(const char *key, const std::vector<std::string> &V) {
+			Poco::JSON::Array Arr;
+			for (const auto &s : V) {
+				Arr.add(s);
+			}
+			std::lock_guard G(Mutex_);
+			Registry_->set(key, Arr);
+			Dirty_ = true;
 		}
 
-        bool Get(const char *key, std::vector<std::string> &Value) {
-            if(Registry_->has(key) && !Registry_->isNull(key) && Registry_->isArray(key)) {
-                auto Arr = Registry_->get(key);
-                for(const auto &v:Arr) {
-                    Value.emplace_back(v);
-                }
-                return true;
-            }
-            return false;
-        }
-
-        template<class T> bool Get(const char *key, T &Value) {
-            if(Registry_->has(key) && !Registry_->isNull(key)) {
-                Value = Registry_->getValue<T>(key);
-                return true;
-            }
-            return false;
-        }
+		template <class T> void Set(const char *key, const T &Value) {
+			std::lock_guard G(Mutex_);
+			Registry_->set(key, Value);
+			Dirty_ = true;
+		}
+
+		bool Get(const char *key, std::vector<std::string> &Value) {
+			std::lock_guard G(Mutex_);
+			if (Registry_->has(key) && !Registry_->isNull(key) && Registry_->isArray(key)) {
+				auto Arr = Registry_->get(key);
+				for (const auto &v : Arr) {
+					Value.emplace_back(v);
+				}
+				return true;
+			}
+			return false;
+		}
+
+		template <class T> bool Get(const char *key, T &Value) {
+			std::lock_guard G(Mutex_);
+			if (Registry_->has(key) && !Registry_->isNull(key)) {
+				Value = Registry_->getValue<T>(key);
+				return true;
+			}
+			return false;
+		}
+
+		inline void onTimer([[maybe_unused]] Poco::Timer &timer) { Save(); }
 
 	  private:
-		std::string FileName;
-		Poco::JSON::Object::Ptr Registry_;
+		std::string Directory_;
+		std::string FileName_;
+		std::mutex Mutex_;
+		std::mutex FileMutex_;
+		Poco::JSON::Object::Ptr Registry_ = Poco::makeShared<Poco::JSON::Object>();
+		bool Dirty_ = false;
+		Poco::Timer Timer_;
+		std::unique_ptr<Poco::TimerCallback<AppServiceRegistry>> TimerCallback_;
+
+		AppServiceRegistry() {
+			Directory_ = MicroServiceDataDirectory();
+			FileName_ = Directory_ + "/registry.json";
+			Load();
+
+			TimerCallback_ = std::make_unique<Poco::TimerCallback<AppServiceRegistry>>(
+				*this, &AppServiceRegistry::onTimer);
+			Timer_.setStartInterval(FlushInterval);
+			Timer_.setPeriodicInterval(FlushInterval);
+			Timer_.start(*TimerCallback_);
+		}
+
+		//	The file is mapped and parsed in place, without copying it into a string first.
+		inline void Load() {
+			try {
+				Poco::File F(FileName_);
+				if (!F.exists() || F.getSize() == 0)
+					return;
+				Poco::SharedMemory Map(F, Poco::SharedMemory::AM_READ);
+				Poco::MemoryInputStream IS(Map.begin(), Map.end() - Map.begin());
+				Poco::JSON::Parser P;
+				Registry_ = P.parse(IS).extract<Poco::JSON::Object::Ptr>();
+			} catch (...) {
+				Registry_ = Poco::makeShared<Poco::JSON::Object>();
+			}
+		}
+
+		inline bool WriteFile(const std::string &Content) {
+			auto Temp = FileName_ + ".tmp";
+			auto fd = ::open(Temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0)
+				return false;
+			auto P = Content.data();
+			auto Left = Content.size();
+			while (Left > 0) {
+				auto Written = ::write(fd, P, Left);
+				if (Written < 0) {
+					if (errno == EINTR)
+						continue;
+					::close(fd);
+					return false;
+				}
+				P += Written;
+				Left -= Written;
+			}
+			if (::fsync(fd) != 0) {
+				::close(fd);
+				return false;
+			}
+			::close(fd);
+			if (std::rename(Temp.c_str(), FileName_.c_str()) != 0)
+				return false;
+			//	The rename itself is only durable once the directory is synced.
+			auto dir = ::open(Directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (dir >= 0) {
+				::fsync(dir);
+				::close(dir);
+			}
+			return true;
+		}
 	};
 
-	inline auto AppServiceRegistry() { return AppServiceRegistry::instance(); }
+	inline auto &AppServiceRegistry() { return AppServiceRegistry::instance(); }
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
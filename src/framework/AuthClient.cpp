@@ -2,131 +2,251 @@
 // Created by stephane bourque on 2022-10-25.
 //
 
+#include <algorithm>
+#include <functional>
+
 #include "Poco/Net/HTTPServerResponse.h"
 
 #include "fmt/format.h"
 #include "framework/AuthClient.h"
+#include "framework/MicroServiceFuncs.h"
 #include "framework/MicroServiceNames.h"
 #include "framework/OpenAPIRequests.h"
 #include "framework/utils.h"
 
 namespace OpenWifi {
 
-	bool AuthClient::RetrieveTokenInformation(const std::string &SessionToken,
-											  SecurityObjects::UserInfoAndPolicy &UInfo,
-											  std::uint64_t TID, bool &Expired, bool &Contacted,
-											  bool Sub) {
-		try {
-			Types::StringPairVec QueryData;
-			QueryData.push_back(std::make_pair("token", SessionToken));
-			std::string AlternateURIForLogging = fmt::format(
-				"{}?token={}", Sub ? "/api/v1/validateSubToken" : "/api/v1/validateToken",
-				Utils::SanitizeToken(SessionToken));
-			OpenAPIRequestGet Req(uSERVICE_SECURITY,
-								  Sub ? "/api/v1/validateSubToken" : "/api/v1/validateToken",
-								  QueryData, 10000, AlternateURIForLogging);
-			Poco::JSON::Object::Ptr Response;
+	int AuthClient::Start() {
+		poco_information(Logger(), "Starting...");
+		auto Shards = std::max((std::uint64_t)1,
+							   MicroServiceConfigGetInt("authentication.cache.shards", 8));
+		auto Size = MicroServiceConfigGetInt("authentication.cache.size", 4096);
+		auto ShardSize = (long)std::max((std::uint64_t)1, Size / Shards);
+		Lifetime_ = MicroServiceConfigGetInt("authentication.cache.lifetime", 1200);
+		NegativeLifetime_ = MicroServiceConfigGetInt("authentication.cache.negative", 30);
+		RefreshMargin_ = MicroServiceConfigGetInt("authentication.cache.refresh", 60);
 
-			auto StatusCode = Req.Do(Response);
-			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_GATEWAY_TIMEOUT) {
-				Contacted = false;
-				return false;
-			}
+		Tokens_.clear();
+		ApiKeys_.clear();
+		for (std::uint64_t i = 0; i < Shards; ++i) {
+			Tokens_.push_back(std::make_unique<ValidationCache>(ShardSize));
+			ApiKeys_.push_back(std::make_unique<ValidationCache>(ShardSize));
+		}
 
-			Contacted = true;
-			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_OK) {
-				if (Response->has("tokenInfo") && Response->has("userInfo")) {
-					UInfo.from_json(Response);
-					if (IsTokenExpired(UInfo.webtoken)) {
-						Expired = true;
-						return false;
-					}
-					Expired = false;
-					Cache_.update(SessionToken, UInfo);
-					return true;
-				} else {
-					return false;
-				}
-			}
-		} catch (...) {
-			poco_error(Logger(), fmt::format("Failed to retrieve token={} for TID={}",
-											 Utils::SanitizeToken(SessionToken), TID));
+		TimerCallback_ =
+			std::make_unique<Poco::TimerCallback<AuthClient>>(*this, &AuthClient::onTimer);
+		Timer_.setStartInterval(1000);
+		Timer_.setPeriodicInterval(1000);
+		Timer_.start(*TimerCallback_);
+		return 0;
+	}
+
+	void AuthClient::Stop() {
+		poco_information(Logger(), "Stopping...");
+		Timer_.stop();
+		for (auto &C : Tokens_)
+			C->clear();
+		for (auto &C : ApiKeys_)
+			C->clear();
+		poco_information(Logger(), "Stopped...");
+	}
+
+	void AuthClient::onTimer([[maybe_unused]] Poco::Timer &timer) {
+		Utils::SetThreadName("auth-refresh");
+		std::set<std::pair<Kind, std::string>> Work;
+		{
+			std::lock_guard G(RefreshMutex_);
+			Work.swap(Refresh_);
 		}
-		Expired = false;
-		return false;
+		for (const auto &[K, Token] : Work)
+			Validate(K, Token, 0);
 	}
 
-	bool AuthClient::IsAuthorized(const std::string &SessionToken,
-								  SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
-								  bool &Expired, bool &Contacted, bool Sub) {
-		auto User = Cache_.get(SessionToken);
-		if (!User.isNull()) {
-			if (IsTokenExpired(User->webtoken)) {
-				Expired = true;
-				Cache_.remove(SessionToken);
+	void AuthClient::RemovedCachedToken(const std::string &Token) {
+		if (Tokens_.empty())
+			return;
+		for (auto K : {Kind::Token, Kind::SubToken, Kind::ApiKey}) {
+			auto Key = (char)K + Token;
+			CacheFor(K, Key).remove(Key);
+		}
+	}
+
+	//	Entries are keyed by kind and token, as in Flights_: a token validated as a sub token
+	//	must not answer for the same string validated as a token.
+	AuthClient::ValidationCache &AuthClient::CacheFor(Kind K, const std::string &Key) {
+		auto &Shards = K == Kind::ApiKey ? ApiKeys_ : Tokens_;
+		return *Shards[std::hash<std::string>{}(Key) % Shards.size()];
+	}
+
+	bool AuthClient::Lookup(Kind K, const std::string &Token, Validation &V) {
+		if (Tokens_.empty())
+			return false;
+		auto Key = (char)K + Token;
+		auto &Cache = CacheFor(K, Key);
+		auto Entry = Cache.get(Key);
+		if (Entry.isNull())
+			return false;
+		V = *Entry;
+
+		auto Now = Utils::Now();
+		if (V.Valid && V.ExpiresOn != 0 && V.ExpiresOn < Now) {
+			Cache.remove(Key);
+			//	An expired API key may have been renewed: ask again.
+			if (K == Kind::ApiKey)
 				return false;
-			}
-			Expired = false;
-			UInfo = *User;
+			V.Valid = false;
+			V.Expired = true;
 			return true;
 		}
-		return RetrieveTokenInformation(SessionToken, UInfo, TID, Expired, Contacted, Sub);
+
+		auto Leaves = (std::uint64_t)V.Expiration.epochTime();
+		if (V.Valid && Leaves < Now + RefreshMargin_ &&
+			(V.ExpiresOn == 0 || V.ExpiresOn > Leaves)) {
+			std::lock_guard G(RefreshMutex_);
+			Refresh_.emplace(K, Token);
+		}
+		return true;
 	}
 
-	bool AuthClient::RetrieveApiKeyInformation(const std::string &SessionToken,
-											   SecurityObjects::UserInfoAndPolicy &UInfo,
-											   std::uint64_t TID, bool &Expired, bool &Contacted,
-											   [[maybe_unused]] bool &Suspended) {
+	AuthClient::Validation AuthClient::Validate(Kind K, const std::string &Token,
+												std::uint64_t TID) {
+		auto Key = (char)K + Token;
+		std::promise<Validation> Answer;
+		{
+			std::unique_lock G(FlightsMutex_);
+			auto Hint = Flights_.find(Key);
+			if (Hint != Flights_.end()) {
+				auto Pending = Hint->second;
+				G.unlock();
+				return Pending.get();
+			}
+			Flights_[Key] = Answer.get_future().share();
+		}
+
+		auto V = CallSecurityService(K, Token, TID);
+		//	Without an answer from the security service, nothing is known about the token.
+		if (V.Contacted && !Tokens_.empty()) {
+			auto Now = Utils::Now();
+			auto Leaves = V.Valid ? Now + Lifetime_ : Now + NegativeLifetime_;
+			if (V.Valid && V.ExpiresOn != 0)
+				Leaves = std::min(Leaves, V.ExpiresOn);
+			V.Expiration = Poco::Timestamp::fromEpochTime((std::time_t)Leaves);
+			CacheFor(K, Key).update(Key, V);
+		}
+
+		{
+			std::lock_guard G(FlightsMutex_);
+			Flights_.erase(Key);
+		}
+		Answer.set_value(V);
+		return V;
+	}
+
+	AuthClient::Validation AuthClient::CallSecurityService(Kind K, const std::string &Token,
+														   std::uint64_t TID) {
+		Validation V;
 		try {
 			Types::StringPairVec QueryData;
-			QueryData.push_back(std::make_pair("apikey", SessionToken));
-			std::string AlternateURIForLogging =
-				fmt::format("/api/v1/validateApiKey?apiKey={}", Utils::SanitizeToken(SessionToken));
-			OpenAPIRequestGet Req(uSERVICE_SECURITY, "/api/v1/validateApiKey", QueryData, 10000,
+			std::string EndPoint, AlternateURIForLogging;
+			if (K == Kind::ApiKey) {
+				QueryData.push_back(std::make_pair("apikey", Token));
+				EndPoint = "/api/v1/validateApiKey";
+				AlternateURIForLogging =
+					fmt::format("{}?apiKey={}", EndPoint, Utils::SanitizeToken(Token));
+			} else {
+				QueryData.push_back(std::make_pair("token", Token));
+				EndPoint =
+					K == Kind::SubToken ? "/api/v1/validateSubToken" : "/api/v1/validateToken";
+				AlternateURIForLogging =
+					fmt::format("{}?token={}", EndPoint, Utils::SanitizeToken(Token));
+			}
+			OpenAPIRequestGet Req(uSERVICE_SECURITY, EndPoint, QueryData, 10000,
 								  AlternateURIForLogging);
 			Poco::JSON::Object::Ptr Response;
 
 			auto StatusCode = Req.Do(Response);
-			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_GATEWAY_TIMEOUT) {
-				Contacted = false;
-				return false;
-			}
+			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_GATEWAY_TIMEOUT)
+				return V;
 
-			Contacted = true;
-			if (StatusCode == Poco::Net::HTTPServerResponse::HTTP_OK) {
-				if (Response->has("tokenInfo") && Response->has("userInfo") &&
-					Response->has("expiresOn")) {
-					UInfo.from_json(Response);
-					Expired = false;
-					ApiKeyCache_.update(SessionToken,
-										ApiKeyCacheEntry{.UserInfo = UInfo,
-														 .ExpiresOn = Response->get("expiresOn")});
-					return true;
+			V.Contacted = true;
+			if (StatusCode != Poco::Net::HTTPServerResponse::HTTP_OK ||
+				!Response->has("tokenInfo") || !Response->has("userInfo"))
+				return V;
+
+			if (K == Kind::ApiKey) {
+				if (!Response->has("expiresOn"))
+					return V;
+				V.UserInfo.from_json(Response);
+				V.ExpiresOn = Response->get("expiresOn");
+				V.Valid = true;
+			} else {
+				V.UserInfo.from_json(Response);
+				if (IsTokenExpired(V.UserInfo.webtoken)) {
+					V.Expired = true;
 				} else {
-					return false;
+					V.ExpiresOn = V.UserInfo.webtoken.created_ + V.UserInfo.webtoken.expires_in_;
+					V.Valid = true;
 				}
 			}
 		} catch (...) {
-			poco_error(Logger(), fmt::format("Failed to retrieve api key={} for TID={}",
-											 Utils::SanitizeToken(SessionToken), TID));
+			poco_error(Logger(), fmt::format("Failed to retrieve {}={} for TID={}",
+											 K == Kind::ApiKey ? "api key" : "token",
+											 Utils::SanitizeToken(Token), TID));
 		}
+		return V;
+	}
+
+	bool AuthClient::RetrieveTokenInformation(const std::string &SessionToken,
+											  SecurityObjects::UserInfoAndPolicy &UInfo,
+											  std::uint64_t TID, bool &Expired, bool &Contacted,
+											  bool Sub) {
+		auto V = Validate(Sub ? Kind::SubToken : Kind::Token, SessionToken, TID);
+		Contacted = V.Contacted;
+		Expired = V.Expired;
+		if (V.Valid)
+			UInfo = V.UserInfo;
+		return V.Valid;
+	}
+
+	bool AuthClient::IsAuthorized(const std::string &SessionToken,
+								  SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
+								  bool &Expired, bool &Contacted, bool Sub) {
+		Validation V;
+		if (!Lookup(Sub ? Kind::SubToken : Kind::Token, SessionToken, V))
+			return RetrieveTokenInformation(SessionToken, UInfo, TID, Expired, Contacted, Sub);
+		Contacted = true;
+		Expired = V.Expired;
+		if (V.Valid)
+			UInfo = V.UserInfo;
+		return V.Valid;
+	}
+
+	bool AuthClient::RetrieveApiKeyInformation(const std::string &SessionToken,
+											   SecurityObjects::UserInfoAndPolicy &UInfo,
+											   std::uint64_t TID, bool &Expired, bool &Contacted,
+											   bool &Suspended) {
+		auto V = Validate(Kind::ApiKey, SessionToken, TID);
+		Contacted = V.Contacted;
 		Expired = false;
-		return false;
+		Suspended = V.Suspended;
+		if (V.Valid)
+			UInfo = V.UserInfo;
+		return V.Valid;
 	}
 
 	bool AuthClient::IsValidApiKey(const std::string &SessionToken,
 								   SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
 								   bool &Expired, bool &Contacted, bool &Suspended) {
-		auto User = ApiKeyCache_.get(SessionToken);
-		if (!User.isNull()) {
-			if (User->ExpiresOn < Utils::Now()) {
-				Expired = false;
-				UInfo = User->UserInfo;
-				return true;
-			}
-			ApiKeyCache_.remove(SessionToken);
-		}
-		return RetrieveApiKeyInformation(SessionToken, UInfo, TID, Expired, Contacted, Suspended);
+		Validation V;
+		if (!Lookup(Kind::ApiKey, SessionToken, V))
+			return RetrieveApiKeyInformation(SessionToken, UInfo, TID, Expired, Contacted,
+											 Suspended);
+		Contacted = true;
+		Expired = false;
+		Suspended = V.Suspended;
+		if (V.Valid)
+			UInfo = V.UserInfo;
+		return V.Valid;
 	}
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
@@ -4,7 +4,15 @@
 
 #pragma once
 
-#include "Poco/ExpireLRUCache.h"
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "Poco/Timer.h"
+#include "Poco/UniqueExpireLRUCache.h"
 #include "RESTObjects/RESTAPI_SecurityObjects.h"
 #include "framework/SubSystemServer.h"
 #include "framework/utils.h"
@@ -22,24 +30,10 @@ namespace OpenWifi {
 			return instance_;
 		}
 
-		struct ApiKeyCacheEntry {
-			OpenWifi::SecurityObjects::UserInfoAndPolicy UserInfo;
-			std::uint64_t ExpiresOn;
-		};
-
-		inline int Start() override { return 0; }
-
-		inline void Stop() override {
-			poco_information(Logger(), "Stopping...");
-			std::lock_guard G(Mutex_);
-			Cache_.clear();
-			poco_information(Logger(), "Stopped...");
-		}
+		int Start() override;
+		void Stop() override;
 
-		inline void RemovedCachedToken(const std::string &Token) {
-			Cache_.remove(Token);
-			ApiKeyCache_.remove(Token);
-		}
+		void RemovedCachedToken(const std::string &Token);
 
 		inline static bool IsTokenExpired(const SecurityObjects::WebToken &T) {
 			return ((T.expires_in_ + T.created_) < Utils::Now());
@@ -61,10 +55,49 @@ namespace OpenWifi {
 						   SecurityObjects::UserInfoAndPolicy &UInfo, std::uint64_t TID,
 						   bool &Expired, bool &Contacted, bool &Suspended);
 
+		void onTimer(Poco::Timer &timer);
+
 	  private:
-		Poco::ExpireLRUCache<std::string, OpenWifi::SecurityObjects::UserInfoAndPolicy> Cache_{
-			512, 1200000};
-		Poco::ExpireLRUCache<std::string, ApiKeyCacheEntry> ApiKeyCache_{512, 1200000};
+		enum class Kind { Token = 't', SubToken = 's', ApiKey = 'k' };
+
+		//	The answer of the security service for a token or an API key. Rejected tokens are kept
+		//	too, for a short while, so a burst of bad tokens only reaches the security service once.
+		struct Validation {
+			SecurityObjects::UserInfoAndPolicy UserInfo;
+			bool Valid = false;
+			bool Expired = false;
+			bool Contacted = false;
+			bool Suspended = false;
+			//	When the token or key itself stops being valid.
+			std::uint64_t ExpiresOn = 0;
+			//	When the entry leaves the cache.
+			Poco::Timestamp Expiration;
+			[[nodiscard]] inline const Poco::Timestamp &getExpiration() const { return Expiration; }
+		};
+
+		typedef Poco::UniqueExpireLRUCache<std::string, Validation> ValidationCache;
+
+		std::vector<std::unique_ptr<ValidationCache>> Tokens_;
+		std::vector<std::unique_ptr<ValidationCache>> ApiKeys_;
+		std::uint64_t Lifetime_ = 1200;
+		std::uint64_t NegativeLifetime_ = 30;
+		std::uint64_t RefreshMargin_ = 60;
+
+		//	Validations in progress: callers asking for the same token wait for the same answer.
+		std::mutex FlightsMutex_;
+		std::map<std::string, std::shared_future<Validation>> Flights_;
+
+		//	Entries used shortly before they leave the cache are validated again in the
+		//	background, so active sessions never wait for the security service.
+		std::mutex RefreshMutex_;
+		std::set<std::pair<Kind, std::string>> Refresh_;
+		Poco::Timer Timer_;
+		std::unique_ptr<Poco::TimerCallback<AuthClient>> TimerCallback_;
+
+		ValidationCache &CacheFor(Kind K, const std::string &Key);
+		bool Lookup(Kind K, const std::string &Token, Validation &V);
+		Validation Validate(Kind K, const std::string &Token, std::uint64_t TID);
+		Validation CallSecurityService(Kind K, const std::string &Token, std::uint64_t TID);
 	};
 
 	inline auto AuthClient() { return AuthClient::instance(); }
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace OpenWifi {
+
+	//	Writes JSON straight into a string buffer. Objects serialized this way never go through
+	//	Poco::JSON::Object, so there is no Poco::Dynamic::Var allocated per field. Commas are
+	//	handled by the writer: callers only open/close containers and emit keys and values.
+	class JSONWriter {
+	  public:
+		explicit JSONWriter(std::string &Out, std::size_t Reserve = 0) : Out_(Out) {
+			if (Reserve)
+				Out_.reserve(Out_.size() + Reserve);
+		}
+
+		inline JSONWriter &StartObject() {
+			Separator();
+			Out_.push_back('{');
+			First_.push_back(true);
+			return *this;
+		}
+
+		inline JSONWriter &EndObject() {
+			Out_.push_back('}');
+			First_.pop_back();
+			return *this;
+		}
+
+		inline JSONWriter &StartArray() {
+			Separator();
+			Out_.push_back('[');
+			First_.push_back(true);
+			return *this;
+		}
+
+		inline JSONWriter &EndArray() {
+			Out_.push_back(']');
+			First_.pop_back();
+			return *this;
+		}
+
+		inline JSONWriter &Key(const char *K) {
+			Separator();
+			String(K, std::char_traits<char>::length(K));
+			Out_.push_back(':');
+			AfterKey_ = true;
+			return *this;
+		}
+
+		inline JSONWriter &Value(const std::string &S) {
+			Separator();
+			String(S.data(), S.size());
+			return *this;
+		}
+
+		inline JSONWriter &Value(const char *S) {
+			Separator();
+			String(S, std::char_traits<char>::length(S));
+			return *this;
+		}
+
+		inline JSONWriter &Value(bool B) {
+			Separator();
+			Out_.append(B ? "true" : "false");
+			return *this;
+		}
+
+		template <typename T>
+		inline std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, JSONWriter &>
+		Value(T N) {
+			Separator();
+			char Buffer[24];
+			auto R = std::to_chars(Buffer, Buffer + sizeof(Buffer), N);
+			Out_.append(Buffer, R.ptr - Buffer);
+			return *this;
+		}
+
+		inline JSONWriter &Value(double D) {
+			Separator();
+			if (!std::isfinite(D)) {
+				Out_.append("null");
+				return *this;
+			}
+			//	Shortest of the usual two precisions that still reads back as the same value.
+			char Buffer[32];
+			auto Len = std::snprintf(Buffer, sizeof(Buffer), "%.15g", D);
+			if (std::strtod(Buffer, nullptr) != D)
+				Len = std::snprintf(Buffer, sizeof(Buffer), "%.17g", D);
+			Out_.append(Buffer, Len);
+			return *this;
+		}
+
+		//	Appends an already serialized JSON document as the next value.
+		inline JSONWriter &Raw(const std::string &Json) {
+			Separator();
+			Out_.append(Json);
+			return *this;
+		}
+
+	  private:
+		std::string &Out_;
+		std::vector<bool> First_;
+		bool AfterKey_ = false;
+
+		inline void Separator() {
+			if (AfterKey_) {
+				AfterKey_ = false;
+				return;
+			}
+			if (First_.empty())
+				return;
+			if (First_.back())
+				First_.back() = false;
+			else
+				Out_.push_back(',');
+		}
+
+		inline void String(const char *S, std::size_t Len) {
+			static const char Hex[] = "0123456789abcdef";
+			Out_.push_back('"');
+			std::size_t Run = 0;
+			for (std::size_t i = 0; i < Len; ++i) {
+				auto C = (unsigned char)S[i];
+				if (C >= 0x20 && C != '"' && C != '\\')
+					continue;
+				Out_.append(S + Run, i - Run);
+				Run = i + 1;
+				switch (C) {
+				case '"':
+					Out_.append("\\\"");
+					break;
+				case '\\':
+					Out_.append("\\\\");
+					break;
+				case '\n':
+					Out_.append("\\n");
+					break;
+				case '\r':
+					Out_.append("\\r");
+					break;
+				case '\t':
+					Out_.append("\\t");
+					break;
+				case '\b':
+					Out_.append("\\b");
+					break;
+				case '\f':
+					Out_.append("\\f");
+					break;
+				default: {
+					char U[6] = {'\\', 'u', '0', '0', Hex[C >> 4], Hex[C & 0x0f]};
+					Out_.append(U, sizeof(U));
+				}
+				}
+			}
+			Out_.append(S + Run, Len - Run);
+			Out_.push_back('"');
+		}
+	};
+
+	//	Single pass decoder for the flat arrays stored in ORM columns (["a","b"] and [1,2]).
+	//	It gives up on anything it does not expect so the caller can fall back to Poco::JSON.
+	class JSONFlatArrayReader {
+	  public:
+		static bool Strings(const std::string &Doc, std::vector<std::string> &Result) {
+			JSONFlatArrayReader R(Doc);
+			return R.Array([&R, &Result]() {
+				std::string S;
+				if (!R.String(S))
+					return false;
+				Result.emplace_back(std::move(S));
+				return true;
+			});
+		}
+
+		template <typename T> static bool Numbers(const std::string &Doc, std::vector<T> &Result) {
+			JSONFlatArrayReader R(Doc);
+			return R.Array([&R, &Result]() {
+				T N;
+				if (!R.Number(N))
+					return false;
+				Result.push_back(N);
+				return true;
+			});
+		}
+
+	  private:
+		const char *P_, *End_;
+
+		explicit JSONFlatArrayReader(const std::string &Doc)
+			: P_(Doc.data()), End_(Doc.data() + Doc.size()) {}
+
+		inline void SkipSpace() {
+			while (P_ < End_ && (*P_ == ' ' || *P_ == '\n' || *P_ == '\r' || *P_ == '\t'))
+				++P_;
+		}
+
+		inline bool Expect(char C) {
+			SkipSpace();
+			if (P_ == End_ || *P_ != C)
+				return false;
+			++P_;
+			return true;
+		}
+
+		template <typename F> bool Array(F Element) {
+			if (!Expect('['))
+				return false;
+			SkipSpace();
+			if (P_ < End_ && *P_ == ']') {
+				++P_;
+			} else {
+				for (;;) {
+					SkipSpace();
+					if (!Element())
+						return false;
+					if (Expect(']'))
+						break;
+					if (!Expect(','))
+						return false;
+				}
+			}
+			SkipSpace();
+			return P_ == End_;
+		}
+
+		bool String(std::string &S) {
+			if (P_ == End_ || *P_ != '"')
+				return false;
+			++P_;
+			auto Run = P_;
+			while (P_ < End_) {
+				auto C = *P_;
+				if (C == '"') {
+					S.append(Run, P_ - Run);
+					++P_;
+					return true;
+				}
+				if (C != '\\') {
+					++P_;
+					continue;
+				}
+				S.append(Run, P_ - Run);
+				if (++P_ == End_)
+					return false;
+				switch (*P_) {
+				case '"':
+				case '\\':
+				case '/':
+					S.push_back(*P_);
+					break;
+				case 'n':
+					S.push_back('\n');
+					break;
+				case 'r':
+					S.push_back('\r');
+					break;
+				case 't':
+					S.push_back('\t');
+					break;
+				case 'b':
+					S.push_back('\b');
+					break;
+				case 'f':
+					S.push_back('\f');
+					break;
+				default:
+					//	\uXXXX and anything unusual is left to the full parser.
+					return false;
+				}
+				Run = ++P_;
+			}
+			return false;
+		}
+
+		template <typename T> bool Number(T &N) {
+			auto R = std::from_chars(P_, End_, N);
+			if (R.ec != std::errc() || R.ptr == P_)
+				return false;
+			//	Reject fractions and exponents in integer lists rather than truncating them.
+			if (R.ptr < End_ && (*R.ptr == '.' || *R.ptr == 'e' || *R.ptr == 'E'))
+				return false;
+			P_ = R.ptr;
+			return true;
+		}
+	};
+
+} // namespace OpenWifi
@@ -94,6 +94,10 @@ namespace OpenWifi {
 			R"lit( , "host" : ")lit" + MicroServicePrivateEndPoint() +
 			R"lit(" } , "payload" : )lit";
 
+		//	Keyed messages can be spread over the topic partitions by key, so messages about the
+		//	same device stay in order while consumers in one group share the load.
+		auto PartitionByKey = MicroServiceConfigGetBool("openwifi.kafka.partition.bykey", false);
+
 		cppkafka::Producer Producer(Config);
 		Running_ = true;
 
@@ -104,7 +108,8 @@ namespace OpenWifi {
 				if (Msg != nullptr) {
 					auto NewMessage = cppkafka::MessageBuilder(Msg->Topic());
 					NewMessage.key(Msg->Key());
-					NewMessage.partition(0);
+					if (!PartitionByKey || Msg->Key().empty())
+						NewMessage.partition(0);
 					NewMessage.payload(Msg->Payload());
 					Producer.produce(NewMessage);
 					if (Queue_.size() < 100) {
@@ -21,6 +21,8 @@ namespace OpenWifi::KafkaTopics {
 	inline const char * DEVICE_TELEMETRY = "device_telemetry";
 	inline const char * PROVISIONING_CHANGE = "provisioning_change";
 	inline const char * RRM = "rrm";
+	inline const char * PROVISIONING_JOBS = "provisioning_jobs";
+	inline const char * PROVISIONING_INVALIDATION = "provisioning_invalidation";
 
 	namespace ServiceEvents {
 		inline const char * EVENT_JOIN = "join";
@@ -3,6 +3,9 @@
 // Created by stephane bourque on 2022-10-26.
 //
 
+#include <algorithm>
+#include <cctype>
+
 #include "Poco/AsyncChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/FileChannel.h"
@@ -18,6 +21,7 @@
 #include "Poco/SplitterChannel.h"
 
 #include "framework/ALBserver.h"
+#include "framework/AppServiceRegistry.h"
 #include "framework/AuthClient.h"
 #include "framework/KafkaManager.h"
 #include "framework/MicroService.h"
@@ -181,33 +185,51 @@ namespace OpenWifi {
                 auto ss2 = MakeServiceListString(Services_);
                 poco_information(BusLogger, fmt::format("Current list of microservices: {} -> {}", ss1, ss2));
             }
+			PublishServices();
 
 		} catch (const Poco::Exception &E) {
 			BusLogger.log(E);
 		}
 	}
 
-	Types::MicroServiceMetaVec MicroService::GetServices(const std::string &Type) {
-		std::lock_guard G(InfraMutex_);
-
-		auto T = Poco::toLower(Type);
-		Types::MicroServiceMetaVec Res;
+	//	Called with InfraMutex_ held.
+	void MicroService::PublishServices() {
+		auto S = std::make_shared<ServiceSnapshot>();
+		S->Services = Services_;
+		std::map<std::string, Types::MicroServiceMetaVec> ByType;
+		Types::MicroServiceMetaVec All;
 		for (const auto &[_, ServiceRec] : Services_) {
-			if (ServiceRec.Type == T)
-				Res.push_back(ServiceRec);
+			ByType[ServiceRec.Type].push_back(ServiceRec);
+			All.push_back(ServiceRec);
 		}
-		return Res;
+		for (auto &[Type, Services] : ByType)
+			S->ByType[Type] = std::make_shared<Types::MicroServiceMetaVec>(std::move(Services));
+		S->All = std::make_shared<Types::MicroServiceMetaVec>(std::move(All));
+		std::atomic_store(&Snapshot_, std::shared_ptr<const ServiceSnapshot>(std::move(S)));
 	}
 
-	Types::MicroServiceMetaVec MicroService::GetServices() {
-		std::lock_guard G(InfraMutex_);
+	Types::MicroServiceMetaVecPtr MicroService::GetServiceList(const std::string &Type) {
+		static const Types::MicroServiceMetaVecPtr None{
+			std::make_shared<Types::MicroServiceMetaVec>()};
+		auto S = std::atomic_load(&Snapshot_);
+		auto Hint = S->ByType.find(Type);
+		//	Types are stored in lower case: callers almost always pass them that way already.
+		if (Hint == S->ByType.end() &&
+			std::any_of(Type.begin(), Type.end(), [](char C) { return std::isupper((unsigned char)C); }))
+			Hint = S->ByType.find(Poco::toLower(Type));
+		return Hint == S->ByType.end() ? None : Hint->second;
+	}
 
-		Types::MicroServiceMetaVec Res;
-		for (const auto &[_, ServiceRec] : Services_) {
-			Res.push_back(ServiceRec);
-		}
-		return Res;
+	Types::MicroServiceMetaVecPtr MicroService::GetServiceList() {
+		return std::atomic_load(&Snapshot_)->All;
+	}
 
+	Types::MicroServiceMetaVec MicroService::GetServices(const std::string &Type) {
+		return *GetServiceList(Type);
+	}
+
+	Types::MicroServiceMetaVec MicroService::GetServices() {
+		return *GetServiceList();
 	}
 
 	void MicroService::LoadConfigurationFile() {
@@ -441,11 +463,12 @@ namespace OpenWifi {
             InitializedBaseService = true;
             SubSystems_.push_back(KafkaManager());
             SubSystems_.push_back(ALBHealthCheckServer());
-            SubSystems_.push_back(RESTAPI_ExtServer());
-            SubSystems_.push_back(RESTAPI_IntServer());
+            SubSystems_.push_back(RESTAPI_RateLimiter());
 #ifndef TIP_SECURITY_SERVICE
             SubSystems_.push_back(AuthClient());
 #endif
+            SubSystems_.push_back(RESTAPI_ExtServer());
+            SubSystems_.push_back(RESTAPI_IntServer());
 
             Poco::Net::initializeSSL();
             Poco::Net::HTTPStreamFactory::registerFactory();
@@ -603,6 +626,7 @@ namespace OpenWifi {
 		for (auto i = SubSystems_.rbegin(); i != SubSystems_.rend(); ++i) {
 			(*i)->Stop();
 		}
+		AppServiceRegistry().Save();
 	}
 
 	[[nodiscard]] std::string MicroService::CreateUUID() {
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -108,6 +109,11 @@ namespace OpenWifi {
 		void BusMessageReceived(const std::string &Key, const std::string &Payload);
 		Types::MicroServiceMetaVec GetServices(const std::string &Type);
 		Types::MicroServiceMetaVec GetServices();
+		//	Shared lists from the current registry snapshot: no lock and no copy.
+		Types::MicroServiceMetaVecPtr GetServiceList(const std::string &Type);
+		Types::MicroServiceMetaVecPtr GetServiceList();
+		//	Where the next call to a service should start in a service list.
+		inline std::uint64_t NextService() { return NextService_++; }
 		void LoadConfigurationFile();
 		void Reload();
 		void LoadMyConfig();
@@ -170,15 +176,25 @@ namespace OpenWifi {
         inline void SetConfigContent(const std::string &Content) { ConfigContent_ = Content; }
 
         inline std::optional<OpenWifi::Types::MicroServiceMeta> GetPrivateEndPointServiceKey( const std::string & ServicePrivateEndPoint ) {
-            std::lock_guard   G(InfraMutex_);
-            auto K = Services_.find(ServicePrivateEndPoint);
-            if(K==end(Services_)) {
+            auto S = std::atomic_load(&Snapshot_);
+            auto K = S->Services.find(ServicePrivateEndPoint);
+            if(K==end(S->Services)) {
                 return std::nullopt;
             }
             return K->second;
         }
 
 	  private:
+		//	Immutable copy of Services_, replaced as a whole after every bus message so readers
+		//	never take InfraMutex_.
+		struct ServiceSnapshot {
+			Types::MicroServiceMetaMap Services;
+			Types::MicroServiceMetaVecPtr All{std::make_shared<Types::MicroServiceMetaVec>()};
+			std::map<std::string, Types::MicroServiceMetaVecPtr> ByType;
+		};
+
+		void PublishServices();
+
 		static MicroService *instance_;
 		bool HelpRequested_ = false;
 		std::string LogDir_;
@@ -192,6 +208,8 @@ namespace OpenWifi {
 		Poco::Crypto::CipherFactory &CipherFactory_ = Poco::Crypto::CipherFactory::defaultFactory();
 		Poco::Crypto::Cipher *Cipher_ = nullptr;
 		Types::MicroServiceMetaMap Services_;
+		std::shared_ptr<const ServiceSnapshot> Snapshot_{std::make_shared<ServiceSnapshot>()};
+		std::atomic_uint64_t NextService_{0};
 		std::string MyHash_;
 		std::string MyPrivateEndPoint_;
 		std::string MyPublicEndPoint_;
@@ -18,6 +18,15 @@ namespace OpenWifi {
 		return MicroService::instance().GetServices();
 	}
 
+	ServicesInTurn MicroServiceGetServicesInTurn(const std::string &Type) {
+		return ServicesInTurn{MicroService::instance().GetServiceList(Type),
+							  MicroService::instance().NextService()};
+	}
+
+	Types::MicroServiceMetaVecPtr MicroServiceGetServiceList(const std::string &Type) {
+		return MicroService::instance().GetServiceList(Type);
+	}
+
 	std::string MicroServicePublicEndPoint() { return MicroService::instance().PublicEndPoint(); }
 
 	std::string MicroServiceConfigGetString(const std::string &Key,
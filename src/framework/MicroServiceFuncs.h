@@ -19,6 +19,19 @@ namespace OpenWifi {
 	const std::string &MicroServiceDataDirectory();
 	Types::MicroServiceMetaVec MicroServiceGetServices(const std::string &Type);
 	Types::MicroServiceMetaVec MicroServiceGetServices();
+
+	//	The services of one type, in turn: each list starts one service further than the
+	//	previous one, so calls spread over all the instances of a service.
+	struct ServicesInTurn {
+		Types::MicroServiceMetaVecPtr List;
+		std::uint64_t First = 0;
+		[[nodiscard]] inline std::size_t size() const { return List->size(); }
+		[[nodiscard]] inline const Types::MicroServiceMeta &operator[](std::size_t i) const {
+			return (*List)[(First + i) % List->size()];
+		}
+	};
+	ServicesInTurn MicroServiceGetServicesInTurn(const std::string &Type);
+	Types::MicroServiceMetaVecPtr MicroServiceGetServiceList(const std::string &Type);
 	std::string MicroServicePublicEndPoint();
 	std::string MicroServiceConfigGetString(const std::string &Key,
 											const std::string &DefaultValue);
@@ -19,8 +19,9 @@ namespace OpenWifi {
 	OpenAPIRequestGet::Do(Poco::JSON::Object::Ptr &ResponseObject, const std::string &BearerToken) {
 		try {
 
-			auto Services = MicroServiceGetServices(Type_);
-			for (auto const &Svc : Services) {
+			auto Services = MicroServiceGetServicesInTurn(Type_);
+			for (std::size_t i = 0; i < Services.size(); ++i) {
+				const auto &Svc = Services[i];
 				Poco::URI URI(Svc.PrivateEndPoint);
 
 				auto Secure = (URI.getScheme() == "https");
@@ -81,8 +82,9 @@ namespace OpenWifi {
 	Poco::Net::HTTPServerResponse::HTTPStatus
 	OpenAPIRequestPut::Do(Poco::JSON::Object::Ptr &ResponseObject, const std::string &BearerToken) {
 		try {
-			auto Services = MicroServiceGetServices(Type_);
-			for (auto const &Svc : Services) {
+			auto Services = MicroServiceGetServicesInTurn(Type_);
+			for (std::size_t i = 0; i < Services.size(); ++i) {
+				const auto &Svc = Services[i];
 				Poco::URI URI(Svc.PrivateEndPoint);
 
 				auto Secure = (URI.getScheme() == "https");
@@ -158,9 +160,10 @@ namespace OpenWifi {
 	OpenAPIRequestPost::Do(Poco::JSON::Object::Ptr &ResponseObject,
 						   const std::string &BearerToken) {
 		try {
-			auto Services = MicroServiceGetServices(Type_);
+			auto Services = MicroServiceGetServicesInTurn(Type_);
 
-			for (auto const &Svc : Services) {
+			for (std::size_t i = 0; i < Services.size(); ++i) {
+				const auto &Svc = Services[i];
 				Poco::URI URI(Svc.PrivateEndPoint);
 
 				auto Secure = (URI.getScheme() == "https");
@@ -233,9 +236,10 @@ namespace OpenWifi {
 	Poco::Net::HTTPServerResponse::HTTPStatus
 	OpenAPIRequestDelete::Do(const std::string &BearerToken) {
 		try {
-			auto Services = MicroServiceGetServices(Type_);
+			auto Services = MicroServiceGetServicesInTurn(Type_);
 
-			for (auto const &Svc : Services) {
+			for (std::size_t i = 0; i < Services.size(); ++i) {
+				const auto &Svc = Services[i];
 				Poco::URI URI(Svc.PrivateEndPoint);
 
 				auto Secure = (URI.getScheme() == "https");
@@ -7,6 +7,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <string>
@@ -44,6 +45,7 @@ namespace OpenWifi::Types {
 
 	typedef std::map<std::string, MicroServiceMeta> MicroServiceMetaMap;
 	typedef std::vector<MicroServiceMeta> MicroServiceMetaVec;
+	typedef std::shared_ptr<const MicroServiceMetaVec> MicroServiceMetaVecPtr;
 } // namespace OpenWifi::Types
 
 namespace OpenWifi {
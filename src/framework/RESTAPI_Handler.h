@@ -4,8 +4,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <list>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Poco/DeflatingStream.h"
@@ -82,8 +87,8 @@ namespace OpenWifi {
 					}
 				}
 
-				if (RateLimited_ && RESTAPI_RateLimiter()->IsRateLimited(
-										RequestIn, MyRates_.Interval, MyRates_.MaxCalls)) {
+				if (RESTAPI_RateLimiter()->IsRateLimited(RequestIn, MyRates_.Interval,
+														 RateLimited_ ? MyRates_.MaxCalls : 0)) {
 					return UnAuthorized(RESTAPI::Errors::RATE_LIMIT_EXCEEDED);
 				}
 
@@ -100,6 +105,11 @@ namespace OpenWifi {
 						return UnAuthorized(RESTAPI::Errors::SECURITY_SERVICE_UNREACHABLE);
 				}
 
+				if (AlwaysAuthorize_ && !Internal_ && Request->has("X-API-KEY") &&
+					RESTAPI_RateLimiter()->IsApiKeyRateLimited(RequestIn, SessionToken_)) {
+					return UnAuthorized(RESTAPI::Errors::RATE_LIMIT_EXCEEDED);
+				}
+
 				std::string Reason;
 				if (!RoleIsAuthorized(RequestIn.getURI(), Request->getMethod(), Reason)) {
 					return UnAuthorized(RESTAPI::Errors::ACCESS_DENIED);
@@ -585,6 +595,9 @@ namespace OpenWifi {
         }
 
         template<class T> void ReturnObject(const std::vector<T> &Objects) {
+            if constexpr (RESTAPI_utils::has_json_writer<T>::value) {
+                return ReturnRawJSON(RESTAPI_utils::to_string(Objects));
+            }
             Poco::JSON::Array   Arr;
             for(const auto &Object:Objects) {
                 Poco::JSON::Object O;
@@ -597,6 +610,9 @@ namespace OpenWifi {
         }
 
         template<class T> void ReturnObject(const T &Object) {
+            if constexpr (RESTAPI_utils::has_json_writer<T>::value) {
+                return ReturnRawJSON(RESTAPI_utils::to_string(Object));
+            }
             Poco::JSON::Object  O;
             Object.to_json(O);
             std::ostringstream os;
@@ -687,6 +703,14 @@ namespace OpenWifi {
 		}
 
 		template <typename T> void ReturnObject(const char *Name, const std::vector<T> &Objects) {
+			if constexpr (RESTAPI_utils::has_json_writer<T>::value) {
+				std::string Out;
+				JSONWriter W(Out);
+				W.StartObject();
+				RESTAPI_utils::field_to_json(W, Name, Objects);
+				W.EndObject();
+				return ReturnRawJSON(Out);
+			}
 			Poco::JSON::Object Answer;
 			RESTAPI_utils::field_to_json(Answer, Name, Objects);
 			ReturnObject(Answer);
@@ -860,23 +884,149 @@ namespace OpenWifi {
 	}
 	constexpr auto test_has_PathName_method(...) -> std::false_type { return std::false_type{}; }
 
+	//	All the paths served by a router, as a trie of path segments. A request path is split
+	//	once and walked down the trie, trying literal segments before {parameters}. When several
+	//	paths match, the one listed first wins, as when each handler was tried in turn.
+	class RESTAPI_RouteTrie {
+	  public:
+		static constexpr std::size_t NoRoute = std::numeric_limits<std::size_t>::max();
+
+		inline void Add(std::size_t Handler, const std::list<std::string> &Paths) {
+			for (const auto &Path : Paths) {
+				Route R{Handler, {}};
+				std::size_t Node = 0;
+				for (const auto &Segment : Split(Path)) {
+					std::size_t Next;
+					if (!Segment.empty() && Segment.front() == '{') {
+						R.Params.push_back(
+							Poco::toLower(std::string{Segment.substr(1, Segment.size() - 2)}));
+						Next = Nodes_[Node].Param;
+						if (Next == 0) {
+							Next = Nodes_.size();
+							Nodes_[Node].Param = Next;
+							Nodes_.emplace_back();
+						}
+					} else {
+						R.Params.emplace_back();
+						auto Hint = Nodes_[Node].Literals.find(Segment);
+						if (Hint == Nodes_[Node].Literals.end()) {
+							Next = Nodes_.size();
+							Nodes_[Node].Literals.emplace(std::string{Segment}, Next);
+							Nodes_.emplace_back();
+						} else {
+							Next = Hint->second;
+						}
+					}
+					Node = Next;
+				}
+				if (Nodes_[Node].Route == NoRoute)
+					Nodes_[Node].Route = Routes_.size();
+				Routes_.push_back(std::move(R));
+			}
+		}
+
+		//	Returns the index of the handler for Path, or NoRoute, and fills its bindings.
+		inline std::size_t Resolve(const std::string &Path,
+								   RESTAPIHandler::BindingMap &Bindings) const {
+			Bindings.clear();
+			auto Segments = Split(Path);
+			std::size_t Best = NoRoute;
+			Find(0, Segments, 0, Best);
+			if (Best == NoRoute)
+				return NoRoute;
+			const auto &R = Routes_[Best];
+			for (std::size_t i = 0; i < Segments.size(); ++i) {
+				if (!R.Params[i].empty())
+					Bindings[R.Params[i]] = std::string{Segments[i]};
+			}
+			return R.Handler;
+		}
+
+	  private:
+		struct Node {
+			std::map<std::string, std::size_t, std::less<>> Literals;
+			std::size_t Param = 0;
+			std::size_t Route = NoRoute;
+		};
+
+		struct Route {
+			std::size_t Handler;
+			//	One entry per segment: the binding name, or empty for a literal segment.
+			std::vector<std::string> Params;
+		};
+
+		std::vector<Node> Nodes_{1};
+		std::vector<Route> Routes_;
+
+		//	Same segments as Poco::StringTokenizer(Path, "/"), empty ones included.
+		static inline std::vector<std::string_view> Split(std::string_view Path) {
+			std::vector<std::string_view> Segments;
+			std::size_t From = 0;
+			while (true) {
+				auto To = Path.find('/', From);
+				if (To == std::string_view::npos) {
+					Segments.push_back(Path.substr(From));
+					return Segments;
+				}
+				Segments.push_back(Path.substr(From, To - From));
+				From = To + 1;
+			}
+		}
+
+		inline void Find(std::size_t N, const std::vector<std::string_view> &Segments,
+						 std::size_t Depth, std::size_t &Best) const {
+			const auto &Current = Nodes_[N];
+			if (Depth == Segments.size()) {
+				Best = std::min(Best, Current.Route);
+				return;
+			}
+			if (auto Hint = Current.Literals.find(Segments[Depth]); Hint != Current.Literals.end())
+				Find(Hint->second, Segments, Depth + 1, Best);
+			if (Current.Param != 0)
+				Find(Current.Param, Segments, Depth + 1, Best);
+		}
+	};
+
+	template <typename T>
+	RESTAPIHandler *RESTAPI_MakeHandler(const RESTAPIHandler::BindingMap &Bindings,
+										Poco::Logger &Logger,
+										RESTAPI_GenericServerAccounting &Server,
+										uint64_t TransactionId, bool Internal) {
+		return new T(Bindings, Logger, Server, TransactionId, Internal);
+	}
+
+	//	The trie is built on the first request, once per list of handlers.
+	template <typename... Handlers>
+	RESTAPIHandler *RESTAPI_Dispatch(const std::string &RequestedPath,
+									 RESTAPIHandler::BindingMap &Bindings, Poco::Logger &Logger,
+									 RESTAPI_GenericServerAccounting &Server,
+									 uint64_t TransactionId, bool Internal) {
+		static_assert((test_has_PathName_method((Handlers *)nullptr) && ...),
+					  "Class must have a static PathName() method.");
+		static const RESTAPI_RouteTrie Trie = [] {
+			RESTAPI_RouteTrie R;
+			std::size_t Handler = 0;
+			(R.Add(Handler++, Handlers::PathName()), ...);
+			return R;
+		}();
+		static constexpr std::array<decltype(&RESTAPI_MakeHandler<RESTAPI_UnknownRequestHandler>),
+									sizeof...(Handlers)>
+			Factories{&RESTAPI_MakeHandler<Handlers>...};
+
+		auto Handler = Trie.Resolve(RequestedPath, Bindings);
+		if (Handler == RESTAPI_RouteTrie::NoRoute)
+			return new RESTAPI_UnknownRequestHandler(Bindings, Logger, Server, TransactionId,
+													 Internal);
+		return Factories[Handler](Bindings, Logger, Server, TransactionId, Internal);
+	}
+
 	template <typename T, typename... Args>
 	RESTAPIHandler *RESTAPI_Router(const std::string &RequestedPath,
 								   RESTAPIHandler::BindingMap &Bindings, Poco::Logger &Logger,
 								   RESTAPI_GenericServerAccounting &Server,
 								   uint64_t TransactionId) {
-		static_assert(test_has_PathName_method((T *)nullptr),
-					  "Class must have a static PathName() method.");
-		if (RESTAPIHandler::ParseBindings(RequestedPath, T::PathName(), Bindings)) {
-			return new T(Bindings, Logger, Server, TransactionId, false);
-		}
-
-		if constexpr (sizeof...(Args) == 0) {
-			return new RESTAPI_UnknownRequestHandler(Bindings, Logger, Server, TransactionId,
-													 false);
-		} else {
-			return RESTAPI_Router<Args...>(RequestedPath, Bindings, Logger, Server, TransactionId);
-		}
+		return RESTAPI_Dispatch<T, Args...>(RequestedPath, Bindings, Logger, Server,
+											TransactionId, false);
 	}
 
 	template <typename T, typename... Args>
@@ -884,18 +1034,8 @@ namespace OpenWifi {
 									 RESTAPIHandler::BindingMap &Bindings, Poco::Logger &Logger,
 									 RESTAPI_GenericServerAccounting &Server,
 									 uint64_t TransactionId) {
-		static_assert(test_has_PathName_method((T *)nullptr),
-					  "Class must have a static PathName() method.");
-		if (RESTAPIHandler::ParseBindings(RequestedPath, T::PathName(), Bindings)) {
-			return new T(Bindings, Logger, Server, TransactionId, true);
-		}
-
-		if constexpr (sizeof...(Args) == 0) {
-			return new RESTAPI_UnknownRequestHandler(Bindings, Logger, Server, TransactionId, true);
-		} else {
-			return RESTAPI_Router_I<Args...>(RequestedPath, Bindings, Logger, Server,
-											 TransactionId);
-		}
+		return RESTAPI_Dispatch<T, Args...>(RequestedPath, Bindings, Logger, Server,
+											TransactionId, true);
 	}
 
 } // namespace OpenWifi
@@ -4,64 +4,223 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "framework/MicroServiceFuncs.h"
 #include "framework/SubSystemServer.h"
 
-#include "Poco/ExpireLRUCache.h"
+#include "Poco/JSON/Object.h"
 #include "Poco/Net/HTTPServerRequest.h"
-#include "Poco/URI.h"
+#include "Poco/StringTokenizer.h"
 
 #include "fmt/format.h"
 
 namespace OpenWifi {
 
+	//	Sliding window limits per client and path. Clients are the caller IP address, and once
+	//	it has been validated, the X-API-KEY they present. Entries live in fixed slots spread over Shards independent locks,
+	//	so checking a request allocates nothing and callers rarely wait on each other. When all
+	//	the slots a client may use are taken, the least recently used one is recycled.
 	class RESTAPI_RateLimiter : public SubSystemServer {
 	  public:
-		struct ClientCacheEntry {
-			int64_t Start = 0;
-			int Count = 0;
-		};
+		static constexpr std::size_t Shards = 16;
+		static constexpr std::size_t SlotsPerShard = 256;
+		static constexpr std::size_t Probes = 4;
 
 		static auto instance() {
 			static auto instance_ = new RESTAPI_RateLimiter;
 			return instance_;
 		}
 
-		inline int Start() final { return 0; };
+		//	rate.limiter.routes = /api/v1/signup:1000:10, /api/v1/inventory:1000:100
+		//	Each entry is a path prefix, a period in milliseconds and the calls allowed per period.
+		inline int Start() final {
+			Routes_.clear();
+			Poco::StringTokenizer Entries(MicroServiceConfigGetString("rate.limiter.routes", ""),
+										  ",", Poco::StringTokenizer::TOK_TRIM |
+												   Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+			for (const auto &Entry : Entries) {
+				Poco::StringTokenizer Fields(Entry, ":", Poco::StringTokenizer::TOK_TRIM);
+				try {
+					if (Fields.count() == 3 && std::stoll(Fields[1]) > 0) {
+						auto R = std::make_unique<RouteLimit>();
+						R->Prefix = Fields[0];
+						R->Interval = std::stoll(Fields[1]);
+						R->MaxCalls = std::stoll(Fields[2]);
+						Routes_.push_back(std::move(R));
+						continue;
+					}
+				} catch (const std::exception &) {
+				}
+				poco_warning(Logger(), fmt::format("Ignoring rate limit '{}'.", Entry));
+			}
+			ApiKeyInterval_ = MicroServiceConfigGetInt("rate.limiter.apikey.interval", 1000);
+			ApiKeyMaxCalls_ = MicroServiceConfigGetInt("rate.limiter.apikey.maxcalls", 0);
+			return 0;
+		};
 		inline void Stop() final{};
 
+		//	MaxCalls is the limit set by the handler, 0 when it is not rate limited. A configured
+		//	route limit replaces it.
 		inline bool IsRateLimited(const Poco::Net::HTTPServerRequest &R, int64_t Period,
 								  int64_t MaxCalls) {
-			Poco::URI uri(R.getURI());
-			auto H = str_hash(uri.getPath() + R.clientAddress().host().toString());
-			auto E = Cache_.get(H);
-			auto Now = std::chrono::duration_cast<std::chrono::milliseconds>(
-						   std::chrono::system_clock::now().time_since_epoch())
-						   .count();
-			if (E.isNull()) {
-				Cache_.add(H, ClientCacheEntry{.Start = Now, .Count = 1});
-				return false;
-			}
-			if ((Now - E->Start) < Period) {
-				E->Count++;
-				Cache_.update(H, E);
-				if (E->Count > MaxCalls) {
-					poco_warning(Logger(), fmt::format("RATE-LIMIT-EXCEEDED: from '{}'",
-													   R.clientAddress().toString()));
-					return true;
+			std::string_view Path{R.getURI()};
+			Path = Path.substr(0, Path.find('?'));
+
+			RouteLimit *Route = nullptr;
+			for (const auto &Candidate : Routes_) {
+				if (Path.substr(0, Candidate->Prefix.size()) == Candidate->Prefix) {
+					Route = Candidate.get();
+					Period = Route->Interval;
+					MaxCalls = Route->MaxCalls;
+					break;
 				}
+			}
+
+			if (MaxCalls <= 0 || Period <= 0)
 				return false;
+
+			//	Always the address: the X-API-KEY header is not verified yet at this point, and a
+			//	new value on every call would otherwise get a new bucket every time.
+			auto Host = R.clientAddress().host();
+			auto H = Hash(FNV_Offset, Host.addr(), Host.length());
+			return Limited(R, Hash(H, Path.data(), Path.size()), Period, MaxCalls, Route);
+		}
+
+		//	The rate.limiter.apikey.* limit, for a request whose X-API-KEY has been accepted.
+		inline bool IsApiKeyRateLimited(const Poco::Net::HTTPServerRequest &R,
+										const std::string &ApiKey) {
+			if (ApiKeyMaxCalls_ == 0 || ApiKeyInterval_ == 0)
+				return false;
+			std::string_view Path{R.getURI()};
+			Path = Path.substr(0, Path.find('?'));
+			//	Keys and addresses do not share buckets.
+			auto H = Hash(FNV_Offset, "k", 1);
+			H = Hash(H, ApiKey.data(), ApiKey.size());
+			return Limited(R, Hash(H, Path.data(), Path.size()), (int64_t)ApiKeyInterval_,
+						   (int64_t)ApiKeyMaxCalls_, nullptr);
+		}
+
+		inline void Clear() {
+			for (auto &S : Shards_) {
+				std::lock_guard G(S.Mutex);
+				S.Slots.fill(Slot{});
 			}
-			E->Start = Now;
-			E->Count = 1;
-			Cache_.update(H, E);
-			return false;
 		}
 
-		inline void Clear() { Cache_.clear(); }
+		inline void to_json(Poco::JSON::Object &Obj) const {
+			Obj.set("allowed", Allowed_.load());
+			Obj.set("throttled", Throttled_.load());
+			Poco::JSON::Array Routes;
+			for (const auto &Route : Routes_) {
+				Poco::JSON::Object O;
+				O.set("prefix", Route->Prefix);
+				O.set("interval", Route->Interval);
+				O.set("maxCalls", Route->MaxCalls);
+				O.set("throttled", Route->Throttled.load());
+				Routes.add(O);
+			}
+			Obj.set("routes", Routes);
+		}
 
 	  private:
-		Poco::ExpireLRUCache<uint64_t, ClientCacheEntry> Cache_{2048};
-		std::hash<std::string> str_hash;
+		static constexpr std::uint64_t FNV_Offset = 0xcbf29ce484222325ULL;
+
+		struct Slot {
+			std::uint64_t Key = 0;
+			int64_t Window = 0;
+			int64_t Current = 0;
+			int64_t Previous = 0;
+			int64_t LastSeen = 0;
+		};
+
+		struct Shard {
+			std::mutex Mutex;
+			std::array<Slot, SlotsPerShard> Slots;
+		};
+
+		struct RouteLimit {
+			std::string Prefix;
+			int64_t Interval = 1000;
+			int64_t MaxCalls = 10;
+			std::atomic_uint64_t Throttled{0};
+		};
+
+		std::array<Shard, Shards> Shards_;
+		std::vector<std::unique_ptr<RouteLimit>> Routes_;
+		std::uint64_t ApiKeyInterval_ = 1000;
+		std::uint64_t ApiKeyMaxCalls_ = 0;
+		std::atomic_uint64_t Allowed_{0};
+		std::atomic_uint64_t Throttled_{0};
+
+		static inline std::uint64_t Hash(std::uint64_t H, const void *Data, std::size_t Size) {
+			auto P = static_cast<const unsigned char *>(Data);
+			for (std::size_t i = 0; i < Size; ++i) {
+				H ^= P[i];
+				H *= 0x100000001b3ULL;
+			}
+			return H;
+		}
+
+		inline bool Limited(const Poco::Net::HTTPServerRequest &R, std::uint64_t H,
+							int64_t Period, int64_t MaxCalls, RouteLimit *Route) {
+			if (H == 0)
+				H = 1;
+			auto Now = std::chrono::duration_cast<std::chrono::milliseconds>(
+						   std::chrono::steady_clock::now().time_since_epoch())
+						   .count();
+			if (Allow(H, Now, Period, MaxCalls)) {
+				Allowed_++;
+				return false;
+			}
+
+			Throttled_++;
+			if (Route != nullptr)
+				Route->Throttled++;
+			poco_warning(Logger(), fmt::format("RATE-LIMIT-EXCEEDED: from '{}'",
+											   R.clientAddress().toString()));
+			return true;
+		}
+
+		//	The calls of the previous period count in proportion of how much of it still falls
+		//	within the last Period milliseconds.
+		inline bool Allow(std::uint64_t Key, int64_t Now, int64_t Period, int64_t MaxCalls) {
+			auto &S = Shards_[(Key >> 32) % Shards];
+			std::lock_guard G(S.Mutex);
+
+			auto First = (Key & 0xffffffff) % SlotsPerShard;
+			Slot *E = &S.Slots[First];
+			for (std::size_t i = 0; i < Probes; ++i) {
+				auto &Candidate = S.Slots[(First + i) % SlotsPerShard];
+				if (Candidate.Key == Key) {
+					E = &Candidate;
+					break;
+				}
+				if (Candidate.LastSeen < E->LastSeen)
+					E = &Candidate;
+			}
+			if (E->Key != Key)
+				*E = Slot{Key};
+
+			auto Window = Now / Period;
+			if (Window != E->Window) {
+				E->Previous = (Window == E->Window + 1) ? E->Current : 0;
+				E->Current = 0;
+				E->Window = Window;
+			}
+			E->LastSeen = Now;
+			auto Weighted = E->Previous * (Period - Now % Period) / Period + E->Current;
+			if (Weighted >= MaxCalls)
+				return false;
+			E->Current++;
+			return true;
+		}
 
 		RESTAPI_RateLimiter() noexcept
 			: SubSystemServer("RateLimiter", "RATE-LIMITER", "rate.limiter") {}
@@ -69,4 +228,4 @@ namespace OpenWifi {
 
 	inline auto RESTAPI_RateLimiter() { return RESTAPI_RateLimiter::instance(); }
 
-} // namespace OpenWifi
\ No newline at end of file
+} // namespace OpenWifi
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "framework/RESTAPI_Handler.h"
+#include "framework/UI_WebSocketClientServer.h"
+#include "framework/orm_stats.h"
 
 #include "Poco/Environment.h"
 
@@ -81,6 +83,23 @@ namespace OpenWifi {
 					Answer.set("peakVirtMem", peakVirtMem);
 					return ReturnObject(Answer);
 				}
+				if (Arg == "uiWebSocketQueues") {
+					Poco::JSON::Object Answer;
+					UI_WebSocketClientServer()->GetQueueStats(Answer);
+					return ReturnObject(Answer);
+				}
+				if (Arg == "ormStats") {
+					Poco::JSON::Object Answer;
+					ORM::QueryStats()->to_json(Answer);
+					if (GetBoolParameter("reset", false))
+						ORM::QueryStats()->Reset();
+					return ReturnObject(Answer);
+				}
+				if (Arg == "rateLimiter") {
+					Poco::JSON::Object Answer;
+					RESTAPI_RateLimiter()->to_json(Answer);
+					return ReturnObject(Answer);
+				}
 			}
 			BadRequest(RESTAPI::Errors::InvalidCommand);
 		}
@@ -11,6 +11,7 @@
 #include "Poco/JSON/Parser.h"
 #include "Poco/Net/HTTPServerRequest.h"
 
+#include "framework/JSONCodec.h"
 #include "framework/OpenWifiTypes.h"
 #include "framework/utils.h"
 
@@ -178,6 +179,107 @@ namespace OpenWifi::RESTAPI_utils {
 		Obj.set(Field, Answer);
 	}
 
+	///////////////////////////
+	//	Same fields, written straight into a buffer by a JSONWriter. Objects that implement
+	//	to_json(JSONWriter &) write their members into the currently open object, exactly like
+	//	to_json(Poco::JSON::Object &). Everything else falls back to the Poco serializer.
+	///////////////////////////
+
+	template <typename T, typename = void> struct has_json_writer : std::false_type {};
+	template <typename T>
+	struct has_json_writer<
+		T, std::void_t<decltype(std::declval<const T &>().to_json(std::declval<JSONWriter &>()))>>
+		: std::true_type {};
+
+	template <class T> void object_to_json(JSONWriter &W, const T &Value) {
+		if constexpr (has_json_writer<T>::value) {
+			W.StartObject();
+			Value.to_json(W);
+			W.EndObject();
+		} else {
+			Poco::JSON::Object O;
+			Value.to_json(O);
+			std::ostringstream OS;
+			Poco::JSON::Stringifier::condense(O, OS);
+			W.Raw(OS.str());
+		}
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, bool V) { W.Key(Field).Value(V); }
+
+	inline void field_to_json(JSONWriter &W, const char *Field, double V) {
+		W.Key(Field).Value(V);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const std::string &S) {
+		W.Key(Field).Value(S);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const char *S) {
+		W.Key(Field).Value(S);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, int32_t Value) {
+		W.Key(Field).Value(Value);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, int64_t Value) {
+		W.Key(Field).Value(Value);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, uint32_t Value) {
+		W.Key(Field).Value(Value);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, uint64_t Value) {
+		W.Key(Field).Value(Value);
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const Types::StringVec &V) {
+		W.Key(Field).StartArray();
+		for (const auto &i : V)
+			W.Value(i);
+		W.EndArray();
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const Types::TagList &V) {
+		W.Key(Field).StartArray();
+		for (const auto &i : V)
+			W.Value(i);
+		W.EndArray();
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const Types::IntList &V) {
+		W.Key(Field).StartArray();
+		for (const auto &i : V)
+			W.Value(i);
+		W.EndArray();
+	}
+
+	inline void field_to_json(JSONWriter &W, const char *Field, const Types::StringPairVec &S) {
+		W.Key(Field).StartArray();
+		for (const auto &i : S) {
+			W.StartObject();
+			W.Key("tag").Value(i.first);
+			W.Key("value").Value(i.second);
+			W.EndObject();
+		}
+		W.EndArray();
+	}
+
+	template <class T>
+	void field_to_json(JSONWriter &W, const char *Field, const std::vector<T> &Value) {
+		W.Key(Field).StartArray();
+		for (const auto &i : Value)
+			object_to_json(W, i);
+		W.EndArray();
+	}
+
+	template <class T> void field_to_json(JSONWriter &W, const char *Field, const T &Value) {
+		W.Key(Field);
+		object_to_json(W, Value);
+	}
+
 	///////////////////////////
 	///////////////////////////
 	///////////////////////////
@@ -343,27 +445,27 @@ namespace OpenWifi::RESTAPI_utils {
 	}
 
 	inline std::string to_string(const Types::TagList &ObjectArray) {
-		Poco::JSON::Array OutputArr;
 		if (ObjectArray.empty())
 			return "[]";
-		for (auto const &i : ObjectArray) {
-			OutputArr.add(i);
-		}
-		std::ostringstream OS;
-		Poco::JSON::Stringifier::stringify(OutputArr, OS, 0, 0, Poco::JSON_PRESERVE_KEY_ORDER);
-		return OS.str();
+		std::string Out;
+		JSONWriter W(Out, 2 + ObjectArray.size() * 12);
+		W.StartArray();
+		for (auto const &i : ObjectArray)
+			W.Value(i);
+		W.EndArray();
+		return Out;
 	}
 
 	inline std::string to_string(const Types::StringVec &ObjectArray) {
-		Poco::JSON::Array OutputArr;
 		if (ObjectArray.empty())
 			return "[]";
-		for (auto const &i : ObjectArray) {
-			OutputArr.add(i);
-		}
-		std::ostringstream OS;
-		Poco::JSON::Stringifier::condense(OutputArr, OS);
-		return OS.str();
+		std::string Out;
+		JSONWriter W(Out, 2 + ObjectArray.size() * 40);
+		W.StartArray();
+		for (auto const &i : ObjectArray)
+			W.Value(i);
+		W.EndArray();
+		return Out;
 	}
 
 	inline std::string to_string(const Types::StringPairVec &ObjectArray) {
@@ -382,9 +484,18 @@ namespace OpenWifi::RESTAPI_utils {
 	}
 
 	template <class T> std::string to_string(const std::vector<T> &ObjectArray) {
-		Poco::JSON::Array OutputArr;
 		if (ObjectArray.empty())
 			return "[]";
+		if constexpr (has_json_writer<T>::value) {
+			std::string Out;
+			JSONWriter W(Out);
+			W.StartArray();
+			for (auto const &i : ObjectArray)
+				object_to_json(W, i);
+			W.EndArray();
+			return Out;
+		}
+		Poco::JSON::Array OutputArr;
 		for (auto const &i : ObjectArray) {
 			Poco::JSON::Object O;
 			i.to_json(O);
@@ -422,6 +533,12 @@ namespace OpenWifi::RESTAPI_utils {
 	}
 
 	template <class T> std::string to_string(const T &Object) {
+		if constexpr (has_json_writer<T>::value) {
+			std::string Out;
+			JSONWriter W(Out);
+			object_to_json(W, Object);
+			return Out;
+		}
 		Poco::JSON::Object OutputObj;
 		Object.to_json(OutputObj);
 		std::ostringstream OS;
@@ -434,7 +551,10 @@ namespace OpenWifi::RESTAPI_utils {
 		Types::StringVec Result;
 		if (ObjectString.empty())
 			return Result;
+		if (JSONFlatArrayReader::Strings(ObjectString, Result))
+			return Result;
 
+		Result.clear();
 		try {
 			Poco::JSON::Parser P;
 			auto Object = P.parse(ObjectString).template extract<Poco::JSON::Array::Ptr>();
@@ -450,7 +570,10 @@ namespace OpenWifi::RESTAPI_utils {
 		Types::TagList Result;
 		if (ObjectString.empty())
 			return Result;
+		if (JSONFlatArrayReader::Numbers(ObjectString, Result))
+			return Result;
 
+		Result.clear();
 		try {
 			Poco::JSON::Parser P;
 			auto Object = P.parse(ObjectString).template extract<Poco::JSON::Array::Ptr>();
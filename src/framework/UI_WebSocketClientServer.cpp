@@ -28,7 +28,7 @@ namespace OpenWifi {
 											 const std::string &UserName, std::uint64_t TID) {
 
 		std::lock_guard G(LocalMutex_);
-		auto Client = std::make_unique<UI_WebSocketClientInfo>(WS, Id, UserName);
+		auto Client = std::make_shared<UI_WebSocketClientInfo>(WS, Id, UserName);
 		auto ClientSocket = Client->WS_->impl()->sockfd();
 		TID_ = TID;
 		Client->WS_->setNoDelay(true);
@@ -57,10 +57,16 @@ namespace OpenWifi {
 
 	void UI_WebSocketClientServer::run() {
 		Running_ = true;
+		bool Pending = false;
 		while (Running_) {
-			if(!Poco::Thread::trySleep(2000)) {
-                break;
-            }
+			//	Woken up by every enqueue. When a slow client could not take everything, retry
+			//	soon, otherwise just come back for the periodic clean-up.
+			WriterEvent_.tryWait(Pending ? 50 : 2000);
+			if (!Running_)
+				break;
+
+			FlushAll(Pending);
+
 			std::lock_guard G(LocalMutex_);
 			for (const auto i : ToBeRemoved_) {
 				// std::cout << "Erasing old WS UI connection..." << std::endl;
@@ -71,6 +77,119 @@ namespace OpenWifi {
 		}
 	}
 
+	void UI_WebSocketClientServer::FlushAll(bool &Pending) {
+		//	Only grab references to the clients under the global lock: the actual socket writes
+		//	happen without it so that a slow client never blocks NewClient or the reactor.
+		std::vector<std::pair<int, std::shared_ptr<UI_WebSocketClientInfo>>> Ready;
+		{
+			std::lock_guard G(LocalMutex_);
+			Ready.reserve(Clients_.size());
+			for (const auto &[Socket, Client] : Clients_) {
+				if (Client->SocketRegistered_)
+					Ready.emplace_back(Socket, Client);
+			}
+		}
+
+		Pending = false;
+		std::vector<int> Failed;
+		for (const auto &[Socket, Client] : Ready) {
+			if (!FlushClient(*Client, Pending))
+				Failed.push_back(Socket);
+		}
+
+		if (!Failed.empty()) {
+			std::lock_guard G(LocalMutex_);
+			for (const auto Socket : Failed) {
+				auto Client = Clients_.find(Socket);
+				if (Client != end(Clients_))
+					EndConnection(Client);
+			}
+		}
+	}
+
+	bool UI_WebSocketClientServer::FlushClient(UI_WebSocketClientInfo &Client, bool &Pending) {
+		std::lock_guard S(Client.SendMutex_);
+		try {
+			while (true) {
+				UI_WebSocketPayload Msg;
+				{
+					std::lock_guard Q(Client.QueueMutex_);
+					if (Client.OutQueue_.empty()) {
+						Client.ConsecutiveDrops_ = 0;
+						return true;
+					}
+					//	Never block on a client whose socket buffer is full: leave its queue alone
+					//	and let Enqueue() coalesce it if it does not catch up.
+					if (!Client.WS_->poll(Poco::Timespan(0), Poco::Net::Socket::SELECT_WRITE)) {
+						Pending = true;
+						return true;
+					}
+					Msg = std::move(Client.OutQueue_.front());
+					Client.OutQueue_.pop_front();
+				}
+				if (Client.WS_->sendFrame(Msg->c_str(), (int)Msg->size()) != (int)Msg->size())
+					return false;
+				std::lock_guard Q(Client.QueueMutex_);
+				Client.Sent_++;
+			}
+		} catch (...) {
+		}
+		return false;
+	}
+
+	bool UI_WebSocketClientServer::Enqueue(UI_WebSocketClientInfo &Client,
+										   const UI_WebSocketPayload &Payload) {
+		std::lock_guard Q(Client.QueueMutex_);
+		if (Client.OutQueue_.size() >= MaxQueueDepth_) {
+			//	Coalesce: the oldest notification is the least interesting one for a UI.
+			Client.OutQueue_.pop_front();
+			Client.Dropped_++;
+			TotalDropped_++;
+			if (++Client.ConsecutiveDrops_ >= MaxConsecutiveDrops_) {
+				SlowConsumersClosed_++;
+				return false;
+			}
+		}
+		Client.OutQueue_.push_back(Payload);
+		TotalQueued_++;
+		if (Client.OutQueue_.size() > PeakQueueDepth_)
+			PeakQueueDepth_ = Client.OutQueue_.size();
+		return true;
+	}
+
+	void UI_WebSocketClientServer::SendFrame(UI_WebSocketClientInfo &Client,
+											 const std::string &Frame) {
+		std::lock_guard S(Client.SendMutex_);
+		Client.WS_->sendFrame(Frame.c_str(), (int)Frame.size());
+	}
+
+	void UI_WebSocketClientServer::GetQueueStats(Poco::JSON::Object &Obj) {
+		Poco::JSON::Array Clients;
+		std::uint64_t Queued = 0;
+		{
+			std::lock_guard G(LocalMutex_);
+			for (const auto &[Socket, Client] : Clients_) {
+				std::lock_guard Q(Client->QueueMutex_);
+				Poco::JSON::Object Entry;
+				Entry.set("id", Client->Id_);
+				Entry.set("userName", Client->UserName_);
+				Entry.set("queueDepth", (std::uint64_t)Client->OutQueue_.size());
+				Entry.set("sent", Client->Sent_);
+				Entry.set("dropped", Client->Dropped_);
+				Queued += Client->OutQueue_.size();
+				Clients.add(Entry);
+			}
+		}
+		Obj.set("maxQueueDepth", MaxQueueDepth_);
+		Obj.set("maxConsecutiveDrops", MaxConsecutiveDrops_);
+		Obj.set("queued", Queued);
+		Obj.set("peakQueueDepth", PeakQueueDepth_.load());
+		Obj.set("totalQueued", TotalQueued_.load());
+		Obj.set("totalDropped", TotalDropped_.load());
+		Obj.set("slowConsumersClosed", SlowConsumersClosed_.load());
+		Obj.set("clients", Clients);
+	}
+
 	void UI_WebSocketClientServer::EndConnection(ClientList::iterator Client) {
 		if (Client->second->SocketRegistered_) {
 			Client->second->SocketRegistered_ = false;
@@ -86,30 +205,36 @@ namespace OpenWifi {
 				*Client->second->WS_,
 				Poco::NObserver<UI_WebSocketClientServer, Poco::Net::ErrorNotification>(
 					*this, &UI_WebSocketClientServer::OnSocketError));
+			ToBeRemoved_.push_back(Client);
 		}
-		ToBeRemoved_.push_back(Client);
 	}
 
 	int UI_WebSocketClientServer::Start() {
 		poco_information(Logger(), "Starting...");
 		GoogleApiKey_ = MicroServiceConfigGetString("google.apikey", "");
 		GeoCodeEnabled_ = !GoogleApiKey_.empty();
+		MaxQueueDepth_ = std::max<std::uint64_t>(
+			1, MicroServiceConfigGetInt("websocketclients.queue.maxdepth", 256));
+		MaxConsecutiveDrops_ = std::max<std::uint64_t>(
+			1, MicroServiceConfigGetInt("websocketclients.queue.maxdrops", 1024));
 		ReactorThread_.start(Reactor_);
 		ReactorThread_.setName("ws:ui-reactor");
 		CleanerThread_.start(*this);
-		CleanerThread_.setName("ws:ui-cleaner");
+		CleanerThread_.setName("ws:ui-writer");
 		return 0;
 	};
 
 	void UI_WebSocketClientServer::Stop() {
 		if (Running_) {
 			poco_information(Logger(), "Stopping...");
-			Clients_.clear();
 			Reactor_.stop();
 			ReactorThread_.join();
 			Running_ = false;
-			CleanerThread_.wakeUp();
+			WriterEvent_.set();
 			CleanerThread_.join();
+			std::lock_guard G(LocalMutex_);
+			ToBeRemoved_.clear();
+			Clients_.clear();
 			poco_information(Logger(), "Stopped...");
 		}
 	};
@@ -121,35 +246,37 @@ namespace OpenWifi {
 
 	bool UI_WebSocketClientServer::SendToUser(const std::string &UserName, std::uint64_t id,
 											  const std::string &Payload) {
-		std::lock_guard G(LocalMutex_);
-
-		for (const auto &Client : Clients_) {
-			if (Client.second->UserName_ == UserName) {
-				try {
-					if (!IsFiltered(id, *Client.second) && Client.second->Authenticated_) {
-						return Client.second->WS_->sendFrame(
-								   Payload.c_str(), (int)Payload.size()) == (int)Payload.size();
-					} else {
-						return false;
-					}
-				} catch (...) {
-					return false;
-				}
+		auto Msg = std::make_shared<const std::string>(Payload);
+		bool Queued = false;
+		{
+			std::lock_guard G(LocalMutex_);
+			for (auto Client = Clients_.begin(); Client != Clients_.end(); ++Client) {
+				if (Client->second->UserName_ != UserName || !Client->second->Authenticated_ ||
+					IsFiltered(id, *Client->second))
+					continue;
+				if (Enqueue(*Client->second, Msg))
+					Queued = true;
+				else
+					EndConnection(Client);
 			}
 		}
-		return false;
+		if (Queued)
+			WriterEvent_.set();
+		return Queued;
 	}
 
 	void UI_WebSocketClientServer::SendToAll(std::uint64_t id, const std::string &Payload) {
-		std::lock_guard G(LocalMutex_);
-
-		for (const auto &Client : Clients_) {
-			try {
-				if (!IsFiltered(id, *Client.second) && Client.second->Authenticated_)
-					Client.second->WS_->sendFrame(Payload.c_str(), (int)Payload.size());
-			} catch (...) {
+		auto Msg = std::make_shared<const std::string>(Payload);
+		{
+			std::lock_guard G(LocalMutex_);
+			for (auto Client = Clients_.begin(); Client != Clients_.end(); ++Client) {
+				if (!Client->second->Authenticated_ || IsFiltered(id, *Client->second))
+					continue;
+				if (!Enqueue(*Client->second, Msg))
+					EndConnection(Client);
 			}
 		}
+		WriterEvent_.set();
 	}
 
 	UI_WebSocketClientServer::ClientList::iterator UI_WebSocketClientServer::FindWSClient(
@@ -219,6 +346,7 @@ namespace OpenWifi {
 
 			switch (Op) {
 			case Poco::Net::WebSocket::FRAME_OP_PING: {
+				std::lock_guard S(Client->second->SendMutex_);
 				Client->second->WS_->sendFrame("", 0,
 											   (int)Poco::Net::WebSocket::FRAME_OP_PONG |
 												   (int)Poco::Net::WebSocket::FRAME_FLAG_FIN);
@@ -258,14 +386,14 @@ namespace OpenWifi {
 						WelcomeMessage.set("success", "Welcome! Bienvenue! Bienvenidos!");
 						std::ostringstream OS;
 						WelcomeMessage.stringify(OS);
-						Client->second->WS_->sendFrame(OS.str().c_str(), (int)OS.str().size());
+						SendFrame(*Client->second, OS.str());
 						Client->second->UserName_ = Client->second->UserInfo_.userinfo.email;
 					} else {
 						Poco::JSON::Object WelcomeMessage;
 						WelcomeMessage.set("error", "Invalid token. Closing connection.");
 						std::ostringstream OS;
 						WelcomeMessage.stringify(OS);
-						Client->second->WS_->sendFrame(OS.str().c_str(), (int)OS.str().size());
+						SendFrame(*Client->second, OS.str());
 						return EndConnection(Client);
 					}
 				} else {
@@ -289,9 +417,9 @@ namespace OpenWifi {
 											  Client->second->UserInfo_.userinfo);
 					}
 					if (!Answer.empty())
-						Client->second->WS_->sendFrame(Answer.c_str(), (int)Answer.size());
+						SendFrame(*Client->second, Answer);
 					else {
-						Client->second->WS_->sendFrame("{}", 2);
+						SendFrame(*Client->second, "{}");
 					}
 
 					if (CloseConnection) {
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
 
+#include "Poco/Event.h"
 #include "Poco/JSON/Object.h"
 #include "Poco/Net/SocketNotification.h"
 #include "Poco/Net/SocketReactor.h"
@@ -27,6 +30,9 @@ namespace OpenWifi {
 	  private:
 	};
 
+	//	A serialized notification, shared by all the client queues it has been fanned out to.
+	using UI_WebSocketPayload = std::shared_ptr<const std::string>;
+
 	struct UI_WebSocketClientInfo {
 		std::unique_ptr<Poco::Net::WebSocket> WS_ = nullptr;
 		std::string Id_;
@@ -36,6 +42,15 @@ namespace OpenWifi {
 		std::vector<std::uint64_t> Filter_;
 		SecurityObjects::UserInfoAndPolicy UserInfo_;
 
+		//	Serializes frames written by the reactor (replies) and by the writer (notifications).
+		std::mutex SendMutex_;
+		//	Protects the outbound queue and its counters.
+		std::mutex QueueMutex_;
+		std::deque<UI_WebSocketPayload> OutQueue_;
+		std::uint64_t Sent_ = 0;
+		std::uint64_t Dropped_ = 0;
+		std::uint64_t ConsecutiveDrops_ = 0;
+
 		UI_WebSocketClientInfo(Poco::Net::WebSocket &WS, const std::string &Id,
 							   const std::string &username) {
 			WS_ = std::make_unique<Poco::Net::WebSocket>(WS);
@@ -91,13 +106,14 @@ namespace OpenWifi {
 		[[nodiscard]] bool SendToUser(const std::string &userName, std::uint64_t id,
 									  const std::string &Payload);
 		void SendToAll(std::uint64_t id, const std::string &Payload);
+		void GetQueueStats(Poco::JSON::Object &Obj);
 
 		struct NotificationEntry {
 			std::uint64_t id = 0;
 			std::string helper;
 		};
 
-		using ClientList = std::map<int, std::unique_ptr<UI_WebSocketClientInfo>>;
+		using ClientList = std::map<int, std::shared_ptr<UI_WebSocketClientInfo>>;
 		using NotificationTypeIdVec = std::vector<NotificationEntry>;
 
 		void RegisterNotifications(const NotificationTypeIdVec &Notifications);
@@ -118,9 +134,20 @@ namespace OpenWifi {
 		Poco::JSON::Object NotificationTypesJSON_;
 		std::vector<ClientList::iterator> ToBeRemoved_;
 		std::uint64_t TID_ = 0;
+		Poco::Event WriterEvent_{Poco::Event::EVENT_AUTORESET};
+		std::uint64_t MaxQueueDepth_ = 256;
+		std::uint64_t MaxConsecutiveDrops_ = 1024;
+		std::atomic_uint64_t TotalQueued_ = 0;
+		std::atomic_uint64_t TotalDropped_ = 0;
+		std::atomic_uint64_t SlowConsumersClosed_ = 0;
+		std::atomic_uint64_t PeakQueueDepth_ = 0;
 
 		UI_WebSocketClientServer() noexcept;
 		void EndConnection(ClientList::iterator Client);
+		bool Enqueue(UI_WebSocketClientInfo &Client, const UI_WebSocketPayload &Payload);
+		bool FlushClient(UI_WebSocketClientInfo &Client, bool &Pending);
+		void FlushAll(bool &Pending);
+		void SendFrame(UI_WebSocketClientInfo &Client, const std::string &Frame);
 
 		void OnSocketReadable(const Poco::AutoPtr<Poco::Net::ReadableNotification> &pNf);
 		void OnSocketShutdown(const Poco::AutoPtr<Poco::Net::ShutdownNotification> &pNf);
@@ -8,12 +8,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "Poco/Data/RecordSet.h"
@@ -24,6 +30,8 @@
 #include "Poco/StringTokenizer.h"
 #include "Poco/Tuple.h"
 #include "StorageClass.h"
+#include "orm_events.h"
+#include "orm_stats.h"
 
 #include "fmt/format.h"
 
@@ -203,6 +211,50 @@ namespace ORM {
 		uint64_t Timeout_ = 0;
 	};
 
+	struct NameAndDescription {
+		std::string Name;
+		std::string Description;
+	};
+	//	Indexed by record id.
+	typedef std::map<std::string, NameAndDescription> NameAndDescriptionMap;
+
+	//	Builds 'a','b','c' for an "in (...)" clause.
+	template <typename Iterator> std::string InList(Iterator First, Iterator Last) {
+		std::string R;
+		for (; First != Last; ++First)
+			R += (R.empty() ? "'" : ",'") + Escape(*First) + "'";
+		return R;
+	}
+
+	//	Storage for parent/child lists (children, devices, inUse...) as one row per member
+	//	instead of a serialized vector in the parent row. Kind tells the lists apart.
+	class MembershipStore {
+	  public:
+		//	Members are indexed by MemberKey(Kind, Parent).
+		typedef std::map<std::string, std::vector<std::string>> MemberMap;
+
+		static inline std::string MemberKey(const std::string &Kind, const std::string &Parent) {
+			return Kind + ":" + Parent;
+		}
+
+		virtual ~MembershipStore() = default;
+		//	Both return the number of rows actually inserted or removed.
+		virtual std::size_t AddMembers(const std::string &Kind, const std::string &Parent,
+									   const std::vector<std::string> &Children) = 0;
+		//	Run in the caller's transaction, so the member rows and the parent row are written
+		//	together. Errors are thrown, for the caller to roll back.
+		virtual std::size_t AddMembers(Poco::Data::Session &Session, const std::string &Kind,
+									   const std::string &Parent,
+									   const std::vector<std::string> &Children) = 0;
+		virtual void RemoveParents(Poco::Data::Session &Session, const std::string &Kind,
+								   const std::vector<std::string> &Parents) = 0;
+		virtual std::size_t RemoveMembers(const std::string &Kind, const std::string &Parent,
+										  const std::vector<std::string> &Children) = 0;
+		virtual bool RemoveParent(const std::string &Kind, const std::string &Parent) = 0;
+		virtual bool GetMembers(const std::vector<std::string> &Kinds,
+								const std::vector<std::string> &Parents, MemberMap &Members) = 0;
+	};
+
 	template <typename RecordTuple, typename RecordType> class DB {
 	  public:
 		typedef const char *field_name_t;
@@ -211,7 +263,7 @@ namespace ORM {
 		   const IndexVec &Indexes, Poco::Data::SessionPool &Pool, Poco::Logger &L,
 		   const char *Prefix, DBCache<RecordType> *Cache = nullptr)
 			: TableName_(TableName), Type_(dbtype), Pool_(Pool), Logger_(L), Prefix_(Prefix),
-			  Cache_(Cache) {
+			  Cache_(Cache), Stats_(QueryStats()->Register(TableName_)) {
 			assert(RecordTuple::length == Fields.size());
 
 			bool first = true;
@@ -231,6 +283,8 @@ namespace ORM {
 
 				CreateFields_ += FieldName + " " + FieldTypeToChar(Type_, i.Type, i.Size) +
 								 (i.Index ? " unique primary key" : "");
+				if (i.Index && KeyField_.empty())
+					KeyField_ = FieldName;
 				SelectFields_ += FieldName;
 				UpdateFields_ += FieldName + "=?";
 				SelectList_ += "?";
@@ -416,21 +470,26 @@ namespace ORM {
 		void Convert(const RecordType &in, RecordTuple &out);
 
 		inline const std::string &Prefix() { return Prefix_; };
+		inline const std::string &TableName() const { return TableName_; }
 
 		bool CreateRecord(const RecordType &R) {
 			try {
 				Poco::Data::Session Session = Pool_.get();
+				Session.begin();
 				Poco::Data::Statement Insert(Session);
 
 				RecordTuple RT;
-				Convert(R, RT);
+				ConvertForWrite(R, RT);
 				std::string St = "insert into  " + TableName_ + " ( " + SelectFields_ +
 								 " ) values " + SelectList_;
 				Insert << ConvertParams(St), Poco::Data::Keywords::use(RT);
-				Insert.execute();
+				Execute(Insert, Operation::Insert, St);
+				StoreMembers(Session, R);
+				Session.commit();
 
 				if (Cache_)
 					Cache_->Create(R);
+				Changed(ChangeKey(R), ChangeVersion(R), Operation::Insert);
 				return true;
 
 			} catch (const Poco::Exception &E) {
@@ -439,15 +498,64 @@ namespace ORM {
 			return false;
 		}
 
-		template <typename T>
-		bool GetRecord(field_name_t FieldName, const T &Value, RecordType &R) {
+		//	Inserts all the records in a single transaction: either they all make it or none do.
+		bool CreateRecords(const std::vector<RecordType> &Records) {
+			if (Records.empty())
+				return true;
 			try {
-				assert(ValidFieldName(FieldName));
+				Poco::Data::Session Session = Pool_.get();
+				std::vector<RecordTuple> RL(Records.size());
+				for (std::size_t i = 0; i < Records.size(); ++i)
+					ConvertForWrite(Records[i], RL[i]);
+
+				std::string St = "insert into  " + TableName_ + " ( " + SelectFields_ +
+								 " ) values " + SelectList_;
+				Session.begin();
+				try {
+					Poco::Data::Statement Insert(Session);
+					Insert << ConvertParams(St), Poco::Data::Keywords::use(RL);
+					Execute(Insert, Operation::Insert, St);
+					for (const auto &R : Records)
+						StoreMembers(Session, R);
+					Session.commit();
+				} catch (...) {
+					Session.rollback();
+					throw;
+				}
 
 				if (Cache_) {
-					if (Cache_->GetFromCache(FieldName, Value, R))
-						return true;
+					for (const auto &R : Records)
+						Cache_->Create(R);
 				}
+				for (const auto &R : Records)
+					Changed(ChangeKey(R), ChangeVersion(R), Operation::Insert);
+				return true;
+			} catch (const Poco::Exception &E) {
+				Logger_.log(E);
+			}
+			return false;
+		}
+
+		template <typename T>
+		bool GetRecord(field_name_t FieldName, const T &Value, RecordType &R) {
+			if (Cache_) {
+				if (Cache_->GetFromCache(FieldName, Value, R))
+					return true;
+			}
+			if (FetchRecord(FieldName, Value, R)) {
+				LoadMembers(R);
+				if (Cache_)
+					Cache_->UpdateCache(R);
+				return true;
+			}
+			return false;
+		}
+
+		//	Same as GetRecord, without the normalized member lists and the cache.
+		template <typename T>
+		bool FetchRecord(field_name_t FieldName, const T &Value, RecordType &R) {
+			try {
+				assert(ValidFieldName(FieldName));
 
 				Poco::Data::Session Session = Pool_.get();
 				Poco::Data::Statement Select(Session);
@@ -460,12 +568,8 @@ namespace ORM {
 
 				Select << ConvertParams(St), Poco::Data::Keywords::into(RT),
 					Poco::Data::Keywords::use(tValue);
-				Select.execute();
-
-				if (Select.execute() == 1) {
+				if (Execute(Select, Operation::Select, St) == 1) {
 					Convert(RT, R);
-					if (Cache_)
-						Cache_->UpdateCache(R);
 					return true;
 				}
 			} catch (const Poco::Exception &E) {
@@ -484,10 +588,9 @@ namespace ORM {
 								 WhereClause + " limit 1";
 
 				Select << ConvertParams(St), Poco::Data::Keywords::into(RT);
-				Select.execute();
-
-				if (Select.execute() == 1) {
+				if (Execute(Select, Operation::Select, St) == 1) {
 					Convert(RT, T);
+					LoadMembers(T);
 					if (Cache_)
 						Cache_->UpdateCache(T);
 					return true;
@@ -515,8 +618,9 @@ namespace ORM {
 				Select << ConvertParams(St), Poco::Data::Keywords::into(RT),
 					Poco::Data::Keywords::use(V0), Poco::Data::Keywords::use(V1);
 
-				if (Select.execute() == 1) {
+				if (Execute(Select, Operation::Select, St) == 1) {
 					Convert(RT, R);
+					LoadMembers(R);
 					return true;
 				}
 				return true;
@@ -532,7 +636,7 @@ namespace ORM {
 				Poco::Data::Statement Select(Session);
 
 				Select << statement, Poco::Data::Keywords::into(records);
-				Select.execute();
+				Execute(Select, Operation::Select, statement);
 				return true;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
@@ -546,6 +650,45 @@ namespace ORM {
 
 		bool GetRecords(uint64_t Offset, uint64_t HowMany, RecordVec &Records,
 						const std::string &Where = "", const std::string &OrderBy = "") {
+			auto First = Records.size();
+			if (!FetchRecords(Offset, HowMany, Records, Where, OrderBy))
+				return false;
+			LoadMembers(Records, First);
+			return true;
+		}
+
+		//	Reads only the listed columns straight into Rows, skipping Convert and the JSON
+		//	decoding it does on every column. ProjectedTuple must match Fields one for one.
+		//	HowMany=0 means no limit.
+		template <typename ProjectedTuple>
+		bool GetColumns(const std::vector<std::string> &Fields, std::vector<ProjectedTuple> &Rows,
+						const std::string &Where = "", const std::string &OrderBy = "",
+						uint64_t Offset = 0, uint64_t HowMany = 0) {
+			try {
+				assert(ProjectedTuple::length == Fields.size());
+				std::string Columns;
+				for (const auto &Field : Fields) {
+					assert(ValidFieldName(Field));
+					Columns += (Columns.empty() ? "" : ", ") + Poco::toLower(Field);
+				}
+
+				Poco::Data::Session Session = Pool_.get();
+				Poco::Data::Statement Select(Session);
+				std::string St = "select " + Columns + " from " + TableName_ +
+								 (Where.empty() ? "" : " where " + Where) + OrderBy +
+								 (HowMany ? ComputeRange(Offset, HowMany) : "");
+				Select << St, Poco::Data::Keywords::into(Rows);
+				Execute(Select, Operation::Select, St);
+				return true;
+			} catch (const Poco::Exception &E) {
+				Logger_.log(E);
+			}
+			return false;
+		}
+
+		//	Same as GetRecords, without the normalized member lists.
+		bool FetchRecords(uint64_t Offset, uint64_t HowMany, RecordVec &Records,
+						  const std::string &Where = "", const std::string &OrderBy = "") {
 			try {
 				Poco::Data::Session Session = Pool_.get();
 				Poco::Data::Statement Select(Session);
@@ -555,7 +698,7 @@ namespace ORM {
 								 ComputeRange(Offset, HowMany);
 
 				Select << St, Poco::Data::Keywords::into(RL);
-				Select.execute();
+				Execute(Select, Operation::Select, St);
 
 				if (Select.rowsExtracted() > 0) {
 					for (auto &i : RL) {
@@ -582,7 +725,9 @@ namespace ORM {
 
 				RecordTuple RT;
 
-				Convert(R, RT);
+				//	Normalized member lists are not written here: they only change through
+				//	ManipulateVectorMember(s), so a stale copy of the record cannot undo them.
+				ConvertForWrite(R, RT);
 
 				auto tValue(Value);
 
@@ -590,10 +735,16 @@ namespace ORM {
 					"update " + TableName_ + " set " + UpdateFields_ + " where " + FieldName + "=?";
 				Update << ConvertParams(St), Poco::Data::Keywords::use(RT),
 					Poco::Data::Keywords::use(tValue);
-				Update.execute();
+				Execute(Update, Operation::Update, St);
 				if (Cache_)
 					Cache_->UpdateCache(R);
                 Session.commit();
+				auto Key = ChangeKey(R);
+				if constexpr (std::is_convertible_v<T, std::string>) {
+					if (Key.empty() && FieldName == KeyField_)
+						Key = Value;
+				}
+				Changed(Key, ChangeVersion(R), Operation::Update);
 				return true;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
@@ -607,7 +758,8 @@ namespace ORM {
 				Poco::Data::Statement Command(Session);
 
 				Command << St;
-				Command.execute();
+				Execute(Command, Operation::Other, St);
+				Changed("", 0, Operation::Other);
 
 				return true;
 			} catch (const Poco::Exception &E) {
@@ -636,28 +788,49 @@ namespace ORM {
 				assert(ValidFieldName(FieldName));
 				Poco::Data::Session Session = Pool_.get();
 				Poco::Data::Statement Select(Session);
-				RecordTuple RT;
 
-				std::string St = "select " + SelectFields_ + " from " + TableName_ + " where " +
+				std::string St = "select name, description from " + TableName_ + " where " +
 								 FieldName + "=?";
-				RecordType R;
 				auto tValue{Value};
-				Select << ConvertParams(St), Poco::Data::Keywords::into(RT),
-					Poco::Data::Keywords::use(tValue);
-
-				if (Select.execute() == 1) {
-					Convert(RT, R);
-					Name = R.info.name;
-					Description = R.info.description;
-					return true;
-				}
-				return false;
+				Select << ConvertParams(St), Poco::Data::Keywords::into(Name),
+					Poco::Data::Keywords::into(Description), Poco::Data::Keywords::use(tValue);
+				return Execute(Select, Operation::Select, St) == 1;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
 			}
 			return false;
 		}
 
+		//	Batched versions of GetNameAndDescription and Exists for a list of ids: one query per
+		//	LookupBatchSize ids, reading only the columns needed. Missing ids are not in the result.
+		bool GetNamesAndDescriptions(const std::vector<std::string> &Ids,
+									 NameAndDescriptionMap &Result) {
+			for (std::size_t From = 0; From < Ids.size(); From += LookupBatchSize) {
+				auto To = std::min(Ids.size(), From + LookupBatchSize);
+				std::vector<Poco::Tuple<std::string, std::string, std::string>> Rows;
+				if (!GetColumns({"id", "name", "description"}, Rows,
+								"id in (" + InList(Ids.begin() + From, Ids.begin() + To) + ")"))
+					return false;
+				for (auto &Row : Rows)
+					Result[Row.template get<0>()] =
+						NameAndDescription{Row.template get<1>(), Row.template get<2>()};
+			}
+			return true;
+		}
+
+		bool GetExistingIds(const std::vector<std::string> &Ids, std::set<std::string> &Found) {
+			for (std::size_t From = 0; From < Ids.size(); From += LookupBatchSize) {
+				auto To = std::min(Ids.size(), From + LookupBatchSize);
+				std::vector<Poco::Tuple<std::string>> Rows;
+				if (!GetColumns({"id"}, Rows,
+								"id in (" + InList(Ids.begin() + From, Ids.begin() + To) + ")"))
+					return false;
+				for (auto &Row : Rows)
+					Found.insert(Row.template get<0>());
+			}
+			return true;
+		}
+
 		template <typename T> bool DeleteRecord(field_name_t FieldName, const T &Value) {
 			try {
 				assert(ValidFieldName(FieldName));
@@ -666,14 +839,33 @@ namespace ORM {
                 Session.begin();
 				Poco::Data::Statement Delete(Session);
 
+				//	The ids of the deleted rows, when the table has them.
+				std::vector<std::string> Ids;
+				if constexpr (std::is_convertible_v<T, std::string>) {
+					if (std::string{FieldName} == "id")
+						Ids.emplace_back(Value);
+					else if (Members_ != nullptr || HasInfo<RecordType>::value)
+						RowIds(Session, std::string{FieldName} + "='" + Escape(Value) + "'",
+							   Ids);
+				}
+
 				std::string St = "delete from " + TableName_ + " where " + FieldName + "=?";
 				auto tValue{Value};
 
 				Delete << ConvertParams(St), Poco::Data::Keywords::use(tValue);
-				Delete.execute();
+				Execute(Delete, Operation::Delete, St);
+				RemoveMembersOf(Session, Ids);
 				if (Cache_)
 					Cache_->Delete(FieldName, Value);
                 Session.commit();
+				if (!Ids.empty())
+					return ChangedRows(Ids, Operation::Delete);
+				std::string Key;
+				if constexpr (std::is_convertible_v<T, std::string>) {
+					if (FieldName == KeyField_)
+						Key = Value;
+				}
+				Changed(Key, 0, Operation::Delete);
 				return true;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
@@ -688,10 +880,19 @@ namespace ORM {
                 Session.begin();
 				Poco::Data::Statement Delete(Session);
 
+				std::vector<std::string> Ids;
+				bool KnownIds = Members_ != nullptr || HasInfo<RecordType>::value;
+				if (KnownIds)
+					RowIds(Session, WhereClause, Ids);
+
 				std::string St = "delete from " + TableName_ + " where " + WhereClause;
 				Delete << St;
-				Delete.execute();
+				Execute(Delete, Operation::Delete, St);
+				RemoveMembersOf(Session, Ids);
                 Session.commit();
+				if (KnownIds)
+					return ChangedRows(Ids, Operation::Delete);
+				Changed("", 0, Operation::Delete);
 				return true;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
@@ -703,10 +904,16 @@ namespace ORM {
 			try {
 				assert(ValidFieldName(FieldName));
 
-				RecordType R;
-				if (GetRecord(FieldName, Value, R))
-					return true;
-				return false;
+				Poco::Data::Session Session = Pool_.get();
+				Poco::Data::Statement Select(Session);
+				std::string St =
+					"select count(*) from " + TableName_ + " where " + FieldName + "=?";
+				uint64_t Count = 0;
+				auto tValue{Value};
+				Select << ConvertParams(St), Poco::Data::Keywords::into(Count),
+					Poco::Data::Keywords::use(tValue);
+				Execute(Select, Operation::Count, St);
+				return Count > 0;
 			} catch (const Poco::Exception &E) {
 				Logger_.log(E);
 			}
@@ -779,7 +986,7 @@ namespace ORM {
 							   (Where.empty() ? "" : (" where " + Where))};
 
 				Select << st, Poco::Data::Keywords::into(Cnt);
-				Select.execute();
+				Execute(Select, Operation::Count, st);
 
 				return Cnt;
 
@@ -792,6 +999,8 @@ namespace ORM {
 		template <typename X>
 		bool ManipulateVectorMember(X T, field_name_t FieldName, const std::string &ParentUUID,
 									const std::string &ChildUUID, bool Add) {
+			if (auto F = FindNormalizedField(T); F != nullptr)
+				return ManipulateMembers(*F, FieldName, ParentUUID, {ChildUUID}, Add);
 			try {
 				assert(ValidFieldName(FieldName));
 
@@ -818,6 +1027,98 @@ namespace ORM {
 			return false;
 		}
 
+		//	Same as ManipulateVectorMember for a whole list of children: a single read and a single
+		//	update of the parent, whatever the number of children.
+		template <typename X>
+		bool ManipulateVectorMembers(X T, field_name_t FieldName, const std::string &ParentUUID,
+									 const std::vector<std::string> &ChildUUIDs, bool Add) {
+			if (auto F = FindNormalizedField(T); F != nullptr)
+				return ManipulateMembers(*F, FieldName, ParentUUID, ChildUUIDs, Add);
+			try {
+				assert(ValidFieldName(FieldName));
+
+				RecordType R;
+				if (GetRecord(FieldName, ParentUUID, R)) {
+					auto &Members = R.*T;
+					auto Before = Members.size();
+					if (Add) {
+						Members.insert(Members.end(), ChildUUIDs.begin(), ChildUUIDs.end());
+						std::sort(Members.begin(), Members.end());
+						Members.erase(std::unique(Members.begin(), Members.end()), Members.end());
+					} else {
+						std::vector<std::string> Removed{ChildUUIDs};
+						std::sort(Removed.begin(), Removed.end());
+						Members.erase(std::remove_if(Members.begin(), Members.end(),
+													 [&](const std::string &M) {
+														 return std::binary_search(
+															 Removed.begin(), Removed.end(), M);
+													 }),
+									  Members.end());
+					}
+					if (Members.size() == Before)
+						return false;
+					UpdateRecord(FieldName, ParentUUID, R);
+					return true;
+				}
+			} catch (const Poco::Exception &E) {
+				Logger_.log(E);
+			}
+			return false;
+		}
+
+		//	Moves the list member T (children, devices, inUse...) out of the parent row into
+		//	Store, one row per child. Records read through this DB still get T filled, so
+		//	to_json and the callers see no difference.
+		template <typename X>
+		void NormalizeMembers(MembershipStore *Store, X T, const std::string &Name) {
+			Members_ = Store;
+			IdOf_ = [](const RecordType &R) -> const std::string & { return R.info.id; };
+			NormalizedFields_.emplace_back(NormalizedField{
+				Prefix_ + "." + Name, Name, MemberOffset(T),
+				[T](RecordType &R) -> std::vector<std::string> & { return R.*T; }});
+		}
+
+		//	Copies the lists still serialized in the parent rows into the membership store and
+		//	clears them. Rows written by an older version get picked up on the next start. Only
+		//	the ids of rows with a list left are read, so once migrated a start costs one query.
+		//	They are all read first: paging through rows while rewriting them can skip some.
+		bool MigrateMembers() {
+			if (Members_ == nullptr || NormalizedFields_.empty())
+				return true;
+			std::string Where;
+			for (const auto &F : NormalizedFields_) {
+				if (!Where.empty())
+					Where += " or ";
+				auto Column = Poco::toLower(F.Column);
+				Where += "(" + Column + "<>'' and " + Column + "<>'[]')";
+			}
+			std::vector<Poco::Tuple<std::string>> Ids;
+			if (!GetColumns({"id"}, Ids, Where))
+				return false;
+			uint64_t Migrated = 0, Failed = 0;
+			for (const auto &Id : Ids) {
+				RecordType R;
+				if (!FetchRecord("id", Id.template get<0>(), R))
+					continue;
+				bool HasMembers = false;
+				for (auto &F : NormalizedFields_)
+					HasMembers |= !F.Field(R).empty();
+				if (!HasMembers)
+					continue;
+				if (MoveMembers(R))
+					Migrated++;
+				else
+					Failed++;
+			}
+			if (Migrated)
+				Logger_.information(fmt::format("{}: migrated member lists of {} records.",
+												TableName_, Migrated));
+			if (Failed)
+				Logger_.error(fmt::format("{}: could not migrate member lists of {} records.",
+										  TableName_, Failed));
+			return Failed == 0;
+		}
+
 		bool RunScript(const std::vector<std::string> &Statements, bool IgnoreExceptions = true) {
 			try {
 				Poco::Data::Session Session = Pool_.get();
@@ -905,6 +1206,12 @@ namespace ORM {
 										  true);
 		}
 
+		inline bool AddDevices(field_name_t FieldName, const std::string &ParentUUID,
+							   const std::vector<std::string> &ChildUUIDs) {
+			return ManipulateVectorMembers(&RecordType::devices, FieldName, ParentUUID, ChildUUIDs,
+										   true);
+		}
+
 		inline bool DeleteDevice(field_name_t FieldName, const std::string &ParentUUID,
 								 const std::string &ChildUUID) {
 			return ManipulateVectorMember(&RecordType::devices, FieldName, ParentUUID, ChildUUID,
@@ -1024,14 +1331,196 @@ namespace ORM {
 		}
 
 	  protected:
+		//	Every write ends up here, for the replicas that keep copies of the rows.
+		inline void Changed(const std::string &Key, uint64_t Version, Operation Op) {
+			ChangeFeed()->Publish(TableName_, Key, Version, Op);
+		}
+
+		//	One change per row, or the whole table when there are too many rows to list.
+		inline bool ChangedRows(const std::vector<std::string> &Ids, Operation Op) {
+			if (Ids.size() > MaxChangedRows) {
+				Changed("", 0, Op);
+				return true;
+			}
+			for (const auto &Id : Ids)
+				Changed(Id, 0, Op);
+			return true;
+		}
+
+		//	Runs a statement and records its latency and row count in the ORM query statistics.
+		std::size_t Execute(Poco::Data::Statement &S, Operation Op, const std::string &St) {
+			auto Start = std::chrono::steady_clock::now();
+			auto Elapsed = [Start]() -> uint64_t {
+				return std::chrono::duration_cast<std::chrono::microseconds>(
+						   std::chrono::steady_clock::now() - Start)
+					.count();
+			};
+			try {
+				auto Rows = S.execute();
+				QueryStats()->Record(*Stats_, Op, St, Elapsed(), Rows, false);
+				return Rows;
+			} catch (...) {
+				QueryStats()->Record(*Stats_, Op, St, Elapsed(), 0, true);
+				throw;
+			}
+		}
+
 		std::string TableName_;
 		OpenWifi::DBType Type_;
 		Poco::Data::SessionPool &Pool_;
 		Poco::Logger &Logger_;
 		std::string Prefix_;
+		//	The primary key, which identifies a row in change notifications.
+		std::string KeyField_;
 		DBCache<RecordType> *Cache_ = nullptr;
+		QueryStats::Table *Stats_ = nullptr;
 
 	  private:
+		static constexpr std::size_t LookupBatchSize = 200;
+		static constexpr std::size_t MaxChangedRows = 1000;
+
+		struct NormalizedField {
+			std::string Kind;
+			std::string Column;
+			std::ptrdiff_t Offset;
+			std::function<std::vector<std::string> &(RecordType &)> Field;
+		};
+
+		MembershipStore *Members_ = nullptr;
+		std::vector<NormalizedField> NormalizedFields_;
+		std::function<const std::string &(const RecordType &)> IdOf_;
+
+		template <typename X> static std::ptrdiff_t MemberOffset(X T) {
+			static const RecordType Probe{};
+			return reinterpret_cast<const char *>(&(Probe.*T)) -
+				   reinterpret_cast<const char *>(&Probe);
+		}
+
+		template <typename X> const NormalizedField *FindNormalizedField(X T) const {
+			if (NormalizedFields_.empty())
+				return nullptr;
+			auto Offset = MemberOffset(T);
+			for (const auto &F : NormalizedFields_)
+				if (F.Offset == Offset)
+					return &F;
+			return nullptr;
+		}
+
+		inline void ConvertForWrite(const RecordType &R, RecordTuple &RT) {
+			if (NormalizedFields_.empty())
+				return Convert(R, RT);
+			RecordType Stripped{R};
+			for (auto &F : NormalizedFields_)
+				F.Field(Stripped).clear();
+			Convert(Stripped, RT);
+		}
+
+		inline void StoreMembers(Poco::Data::Session &Session, const RecordType &R) {
+			if (Members_ == nullptr)
+				return;
+			for (auto &F : NormalizedFields_) {
+				const auto &List = F.Field(const_cast<RecordType &>(R));
+				if (!List.empty())
+					Members_->AddMembers(Session, F.Kind, IdOf_(R), List);
+			}
+		}
+
+		void RowIds(Poco::Data::Session &Session, const std::string &Where,
+					std::vector<std::string> &Ids) {
+			Poco::Data::Statement Select(Session);
+			std::string St = "select id from " + TableName_ + " where " + Where;
+			Select << St, Poco::Data::Keywords::into(Ids);
+			Execute(Select, Operation::Select, St);
+		}
+
+		void RemoveMembersOf(Poco::Data::Session &Session, const std::vector<std::string> &Parents) {
+			if (Members_ == nullptr || Parents.empty())
+				return;
+			for (const auto &F : NormalizedFields_)
+				Members_->RemoveParents(Session, F.Kind, Parents);
+		}
+
+		//	Writes the members of R to the store and the stripped row in one transaction.
+		bool MoveMembers(const RecordType &R) {
+			try {
+				Poco::Data::Session Session = Pool_.get();
+				Session.begin();
+				StoreMembers(Session, R);
+
+				RecordTuple RT;
+				ConvertForWrite(R, RT);
+				auto Id = IdOf_(R);
+				Poco::Data::Statement Update(Session);
+				std::string St = "update " + TableName_ + " set " + UpdateFields_ + " where id=?";
+				Update << ConvertParams(St), Poco::Data::Keywords::use(RT),
+					Poco::Data::Keywords::use(Id);
+				Execute(Update, Operation::Update, St);
+				Session.commit();
+				if (Cache_)
+					Cache_->Delete("id", Id);
+				return true;
+			} catch (const Poco::Exception &E) {
+				Logger_.log(E);
+			}
+			return false;
+		}
+
+		inline void LoadMembers(RecordType &R) {
+			if (Members_ == nullptr)
+				return;
+			RecordVec Records{std::move(R)};
+			LoadMembers(Records, 0);
+			R = std::move(Records.front());
+		}
+
+		//	One query for all the lists of all the records from First on.
+		void LoadMembers(RecordVec &Records, std::size_t First) {
+			if (Members_ == nullptr || First >= Records.size())
+				return;
+			std::vector<std::string> Kinds, Parents;
+			for (const auto &F : NormalizedFields_)
+				Kinds.push_back(F.Kind);
+			for (auto i = First; i < Records.size(); ++i)
+				Parents.push_back(IdOf_(Records[i]));
+			MembershipStore::MemberMap Members;
+			if (!Members_->GetMembers(Kinds, Parents, Members))
+				return;
+			for (auto i = First; i < Records.size(); ++i) {
+				for (auto &F : NormalizedFields_) {
+					auto &List = F.Field(Records[i]);
+					auto Hint =
+						Members.find(MembershipStore::MemberKey(F.Kind, IdOf_(Records[i])));
+					if (Hint == Members.end())
+						List.clear();
+					else
+						List = std::move(Hint->second);
+				}
+			}
+		}
+
+		bool ManipulateMembers(const NormalizedField &F, field_name_t FieldName,
+							   const std::string &ParentUUID,
+							   const std::vector<std::string> &ChildUUIDs, bool Add) {
+			std::string ParentId;
+			RecordType R;
+			if (std::string{FieldName} == "id") {
+				if (Count(OP("id", EQ, ParentUUID)) == 0)
+					return false;
+				ParentId = ParentUUID;
+			} else if (FetchRecord(FieldName, ParentUUID, R)) {
+				ParentId = IdOf_(R);
+			} else {
+				return false;
+			}
+			auto Rows = Add ? Members_->AddMembers(F.Kind, ParentId, ChildUUIDs)
+							: Members_->RemoveMembers(F.Kind, ParentId, ChildUUIDs);
+			if (Cache_)
+				Cache_->Delete("id", ParentId);
+			if (Rows > 0)
+				Changed(ParentId, 0, Operation::Update);
+			return Rows > 0;
+		}
+
 		std::string CreateFields_;
 		std::string SelectFields_;
 		std::string SelectList_;
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "orm_stats.h"
+
+namespace ORM {
+
+	//	One row written through the ORM. An empty Key stands for the whole table, i.e. when the
+	//	rows touched are not known (DeleteRecords, RunStatement...).
+	struct Change {
+		std::string Table;
+		std::string Key;
+		uint64_t Version = 0;
+		Operation Op = Operation::Other;
+	};
+
+	//	Carries the writes done through the ORM to whatever keeps copies of the rows. Writes go
+	//	to the sink (when one is set) and to the write listeners as they happen; Deliver hands
+	//	the writes made elsewhere to the listeners of each table. Local writes are not sent to
+	//	the Subscribe listeners: the code doing them already maintains its own caches.
+	class ChangeFeed {
+	  public:
+		typedef std::function<void(const Change &)> sink_t;
+		//	Called with the keys changed in Table. An empty list means the whole table.
+		typedef std::function<void(const std::string &Table, const std::vector<std::string> &Keys)>
+			listener_t;
+
+		static auto instance() {
+			static auto instance_ = new ChangeFeed;
+			return instance_;
+		}
+
+		inline void SetSink(sink_t Sink) {
+			std::lock_guard G(Mutex_);
+			Sink_ = std::move(Sink);
+		}
+
+		inline void Subscribe(const std::string &Table, listener_t Listener) {
+			std::lock_guard G(Mutex_);
+			Listeners_[Table].push_back(std::move(Listener));
+		}
+
+		//	Called in the writing thread for every write done here to Table, whatever the path
+		//	(single records, DeleteRecords, RunStatement...). Listeners must be quick.
+		inline void SubscribeWrites(const std::string &Table, listener_t Listener) {
+			std::lock_guard G(Mutex_);
+			Writers_[Table].push_back(std::move(Listener));
+		}
+
+		inline void Publish(const std::string &Table, const std::string &Key, uint64_t Version,
+							Operation Op) {
+			sink_t Sink;
+			std::vector<listener_t> Writers;
+			{
+				std::lock_guard G(Mutex_);
+				Sink = Sink_;
+				if (auto Hint = Writers_.find(Table); Hint != Writers_.end())
+					Writers = Hint->second;
+			}
+			if (Sink)
+				Sink(Change{Table, Key, Version, Op});
+			if (!Writers.empty()) {
+				std::vector<std::string> Keys;
+				if (!Key.empty())
+					Keys.push_back(Key);
+				for (const auto &W : Writers)
+					W(Table, Keys);
+			}
+		}
+
+		//	Changes are grouped per table so each listener is called once per batch.
+		inline void Deliver(const std::vector<Change> &Changes) {
+			std::map<std::string, std::set<std::string>> Keys;
+			std::set<std::string> WholeTables;
+			for (const auto &C : Changes) {
+				if (C.Key.empty())
+					WholeTables.insert(C.Table);
+				else
+					Keys[C.Table].insert(C.Key);
+			}
+			for (const auto &Table : WholeTables)
+				Notify(Table, {});
+			for (const auto &[Table, TableKeys] : Keys) {
+				if (WholeTables.count(Table) == 0)
+					Notify(Table, std::vector<std::string>(TableKeys.begin(), TableKeys.end()));
+			}
+		}
+
+		//	Every listener reloads its whole table: used when changes may have been missed.
+		inline void Resync() {
+			std::vector<std::string> Tables;
+			{
+				std::lock_guard G(Mutex_);
+				for (const auto &[Table, _] : Listeners_)
+					Tables.push_back(Table);
+			}
+			for (const auto &Table : Tables)
+				Notify(Table, {});
+		}
+
+	  private:
+		std::mutex Mutex_;
+		sink_t Sink_;
+		std::map<std::string, std::vector<listener_t>> Listeners_;
+		std::map<std::string, std::vector<listener_t>> Writers_;
+
+		inline void Notify(const std::string &Table, const std::vector<std::string> &Keys) {
+			std::vector<listener_t> Listeners;
+			{
+				std::lock_guard G(Mutex_);
+				auto Hint = Listeners_.find(Table);
+				if (Hint == Listeners_.end())
+					return;
+				Listeners = Hint->second;
+			}
+			for (const auto &L : Listeners)
+				L(Table, Keys);
+		}
+
+		ChangeFeed() = default;
+	};
+
+	inline auto ChangeFeed() { return ChangeFeed::instance(); }
+
+	//	Id and modification time of a record, for the records that have them.
+	template <typename R, typename = void> struct HasInfo : std::false_type {};
+	template <typename R>
+	struct HasInfo<R, std::void_t<decltype(std::declval<R>().info.id),
+								  decltype(std::declval<R>().info.modified)>> : std::true_type {};
+	template <typename R, typename = void> struct HasId : std::false_type {};
+	template <typename R>
+	struct HasId<R, std::void_t<decltype(std::string{std::declval<R>().id})>> : std::true_type {};
+	template <typename R, typename = void> struct HasArn : std::false_type {};
+	template <typename R>
+	struct HasArn<R, std::void_t<decltype(std::string{std::declval<R>().arn})>> : std::true_type {};
+
+	template <typename RecordType> std::string ChangeKey(const RecordType &R) {
+		if constexpr (HasInfo<RecordType>::value)
+			return R.info.id;
+		else if constexpr (HasId<RecordType>::value)
+			return R.id;
+		else if constexpr (HasArn<RecordType>::value)
+			return R.arn;
+		else
+			return "";
+	}
+
+	template <typename RecordType> uint64_t ChangeVersion(const RecordType &R) {
+		if constexpr (HasInfo<RecordType>::value)
+			return (uint64_t)R.info.modified;
+		else
+			return 0;
+	}
+
+} // namespace ORM
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Poco/JSON/Array.h"
+#include "Poco/JSON/Object.h"
+#include "Poco/Logger.h"
+
+#include "fmt/format.h"
+
+namespace ORM {
+
+	enum class Operation { Insert, Select, Update, Delete, Count, Other };
+
+	inline const char *OperationName(Operation Op) {
+		switch (Op) {
+		case Operation::Insert:
+			return "insert";
+		case Operation::Select:
+			return "select";
+		case Operation::Update:
+			return "update";
+		case Operation::Delete:
+			return "delete";
+		case Operation::Count:
+			return "count";
+		default:
+			return "other";
+		}
+	}
+
+	//	Per table and operation counters for every statement the ORM runs, plus a short history
+	//	of slow statements. Literals are stripped from the SQL kept for slow statements, so
+	//	queries that only differ by their values share the same shape.
+	//	Each table registers its counters once, when its ORM::DB is built, so recording a
+	//	statement only touches atomics: the lock is taken for slow statements alone.
+	class QueryStats {
+	  public:
+		static constexpr std::size_t SlowQueryHistory = 100;
+		//	Upper bounds, in microseconds, of the latency histogram buckets. The last bucket
+		//	holds everything slower.
+		static constexpr std::array<uint64_t, 6> BucketLimits{100,	  1000,	   10000,
+															  100000, 1000000, 10000000};
+		static constexpr std::size_t OperationCount = (std::size_t)Operation::Other + 1;
+
+		struct Counters {
+			std::atomic_uint64_t Calls{0};
+			std::atomic_uint64_t Errors{0};
+			std::atomic_uint64_t Rows{0};
+			std::atomic_uint64_t TotalMicros{0};
+			std::atomic_uint64_t MaxMicros{0};
+			std::array<std::atomic_uint64_t, BucketLimits.size() + 1> Histogram{};
+		};
+
+		//	The counters of one table, one slot per operation.
+		struct Table {
+			std::string Name;
+			std::array<Counters, OperationCount> Slots;
+		};
+
+		static auto instance() {
+			static auto instance_ = new QueryStats;
+			return instance_;
+		}
+
+		//	Returns the counters of a table, creating them on first use. They live as long as
+		//	the process, so the caller may keep the pointer.
+		inline Table *Register(const std::string &Name) {
+			std::lock_guard G(TablesMutex_);
+			auto Hint = Tables_.find(Name);
+			if (Hint != Tables_.end())
+				return Hint->second.get();
+			auto T = std::make_unique<Table>();
+			T->Name = Name;
+			return (Tables_[Name] = std::move(T)).get();
+		}
+
+		inline void SetSlowQueryThreshold(uint64_t Milliseconds) {
+			SlowThreshold_ = Milliseconds * 1000;
+		}
+
+		inline void SetLogger(Poco::Logger *L) { Logger_ = L; }
+
+		inline void Record(Table &T, Operation Op, const std::string &Statement, uint64_t Micros,
+						   uint64_t Rows, bool Failed) {
+			auto &S = T.Slots[(std::size_t)Op];
+			S.Calls.fetch_add(1, std::memory_order_relaxed);
+			if (Failed)
+				S.Errors.fetch_add(1, std::memory_order_relaxed);
+			S.Rows.fetch_add(Rows, std::memory_order_relaxed);
+			S.TotalMicros.fetch_add(Micros, std::memory_order_relaxed);
+			auto Max = S.MaxMicros.load(std::memory_order_relaxed);
+			while (Max < Micros &&
+				   !S.MaxMicros.compare_exchange_weak(Max, Micros, std::memory_order_relaxed))
+				;
+			std::size_t Bucket = 0;
+			while (Bucket < BucketLimits.size() && Micros >= BucketLimits[Bucket])
+				++Bucket;
+			S.Histogram[Bucket].fetch_add(1, std::memory_order_relaxed);
+
+			uint64_t Threshold = SlowThreshold_;
+			if (Threshold == 0 || Micros < Threshold)
+				return;
+			SlowQuery Q{T.Name, Op, Shape(Statement), Micros, Rows,
+						(uint64_t)std::time(nullptr)};
+			if (auto L = Logger_.load(); L != nullptr)
+				poco_warning(*L, fmt::format("Slow query: {} {} took {}ms, {} rows: {}", T.Name,
+											 OperationName(Op), Micros / 1000, Rows, Q.Shape));
+			std::lock_guard G(SlowMutex_);
+			SlowQueries_.emplace_back(std::move(Q));
+			if (SlowQueries_.size() > SlowQueryHistory)
+				SlowQueries_.pop_front();
+		}
+
+		inline void Reset() {
+			{
+				std::lock_guard G(TablesMutex_);
+				for (auto &[Name, T] : Tables_) {
+					for (auto &S : T->Slots) {
+						S.Calls = 0;
+						S.Errors = 0;
+						S.Rows = 0;
+						S.TotalMicros = 0;
+						S.MaxMicros = 0;
+						for (auto &B : S.Histogram)
+							B = 0;
+					}
+				}
+			}
+			std::lock_guard G(SlowMutex_);
+			SlowQueries_.clear();
+		}
+
+		inline void to_json(Poco::JSON::Object &Obj) {
+			Poco::JSON::Array Tables;
+			{
+				std::lock_guard G(TablesMutex_);
+				for (const auto &[Name, T] : Tables_) {
+					for (std::size_t Op = 0; Op < OperationCount; ++Op) {
+						const auto &S = T->Slots[Op];
+						uint64_t Calls = S.Calls;
+						if (Calls == 0)
+							continue;
+						Poco::JSON::Object O;
+						O.set("table", Name);
+						O.set("operation", OperationName((Operation)Op));
+						O.set("calls", Calls);
+						O.set("errors", S.Errors.load());
+						O.set("rows", S.Rows.load());
+						O.set("totalMicros", S.TotalMicros.load());
+						O.set("averageMicros", S.TotalMicros / Calls);
+						O.set("maxMicros", S.MaxMicros.load());
+						Poco::JSON::Array Histogram;
+						for (std::size_t i = 0; i < S.Histogram.size(); ++i) {
+							Poco::JSON::Object B;
+							if (i < BucketLimits.size())
+								B.set("belowMicros", BucketLimits[i]);
+							B.set("count", S.Histogram[i].load());
+							Histogram.add(B);
+						}
+						O.set("histogram", Histogram);
+						Tables.add(O);
+					}
+				}
+			}
+			Obj.set("statements", Tables);
+
+			Poco::JSON::Array Slow;
+			{
+				std::lock_guard G(SlowMutex_);
+				for (const auto &Q : SlowQueries_) {
+					Poco::JSON::Object O;
+					O.set("table", Q.Table);
+					O.set("operation", OperationName(Q.Op));
+					O.set("shape", Q.Shape);
+					O.set("micros", Q.Micros);
+					O.set("rows", Q.Rows);
+					O.set("when", Q.When);
+					Slow.add(O);
+				}
+			}
+			Obj.set("slowQueries", Slow);
+			Obj.set("slowQueryThresholdMs", SlowThreshold_ / 1000);
+		}
+
+		//	Replaces quoted strings and numbers by '?', and squashes "in (?,?,...)" lists.
+		static std::string Shape(const std::string &St) {
+			std::string R;
+			R.reserve(St.size());
+			for (std::size_t i = 0; i < St.size(); ++i) {
+				auto C = St[i];
+				if (C == '\'') {
+					for (++i; i < St.size(); ++i) {
+						if (St[i] == '\'') {
+							if (i + 1 < St.size() && St[i + 1] == '\'')
+								++i;
+							else
+								break;
+						}
+					}
+					R += '?';
+				} else if (std::isdigit((unsigned char)C) &&
+						   (R.empty() || !(std::isalnum((unsigned char)R.back()) ||
+										   R.back() == '_' || R.back() == '$'))) {
+					while (i + 1 < St.size() && (std::isdigit((unsigned char)St[i + 1]) ||
+												 St[i + 1] == '.'))
+						++i;
+					R += '?';
+				} else {
+					R += C;
+				}
+			}
+			for (auto P = R.find("?,?"); P != std::string::npos; P = R.find("?,?", P))
+				R.erase(P + 1, 2);
+			return R;
+		}
+
+	  private:
+		struct SlowQuery {
+			std::string Table;
+			Operation Op;
+			std::string Shape;
+			uint64_t Micros;
+			uint64_t Rows;
+			uint64_t When;
+		};
+
+		std::mutex TablesMutex_;
+		std::map<std::string, std::unique_ptr<Table>> Tables_;
+		std::mutex SlowMutex_;
+		std::deque<SlowQuery> SlowQueries_;
+		std::atomic_uint64_t SlowThreshold_{250000};
+		std::atomic<Poco::Logger *> Logger_{nullptr};
+
+		QueryStats() = default;
+	};
+
+	inline auto QueryStats() { return QueryStats::instance(); }
+
+} // namespace ORM
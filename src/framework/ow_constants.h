@@ -432,6 +432,7 @@ namespace OpenWifi::RESTAPI::Errors {
     static const struct msg InvalidRadiusServer { 1191, "Invalid Radius Server." };
 
 	static const struct msg InvalidRRMAction { 1192, "Invalid RRM Action." };
+	static const struct msg InvalidSchedule { 1193, "Invalid schedule." };
 
     static const struct msg SimulationDoesNotExist {
         7000, "Simulation Instance ID does not exist."
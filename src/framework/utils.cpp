@@ -406,6 +406,8 @@ namespace OpenWifi::Utils {
 		auto Now = Clock.now().time_since_epoch().count();
 		auto S = (GetDefaultMacAsInt64() + std::rand() + Now);
 		OpenWifi::AppServiceRegistry().Set("systemid", S);
+		//	The id must survive a crash right after startup.
+		OpenWifi::AppServiceRegistry().Save();
 		return S;
 	}
 
@@ -140,6 +140,18 @@ namespace OpenWifi::SDK::GW {
 			}
 		}
 
+		bool GetStatus(const std::string &SerialNumber, bool &Connected, uint64_t &Started) {
+			OpenWifi::OpenAPIRequestGet API(OpenWifi::uSERVICE_GATEWAY,
+											"/api/v1/device/" + SerialNumber + "/status", {},
+											10000);
+			auto CallResponse = Poco::makeShared<Poco::JSON::Object>();
+			if (API.Do(CallResponse) != Poco::Net::HTTPResponse::HTTP_OK)
+				return false;
+			Connected = CallResponse->optValue("connected", false);
+			Started = CallResponse->optValue("started", (uint64_t)0);
+			return true;
+		}
+
 		bool SetVenue(RESTAPIHandler *client, const std::string &SerialNumber,
 					  const std::string &uuid) {
 			Poco::JSON::Object Body;
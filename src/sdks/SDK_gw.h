@@ -24,6 +24,8 @@ namespace OpenWifi::SDK::GW {
 					   Poco::JSON::Object::Ptr &Configuration, Poco::JSON::Object::Ptr &Response);
 		bool Upgrade(RESTAPIHandler *client, const std::string &Mac, uint64_t When,
 					 const std::string &ImageName, std::string &status);
+		//	Whether the device is connected, and since when.
+		bool GetStatus(const std::string &SerialNumber, bool &Connected, uint64_t &Started);
 
 		bool SetVenue(RESTAPIHandler *client, const std::string &SerialNumber,
 					  const std::string &uuid);
@@ -123,7 +123,8 @@ namespace OpenWifi {
 			}
 
 			if (CreateRecord(NewDevice)) {
-				SerialNumberCache()->AddSerialNumber(SerialNumber, DeviceType);
+				SerialNumberCache()->AddSerialNumber(SerialNumber, DeviceType, NewDevice.venue,
+													 NewDevice.entity);
 				std::string FullUUID;
 				if (!NewDevice.entity.empty()) {
 					StorageService()->EntityDB().AddDevice("id", NewDevice.entity,
@@ -188,6 +189,9 @@ namespace OpenWifi {
                 ExistingDevice.connected = Utils::Now();
 				StorageService()->InventoryDB().UpdateRecord("id", ExistingDevice.info.id,
 															 ExistingDevice);
+				//	The device type may have changed: keep the search filter in step.
+				SerialNumberCache()->AddSerialNumber(SerialNumber, ExistingDevice.deviceType,
+													 ExistingDevice.venue, ExistingDevice.entity);
 			}
 
 			// Push entity and venue down to GW but only on connect (not ping)
@@ -242,11 +246,14 @@ namespace OpenWifi {
 	}
 
 	void InventoryDB::InitializeSerialCache() {
-		auto F = [](const ProvObjects::InventoryTag &T) -> bool {
-			SerialNumberCache()->AddSerialNumber(T.serialNumber, T.deviceType);
-			return true;
-		};
-		Iterate(F);
+		std::vector<Poco::Tuple<std::string, std::string, std::string, std::string>> Rows;
+		GetColumns({"serialNumber", "deviceType", "venue", "entity"}, Rows);
+		std::vector<SerialNumberCache::SerialEntry> Entries;
+		Entries.reserve(Rows.size());
+		for (const auto &Row : Rows)
+			Entries.emplace_back(SerialNumberCache::SerialEntry{Row.get<0>(), Row.get<1>(),
+																Row.get<2>(), Row.get<3>()});
+		SerialNumberCache()->AddSerialNumbers(Entries);
 	}
 
 	bool InventoryDB::GetRRMDeviceList(Types::UUIDvec_t &DeviceList) {
@@ -267,10 +274,10 @@ namespace OpenWifi {
 
     bool InventoryDB::GetDevicesForVenue(const std::string &venue_uuid, std::vector<std::string> &devices) {
         try {
-            std::vector<ProvObjects::InventoryTag> device_list;
-            if(GetRecords(0, 1000, device_list, fmt::format(" venue='{}' ", venue_uuid))) {
+            std::vector<Poco::Tuple<std::string>> device_list;
+            if(GetColumns({"serialNumber"}, device_list, OP("venue", ORM::EQ, venue_uuid), "", 0, 1000) && !device_list.empty()) {
                 for(auto &i:device_list) {
-                    devices.push_back(i.serialNumber);
+                    devices.push_back(i.get<0>());
                 }
                 return true;
             }
@@ -289,10 +296,32 @@ namespace OpenWifi {
 
     bool InventoryDB::GetDevicesUUIDForVenue(const std::string &venue_uuid, std::vector<std::string> &devices) {
         try {
-            std::vector<ProvObjects::InventoryTag> device_list;
-            if(GetRecords(0, 1000, device_list, fmt::format(" venue='{}' ", venue_uuid))) {
+            std::vector<Poco::Tuple<std::string>> device_list;
+            if(GetColumns({"id"}, device_list, OP("venue", ORM::EQ, venue_uuid), "", 0, 1000) && !device_list.empty()) {
                 for(auto &i:device_list) {
-                    devices.push_back(i.info.id);
+                    devices.push_back(i.get<0>());
+                }
+                return true;
+            }
+        } catch(const Poco::Exception &E) {
+            Logger().log(E);
+            return false;
+        } catch(const std::exception &E) {
+            Logger().error(fmt::format("std::exception: {}",E.what()));
+            return false;
+        } catch(...) {
+            Logger().error("Unknown exception");
+            return false;
+        }
+        return false;
+    }
+
+    bool InventoryDB::GetDeviceIdsAndSerialsForVenue(const std::string &venue_uuid, std::vector<std::pair<std::string,std::string>> &devices) {
+        try {
+            std::vector<Poco::Tuple<std::string,std::string>> device_list;
+            if(GetColumns({"id","serialNumber"}, device_list, OP("venue", ORM::EQ, venue_uuid), "", 0, 1000) && !device_list.empty()) {
+                for(auto &i:device_list) {
+                    devices.emplace_back(i.get<0>(), i.get<1>());
                 }
                 return true;
             }
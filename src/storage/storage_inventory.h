@@ -41,6 +41,7 @@ namespace OpenWifi {
 
         bool GetDevicesForVenue(const std::string &uuid, std::vector<std::string> &devices);
         bool GetDevicesUUIDForVenue(const std::string &uuid, std::vector<std::string> &devices);
+        bool GetDeviceIdsAndSerialsForVenue(const std::string &uuid, std::vector<std::pair<std::string,std::string>> &devices);
         bool GetDevicesForVenue(const std::string &uuid, std::vector<ProvObjects::InventoryTag> &devices);
 
 	  private:
@@ -0,0 +1,169 @@
+#include "storage_membership.h"
+#include "framework/utils.h"
+
+namespace OpenWifi {
+
+	static ORM::FieldVec MembershipDB_Fields{ORM::Field{"id", 200, true},
+											 ORM::Field{"kind", 32},
+											 ORM::Field{"parent", 64},
+											 ORM::Field{"child", 128},
+											 ORM::Field{"created", ORM::FieldType::FT_BIGINT}};
+
+	static ORM::IndexVec MembershipDB_Indexes{
+		{std::string("membership_parent_index"),
+		 ORM::IndexEntryVec{{std::string("kind"), ORM::Indextype::ASC},
+							{std::string("parent"), ORM::Indextype::ASC}}},
+		{std::string("membership_child_index"),
+		 ORM::IndexEntryVec{{std::string("child"), ORM::Indextype::ASC}}}};
+
+	//	Parents per select when loading member lists.
+	static constexpr std::size_t MembershipQueryBatch = 200;
+
+	MembershipDB::MembershipDB(OpenWifi::DBType T, Poco::Data::SessionPool &P, Poco::Logger &L)
+		: DB(T, "memberships", MembershipDB_Fields, MembershipDB_Indexes, P, L, "mbr") {}
+
+	std::size_t MembershipDB::AddMembers(const std::string &Kind, const std::string &Parent,
+										 const std::vector<std::string> &Children) {
+		if (Children.empty())
+			return 0;
+		try {
+			Poco::Data::Session Session = Pool_.get();
+			Session.begin();
+			auto Added = AddMembers(Session, Kind, Parent, Children);
+			Session.commit();
+			return Added;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return 0;
+	}
+
+	std::size_t MembershipDB::AddMembers(Poco::Data::Session &Session, const std::string &Kind,
+										 const std::string &Parent,
+										 const std::vector<std::string> &Children) {
+		if (Children.empty())
+			return 0;
+		auto Now = Utils::Now();
+		std::vector<MembershipRecordType> Rows;
+		Rows.reserve(Children.size());
+		for (const auto &Child : Children)
+			Rows.emplace_back(RowId(Kind, Parent, Child), Kind, Parent, Child, Now);
+
+		//	The row id is the primary key, so adding an existing member is a no-op
+		//	instead of a duplicate, even with concurrent writers.
+		std::string St;
+		switch (Type_) {
+		case OpenWifi::DBType::sqlite:
+			St = "insert or ignore into " + TableName_ + " ( " + SelectFields() + " ) values " +
+				 SelectList();
+			break;
+		case OpenWifi::DBType::mysql:
+			St = "insert ignore into " + TableName_ + " ( " + SelectFields() + " ) values " +
+				 SelectList();
+			break;
+		case OpenWifi::DBType::pgsql:
+			St = "insert into " + TableName_ + " ( " + SelectFields() + " ) values " +
+				 SelectList() + " on conflict do nothing";
+			break;
+		}
+
+		Poco::Data::Statement Insert(Session);
+		Insert << ConvertParams(St), Poco::Data::Keywords::use(Rows);
+		return Execute(Insert, ORM::Operation::Insert, St);
+	}
+
+	std::size_t MembershipDB::RemoveMembers(const std::string &Kind, const std::string &Parent,
+											const std::vector<std::string> &Children) {
+		if (Children.empty())
+			return 0;
+		try {
+			std::vector<std::string> Ids;
+			Ids.reserve(Children.size());
+			for (const auto &Child : Children)
+				Ids.emplace_back(RowId(Kind, Parent, Child));
+
+			Poco::Data::Session Session = Pool_.get();
+			Session.begin();
+			Poco::Data::Statement Delete(Session);
+			std::string St = "delete from " + TableName_ + " where id=?";
+			Delete << ConvertParams(St), Poco::Data::Keywords::use(Ids);
+			auto Removed = Execute(Delete, ORM::Operation::Delete, St);
+			Session.commit();
+			return Removed;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return 0;
+	}
+
+	bool MembershipDB::RemoveParent(const std::string &Kind, const std::string &Parent) {
+		return DeleteRecords(
+			OP(OP("kind", ORM::EQ, Kind), ORM::AND, OP("parent", ORM::EQ, Parent)));
+	}
+
+	void MembershipDB::RemoveParents(Poco::Data::Session &Session, const std::string &Kind,
+									 const std::vector<std::string> &Parents) {
+		for (std::size_t From = 0; From < Parents.size(); From += MembershipQueryBatch) {
+			auto To = std::min(Parents.size(), From + MembershipQueryBatch);
+			Poco::Data::Statement Delete(Session);
+			std::string St = "delete from " + TableName_ + " where kind='" + ORM::Escape(Kind) +
+							 "' and parent in (" +
+							 ORM::InList(Parents.begin() + From, Parents.begin() + To) + ")";
+			Delete << St;
+			Execute(Delete, ORM::Operation::Delete, St);
+		}
+	}
+
+	bool MembershipDB::GetMembers(const std::vector<std::string> &Kinds,
+								  const std::vector<std::string> &Parents, MemberMap &Members) {
+		if (Kinds.empty() || Parents.empty())
+			return true;
+		try {
+			std::string KindList;
+			for (const auto &Kind : Kinds)
+				KindList += (KindList.empty() ? "'" : ",'") + ORM::Escape(Kind) + "'";
+
+			Poco::Data::Session Session = Pool_.get();
+			for (std::size_t From = 0; From < Parents.size(); From += MembershipQueryBatch) {
+				std::string ParentList;
+				auto To = std::min(Parents.size(), From + MembershipQueryBatch);
+				for (auto i = From; i < To; ++i)
+					ParentList += (ParentList.empty() ? "'" : ",'") + ORM::Escape(Parents[i]) + "'";
+
+				std::vector<Poco::Tuple<std::string, std::string, std::string>> Rows;
+				Poco::Data::Statement Select(Session);
+				std::string St = "select kind, parent, child from " + TableName_ +
+								 " where kind in (" + KindList + ") and parent in (" + ParentList +
+								 ") order by child";
+				Select << St, Poco::Data::Keywords::into(Rows);
+				Execute(Select, ORM::Operation::Select, St);
+				for (const auto &Row : Rows)
+					Members[MemberKey(Row.get<0>(), Row.get<1>())].push_back(Row.get<2>());
+			}
+			return true;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return false;
+	}
+} // namespace OpenWifi
+
+template <>
+void ORM::DB<OpenWifi::MembershipRecordType, OpenWifi::Membership>::Convert(
+	const OpenWifi::MembershipRecordType &In, OpenWifi::Membership &Out) {
+	Out.id = In.get<0>();
+	Out.kind = In.get<1>();
+	Out.parent = In.get<2>();
+	Out.child = In.get<3>();
+	Out.created = In.get<4>();
+}
+
+template <>
+void ORM::DB<OpenWifi::MembershipRecordType, OpenWifi::Membership>::Convert(
+	const OpenWifi::Membership &In, OpenWifi::MembershipRecordType &Out) {
+	Out.set<0>(In.id);
+	Out.set<1>(In.kind);
+	Out.set<2>(In.parent);
+	Out.set<3>(In.child);
+	Out.set<4>(In.created);
+}
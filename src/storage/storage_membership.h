@@ -0,0 +1,42 @@
+#pragma once
+
+#include "framework/orm.h"
+
+namespace OpenWifi {
+	struct Membership {
+		std::string id; // kind:parent:child
+		std::string kind;
+		std::string parent;
+		std::string child;
+		uint64_t created = 0;
+	};
+
+	typedef Poco::Tuple<std::string, std::string, std::string, std::string, uint64_t>
+		MembershipRecordType;
+
+	class MembershipDB : public ORM::DB<MembershipRecordType, Membership>,
+						 public ORM::MembershipStore {
+	  public:
+		MembershipDB(OpenWifi::DBType T, Poco::Data::SessionPool &P, Poco::Logger &L);
+		virtual ~MembershipDB(){};
+
+		std::size_t AddMembers(const std::string &Kind, const std::string &Parent,
+							   const std::vector<std::string> &Children) override;
+		std::size_t AddMembers(Poco::Data::Session &Session, const std::string &Kind,
+							   const std::string &Parent,
+							   const std::vector<std::string> &Children) override;
+		void RemoveParents(Poco::Data::Session &Session, const std::string &Kind,
+						   const std::vector<std::string> &Parents) override;
+		std::size_t RemoveMembers(const std::string &Kind, const std::string &Parent,
+								  const std::vector<std::string> &Children) override;
+		bool RemoveParent(const std::string &Kind, const std::string &Parent) override;
+		bool GetMembers(const std::vector<std::string> &Kinds,
+						const std::vector<std::string> &Parents, MemberMap &Members) override;
+
+	  private:
+		static inline std::string RowId(const std::string &Kind, const std::string &Parent,
+										const std::string &Child) {
+			return Kind + ":" + Parent + ":" + Child;
+		}
+	};
+} // namespace OpenWifi
@@ -0,0 +1,107 @@
+#include "storage_scheduled_jobs.h"
+
+#include "framework/OpenWifiTypes.h"
+#include "framework/RESTAPI_utils.h"
+
+namespace OpenWifi {
+
+	static ORM::FieldVec ScheduledJobsDB_Fields{
+		ORM::Field{"id", 64, true},
+		ORM::Field{"venue", ORM::FieldType::FT_TEXT},
+		ORM::Field{"name", ORM::FieldType::FT_TEXT},
+		ORM::Field{"parameters", ORM::FieldType::FT_TEXT},
+		ORM::Field{"schedule", ORM::FieldType::FT_TEXT},
+		ORM::Field{"nextRun", ORM::FieldType::FT_BIGINT},
+		//	"window" is a reserved word in PostgreSQL and MySQL 8. The JSON field keeps that name.
+		ORM::Field{"spreadWindow", ORM::FieldType::FT_BIGINT},
+		ORM::Field{"lastRun", ORM::FieldType::FT_BIGINT},
+		ORM::Field{"lastJobId", ORM::FieldType::FT_TEXT},
+		ORM::Field{"userId", ORM::FieldType::FT_TEXT},
+		ORM::Field{"email", ORM::FieldType::FT_TEXT},
+		ORM::Field{"created", ORM::FieldType::FT_BIGINT}};
+
+	static ORM::IndexVec ScheduledJobsDB_Indexes{
+		{std::string("scheduled_jobs_venue_index"),
+		 ORM::IndexEntryVec{{std::string("venue"), ORM::Indextype::ASC}}}};
+
+	ScheduledJobsDB::ScheduledJobsDB(OpenWifi::DBType T, Poco::Data::SessionPool &P,
+									 Poco::Logger &L)
+		: DB(T, "scheduled_jobs", ScheduledJobsDB_Fields, ScheduledJobsDB_Indexes, P, L, "sch") {}
+
+	bool ScheduledJobsDB::Upgrade([[maybe_unused]] uint32_t from, uint32_t &to) {
+		to = Version();
+		//	Tables created on SQLite before the column was renamed.
+		std::vector<std::string> Script{"alter table " + TableName_ +
+										" rename column \"window\" to spreadWindow"};
+
+		for (const auto &i : Script) {
+			try {
+				auto Session = Pool_.get();
+				Session << i, Poco::Data::Keywords::now;
+			} catch (...) {
+			}
+		}
+		return true;
+	}
+
+	bool ScheduledJobsDB::ClaimRun(const std::string &Id, uint64_t Due, uint64_t Next) {
+		try {
+			Poco::Data::Session Session = Pool_.get();
+			Poco::Data::Statement Claim(Session);
+			auto tId{Id};
+			std::string St;
+			if (Next == 0) {
+				St = "delete from " + TableName_ + " where id=? and nextRun=?";
+				Claim << ConvertParams(St), Poco::Data::Keywords::use(tId),
+					Poco::Data::Keywords::use(Due);
+			} else {
+				St = "update " + TableName_ + " set nextRun=? where id=? and nextRun=?";
+				Claim << ConvertParams(St), Poco::Data::Keywords::use(Next),
+					Poco::Data::Keywords::use(tId), Poco::Data::Keywords::use(Due);
+			}
+			auto Op = Next == 0 ? ORM::Operation::Delete : ORM::Operation::Update;
+			if (Execute(Claim, Op, St) != 1)
+				return false;
+			Changed(Id, 0, Op);
+			return true;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return false;
+	}
+
+} // namespace OpenWifi
+
+template <>
+void ORM::DB<OpenWifi::ScheduledJobsDBRecordType, OpenWifi::ProvObjects::ScheduledVenueJob>::Convert(
+	const OpenWifi::ScheduledJobsDBRecordType &In, OpenWifi::ProvObjects::ScheduledVenueJob &Out) {
+	Out.id = In.get<0>();
+	Out.venue = In.get<1>();
+	Out.name = In.get<2>();
+	Out.parameters = OpenWifi::RESTAPI_utils::to_object_array(In.get<3>());
+	Out.schedule = In.get<4>();
+	Out.nextRun = In.get<5>();
+	Out.window = In.get<6>();
+	Out.lastRun = In.get<7>();
+	Out.lastJobId = In.get<8>();
+	Out.userId = In.get<9>();
+	Out.email = In.get<10>();
+	Out.created = In.get<11>();
+}
+
+template <>
+void ORM::DB<OpenWifi::ScheduledJobsDBRecordType, OpenWifi::ProvObjects::ScheduledVenueJob>::Convert(
+	const OpenWifi::ProvObjects::ScheduledVenueJob &In, OpenWifi::ScheduledJobsDBRecordType &Out) {
+	Out.set<0>(In.id);
+	Out.set<1>(In.venue);
+	Out.set<2>(In.name);
+	Out.set<3>(OpenWifi::RESTAPI_utils::to_string(In.parameters));
+	Out.set<4>(In.schedule);
+	Out.set<5>(In.nextRun);
+	Out.set<6>(In.window);
+	Out.set<7>(In.lastRun);
+	Out.set<8>(In.lastJobId);
+	Out.set<9>(In.userId);
+	Out.set<10>(In.email);
+	Out.set<11>(In.created);
+}
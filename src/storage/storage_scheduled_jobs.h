@@ -0,0 +1,25 @@
+#pragma once
+
+#include "RESTObjects/RESTAPI_ProvObjects.h"
+#include "framework/orm.h"
+
+namespace OpenWifi {
+
+	typedef Poco::Tuple<std::string, std::string, std::string, std::string, std::string,
+						uint64_t, uint64_t, uint64_t, std::string, std::string, std::string,
+						uint64_t>
+		ScheduledJobsDBRecordType;
+
+	class ScheduledJobsDB : public ORM::DB<ScheduledJobsDBRecordType, ProvObjects::ScheduledVenueJob> {
+	  public:
+		ScheduledJobsDB(OpenWifi::DBType T, Poco::Data::SessionPool &P, Poco::Logger &L);
+		virtual ~ScheduledJobsDB(){};
+		bool Upgrade(uint32_t from, uint32_t &to) override;
+
+		//	Moves the run due at Due to Next, or removes the schedule when Next is 0. Only one
+		//	caller succeeds for a given run, whatever the number of replicas trying.
+		bool ClaimRun(const std::string &Id, uint64_t Due, uint64_t Next);
+
+	  private:
+	};
+} // namespace OpenWifi
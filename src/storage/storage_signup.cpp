@@ -120,6 +120,34 @@ namespace OpenWifi {
 		} catch (...) {
 		}
 	}
+	bool SignupDB::ChangeStatusCode(const std::string &Id, uint64_t From, uint64_t To) {
+		try {
+			Poco::Data::Session Session = Pool_.get();
+			Poco::Data::Statement Update(Session);
+			auto tId{Id};
+			std::string St =
+				"update " + TableName_ + " set statusCode=? where id=? and statusCode=?";
+			Update << ConvertParams(St), Poco::Data::Keywords::use(To),
+				Poco::Data::Keywords::use(tId), Poco::Data::Keywords::use(From);
+			if (Execute(Update, ORM::Operation::Update, St) != 1)
+				return false;
+			Changed(Id, 0, ORM::Operation::Update);
+			return true;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return false;
+	}
+
+	bool SignupDB::ClaimSignup(const std::string &Id) {
+		return ChangeStatusCode(Id, ProvObjects::SignupStatusCodes::SignupWaitingForDevice,
+								ProvObjects::SignupStatusCodes::SignupSuccess);
+	}
+
+	void SignupDB::ReleaseSignup(const std::string &Id) {
+		ChangeStatusCode(Id, ProvObjects::SignupStatusCodes::SignupSuccess,
+						 ProvObjects::SignupStatusCodes::SignupWaitingForDevice);
+	}
 } // namespace OpenWifi
 
 template <>
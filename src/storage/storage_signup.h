@@ -20,6 +20,12 @@ namespace OpenWifi {
 		bool GetIncompleteSignups(SignupDB::RecordVec &Signups);
 		void RemoveIncompleteSignups();
 
+		//	Moves a signup from waiting for its device to completed. Only one replica succeeds,
+		//	and completes the signup. Release puts it back when completing failed.
+		bool ClaimSignup(const std::string &Id);
+		void ReleaseSignup(const std::string &Id);
+
 	  private:
+		bool ChangeStatusCode(const std::string &Id, uint64_t From, uint64_t To);
 	};
 } // namespace OpenWifi
\ No newline at end of file
@@ -23,6 +23,60 @@ namespace OpenWifi {
 									   Poco::Logger &L)
 		: DB(T, "TagsDictionary", TagsDictionary_Fields, TagsDictionaryDB_Indexes, P, L, "tgd") {}
 
+	static constexpr int TagIdAttempts = 5;
+
+	bool TagsDictionaryDB::FindTag(const std::string &Entity, const std::string &Name,
+								   uint32_t &Id) {
+		std::vector<Poco::Tuple<uint32_t>> Rows;
+		if (!GetColumns({"id"}, Rows,
+						OP(OP("entity", ORM::EQ, Entity), ORM::AND, OP("name", ORM::EQ, Name)),
+						" ORDER BY id ", 0, 1) ||
+			Rows.empty())
+			return false;
+		Id = Rows.front().get<0>();
+		return true;
+	}
+
+	bool TagsDictionaryDB::LastId(uint32_t &Id) {
+		try {
+			Poco::Data::Session Session = Pool_.get();
+			Poco::Data::Statement Select(Session);
+			std::string St = "select coalesce(max(id), 0) from " + TableName_;
+			uint64_t Last = 0;
+			Select << St, Poco::Data::Keywords::into(Last);
+			Execute(Select, ORM::Operation::Select, St);
+			Id = (uint32_t)Last;
+			return true;
+		} catch (const Poco::Exception &E) {
+			Logger().log(E);
+		}
+		return false;
+	}
+
+	//	Ids come from the table, so every replica agrees on them. When two replicas add tags at
+	//	once and pick the same id, the second insert fails on the primary key and tries again.
+	//	When they add the same name at once, both inserts succeed: the smallest id is kept and
+	//	the other row removed.
+	bool TagsDictionaryDB::AddTag(const std::string &Entity, const std::string &Name,
+								  uint32_t &Id) {
+		for (int Attempt = 0; Attempt < TagIdAttempts; ++Attempt) {
+			if (FindTag(Entity, Name, Id))
+				return true;
+			uint32_t Last;
+			if (!LastId(Last))
+				return false;
+			TagsDictionary D{Entity, Last + 1, Name};
+			if (!CreateRecord(D))
+				continue;
+			if (!FindTag(Entity, Name, Id))
+				Id = D.id;
+			else if (Id != D.id)
+				DeleteRecord("id", D.id);
+			return true;
+		}
+		return false;
+	}
+
 	static ORM::FieldVec TagsObject_Fields{
 		// object info
 		ORM::Field{"entity", ORM::FieldType::FT_TEXT, 64},
@@ -29,7 +29,12 @@ namespace OpenWifi {
 		TagsDictionaryDB(OpenWifi::DBType T, Poco::Data::SessionPool &P, Poco::Logger &L);
 		virtual ~TagsDictionaryDB(){};
 
+		//	The id of a tag name in an entity, adding the name to the dictionary when needed.
+		bool AddTag(const std::string &Entity, const std::string &Name, uint32_t &Id);
+
 	  private:
+		bool FindTag(const std::string &Entity, const std::string &Name, uint32_t &Id);
+		bool LastId(uint32_t &Id);
 	};
 
 	class TagsObjectDB : public ORM::DB<TagsObjectRecordType, TagsObject> {
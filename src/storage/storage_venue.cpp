@@ -130,7 +130,7 @@ namespace OpenWifi {
 
             Command << Statement,
                     Poco::Data::Keywords::into(RecordCount);
-            Command.execute();
+            Execute(Command, ORM::Operation::Count, Statement);
         } catch (...) {
 
         }